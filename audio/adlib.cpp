@@ -22,6 +22,7 @@
 #include "common/debug.h"
 #include "common/error.h"
 #include "common/scummsys.h"
+#include "common/str.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/types.h"
@@ -1560,6 +1561,15 @@ uint32 MidiDriver_ADLIB::property(int prop, uint32 param) {
 #endif
 		return 1;
 
+	case PROP_RENDER_CACHE_SONG:
+		if (_opl) {
+			if (param)
+				_opl->setRenderCacheSong(Common::String::format("adlib-%d-%08x", _scummSmallHeader, param));
+			else
+				_opl->setRenderCacheSong(Common::String());
+		}
+		return 1;
+
 	default:
 		break;
 	}
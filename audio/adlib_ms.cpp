@@ -528,6 +528,14 @@ uint32 MidiDriver_ADLIB_Multisource::property(int prop, uint32 param) {
 
 		_rhythmModeIgnoreNoteOffs = (param != 0);
 		break;
+	case PROP_RENDER_CACHE_SONG:
+		if (_opl) {
+			if (param)
+				_opl->setRenderCacheSong(Common::String::format("adlib_ms-%d-%d-%d-%08x", _accuracyMode, _allocationMode, _rhythmModeIgnoreNoteOffs, param));
+			else
+				_opl->setRenderCacheSong(Common::String());
+		}
+		break;
 	default:
 		return MidiDriver_Multisource::property(prop, param);
 	}
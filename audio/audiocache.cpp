@@ -0,0 +1,239 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/audiocache.h"
+#include "audio/audiostream.h"
+
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Audio {
+
+struct AudioCache::Buffer {
+	Buffer(int16 *samples_, uint32 numSamples_, int rate_, bool stereo_) :
+		samples(samples_), numSamples(numSamples_), rate(rate_), stereo(stereo_), refs(1) {}
+
+	~Buffer() {
+		free(samples);
+	}
+
+	uint32 getSize() const { return numSamples * sizeof(int16); }
+
+	void incRef() {
+		Common::StackLock lock(mutex);
+		refs++;
+	}
+
+	void decRef() {
+		bool unused;
+		{
+			Common::StackLock lock(mutex);
+			unused = (--refs == 0);
+		}
+
+		if (unused)
+			delete this;
+	}
+
+	int16 *samples;
+	uint32 numSamples;
+	int rate;
+	bool stereo;
+
+private:
+	// Streams are usually destroyed by the mixer thread
+	Common::Mutex mutex;
+	int refs;
+};
+
+/**
+ * A stream playing a decoded sound from an AudioCache.
+ */
+class CachedAudioStream : public SeekableAudioStream {
+public:
+	CachedAudioStream(AudioCache::Buffer *buffer) : _buffer(buffer), _pos(0) {
+		_buffer->incRef();
+	}
+
+	~CachedAudioStream() {
+		_buffer->decRef();
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) override {
+		const int samples = MIN<uint32>(numSamples, _buffer->numSamples - _pos);
+		memcpy(buffer, _buffer->samples + _pos, samples * sizeof(int16));
+		_pos += samples;
+		return samples;
+	}
+
+	bool isStereo() const override { return _buffer->stereo; }
+	int getRate() const override { return _buffer->rate; }
+	bool endOfData() const override { return _pos >= _buffer->numSamples; }
+
+	bool seek(const Timestamp &where) override {
+		const uint32 pos = convertTimeToStreamPos(where, getRate(), isStereo()).totalNumberOfFrames();
+		if (pos > _buffer->numSamples)
+			return false;
+
+		_pos = pos;
+		return true;
+	}
+
+	Timestamp getLength() const override {
+		return Timestamp(0, _buffer->numSamples / (isStereo() ? 2 : 1), getRate());
+	}
+
+private:
+	AudioCache::Buffer *_buffer;
+	uint32 _pos;
+};
+
+AudioCache::AudioCache(uint32 maxSize) : _size(0), _maxSize(maxSize), _accessCounter(0) {
+}
+
+AudioCache::~AudioCache() {
+	clear();
+}
+
+SeekableAudioStream *AudioCache::getStream(const Common::String &key) {
+	Common::StackLock lock(_mutex);
+
+	EntryMap::iterator it = _entries.find(key);
+	if (it == _entries.end())
+		return nullptr;
+
+	it->_value.lastAccess = ++_accessCounter;
+	return new CachedAudioStream(it->_value.buffer);
+}
+
+SeekableAudioStream *AudioCache::addStream(const Common::String &key, AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse) {
+	const int rate = stream->getRate();
+	const bool stereo = stream->isStereo();
+
+	// Decode everything, growing the buffer as needed
+	int16 *samples = nullptr;
+	uint32 numSamples = 0, capacity = 0;
+
+	for (;;) {
+		if (numSamples == capacity) {
+			capacity = MAX<uint32>(capacity * 2, 8192);
+			samples = (int16 *)realloc(samples, capacity * sizeof(int16));
+			if (!samples)
+				error("AudioCache::addStream(): Out of memory decoding '%s'", key.c_str());
+		}
+
+		const int read = stream->readBuffer(samples + numSamples, capacity - numSamples);
+		if (read <= 0)
+			break;
+
+		numSamples += read;
+		if (stream->endOfData())
+			break;
+	}
+
+	if (disposeAfterUse == DisposeAfterUse::YES)
+		delete stream;
+
+	if (numSamples == 0) {
+		free(samples);
+		return nullptr;
+	}
+
+	// Give back the unused part of the buffer
+	int16 *shrunk = (int16 *)realloc(samples, numSamples * sizeof(int16));
+	if (shrunk)
+		samples = shrunk;
+
+	Buffer *buffer = new Buffer(samples, numSamples, rate, stereo);
+	SeekableAudioStream *result = new CachedAudioStream(buffer);
+
+	Common::StackLock lock(_mutex);
+
+	EntryMap::iterator it = _entries.find(key);
+	if (it != _entries.end())
+		removeEntry(it);
+
+	if (buffer->getSize() > _maxSize) {
+		// Only the returned stream uses the samples
+		buffer->decRef();
+		return result;
+	}
+
+	shrink(_maxSize - buffer->getSize());
+
+	Entry &entry = _entries[key];
+	entry.buffer = buffer;
+	entry.lastAccess = ++_accessCounter;
+	_size += buffer->getSize();
+
+	return result;
+}
+
+bool AudioCache::contains(const Common::String &key) const {
+	Common::StackLock lock(_mutex);
+	return _entries.contains(key);
+}
+
+void AudioCache::remove(const Common::String &key) {
+	Common::StackLock lock(_mutex);
+
+	EntryMap::iterator it = _entries.find(key);
+	if (it != _entries.end())
+		removeEntry(it);
+}
+
+void AudioCache::clear() {
+	Common::StackLock lock(_mutex);
+
+	for (EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it)
+		it->_value.buffer->decRef();
+
+	_entries.clear();
+	_size = 0;
+}
+
+void AudioCache::setMaxSize(uint32 maxSize) {
+	Common::StackLock lock(_mutex);
+
+	_maxSize = maxSize;
+	shrink(maxSize);
+}
+
+void AudioCache::removeEntry(EntryMap::iterator it) {
+	_size -= it->_value.buffer->getSize();
+	it->_value.buffer->decRef();
+	_entries.erase(it);
+}
+
+void AudioCache::shrink(uint32 maxSize) {
+	// Drop the least recently used sounds until everything fits
+	while (_size > maxSize) {
+		EntryMap::iterator oldest = _entries.begin();
+		for (EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+			if (it->_value.lastAccess < oldest->_value.lastAccess)
+				oldest = it;
+		}
+
+		removeEntry(oldest);
+	}
+}
+
+} // End of namespace Audio
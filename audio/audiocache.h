@@ -0,0 +1,131 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_AUDIOCACHE_H
+#define AUDIO_AUDIOCACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/mutex.h"
+#include "common/str.h"
+#include "common/types.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_audiocache Decoded audio cache
+ * @ingroup audio
+ *
+ * @brief Cache for fully decoded, frequently replayed sounds.
+ * @{
+ */
+
+class AudioStream;
+class SeekableAudioStream;
+
+/**
+ * A cache of fully decoded sounds, limited to a size in bytes.
+ *
+ * Engines decode a sound once with addStream() and get further streams for
+ * it with getStream(). The streams returned by both share the decoded
+ * samples, so replaying a cached sound neither decodes nor copies anything.
+ *
+ * The keys are chosen by the engine and have to identify both the resource
+ * and anything that affects how it is decoded, e.g. "sfx/42" or
+ * "voc:door.voc@11025".
+ *
+ * When the cache grows beyond its size, the least recently used sounds are
+ * dropped. Streams still playing a dropped sound keep working, since the
+ * samples are only freed once the last stream using them is gone.
+ */
+class AudioCache {
+public:
+	/**
+	 * Create an audio cache.
+	 *
+	 * @param maxSize  The maximum size of all cached samples, in bytes.
+	 */
+	explicit AudioCache(uint32 maxSize);
+	~AudioCache();
+
+	/**
+	 * Get a new stream for a cached sound.
+	 *
+	 * @return The stream, or 0 if the sound is not cached.
+	 */
+	SeekableAudioStream *getStream(const Common::String &key);
+
+	/**
+	 * Decode a sound completely and store it in the cache.
+	 *
+	 * Sounds larger than the cache are not stored, but a stream for them is
+	 * returned nonetheless.
+	 *
+	 * @param key              The key to store the sound under.
+	 * @param stream           The stream to decode. It must not loop forever.
+	 * @param disposeAfterUse  Whether to delete the stream after decoding.
+	 * @return A stream playing the decoded sound, or 0 if it is empty.
+	 */
+	SeekableAudioStream *addStream(const Common::String &key, AudioStream *stream, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
+
+	/** Check whether a sound is cached. */
+	bool contains(const Common::String &key) const;
+
+	/** Drop a sound from the cache. */
+	void remove(const Common::String &key);
+
+	/** Drop all sounds from the cache. */
+	void clear();
+
+	/** Return the size of all cached samples, in bytes. */
+	uint32 getSize() const { return _size; }
+
+	/** Return the maximum size of all cached samples, in bytes. */
+	uint32 getMaxSize() const { return _maxSize; }
+
+	/** Change the maximum size, dropping sounds if necessary. */
+	void setMaxSize(uint32 maxSize);
+
+	/** Decoded samples shared by the cache and the streams playing them. */
+	struct Buffer;
+
+private:
+	struct Entry {
+		Buffer *buffer;
+		uint32 lastAccess;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	mutable Common::Mutex _mutex;
+	EntryMap _entries;
+	uint32 _size, _maxSize;
+	uint32 _accessCounter;
+
+	void removeEntry(EntryMap::iterator it);
+	void shrink(uint32 maxSize);
+};
+
+/** @} */
+
+} // End of namespace Audio
+
+#endif
@@ -19,10 +19,13 @@
  *
  */
 
+#include "common/array.h"
 #include "common/debug.h"
 #include "common/file.h"
 #include "common/mutex.h"
+#include "common/system.h"
 #include "common/textconsole.h"
+#include "common/timer.h"
 #include "common/queue.h"
 #include "common/util.h"
 
@@ -35,6 +38,8 @@
 #include "audio/decoders/wave.h"
 #include "audio/mixer.h"
 
+#include <atomic>
+
 
 namespace Audio {
 
@@ -468,6 +473,364 @@ AudioStream *makeLimitingAudioStream(AudioStream *parentStream, const Timestamp
 	return new LimitingAudioStream(parentStream, length, disposeAfterUse);
 }
 
+/**
+ * The decoded samples of a PrefetchingAudioStream, and the parent stream
+ * they are decoded from.
+ *
+ * The samples are kept in a single producer, single consumer ring buffer.
+ * The producer is a timer callback shared by all prefetching streams, the
+ * consumer is whoever reads the stream, usually the mixer. Both only
+ * advance their own position, so the reader never waits for the timer.
+ * Seeking is handed to the timer as a request as well, since only the timer
+ * may access the parent stream.
+ *
+ * There is no backend independent way to start a thread, which is why the
+ * timer thread is used. To keep it responsive for other callbacks, like
+ * music drivers, each call decodes at most kChunkSamples per stream.
+ *
+ * Streams are usually destroyed by the mixer, which holds its own lock while
+ * doing so. So destroying a stream only releases its buffer, which is then
+ * deleted by the timer callback. For the same reason the callback stays
+ * installed once the first stream was created.
+ */
+class PrefetchBuffer {
+public:
+	PrefetchBuffer(AudioStream *parentStream, DisposeAfterUse::Flag disposeAfterUse, uint32 bufferLength);
+	~PrefetchBuffer();
+
+	// Called by the reader
+	int read(int16 *buffer, int numSamples);
+	bool endOfData() const;
+	void requestSeek(const Timestamp &where);
+	void release();
+
+	/** Fill the buffer from the reading thread, if there is no timer. */
+	void prefetch();
+
+	AudioStream *getParent() const { return _parentStream.get(); }
+
+private:
+	enum {
+		/** The most samples decoded per stream in one timer callback. */
+		kChunkSamples = 4096
+	};
+
+	/**
+	 * Decode at most kChunkSamples into the free part of the ring buffer,
+	 * after handling a pending seek request.
+	 *
+	 * @return whether there is still room left to decode into.
+	 */
+	bool prefetchChunk();
+
+	bool isSeekPending() const { return _seekRequests.load(std::memory_order_acquire) != _seekDone.load(std::memory_order_acquire); }
+
+	/** The positions run from 0 to twice the buffer size, to tell a full buffer from an empty one. */
+	uint32 getBuffered(uint32 writePos, uint32 readPos) const { return writePos >= readPos ? writePos - readPos : writePos + 2 * _bufferSize - readPos; }
+	uint32 getIndex(uint32 pos) const { return pos >= _bufferSize ? pos - _bufferSize : pos; }
+	uint32 advance(uint32 pos, uint32 count) const { pos += count; return pos >= 2 * _bufferSize ? pos - 2 * _bufferSize : pos; }
+
+	Common::DisposablePtr<AudioStream> _parentStream;
+	SeekableAudioStream *_seekableStream;
+
+	int16 *_buffer;
+	uint32 _bufferSize;
+
+	/** Only advanced by the timer, or reset to the read position on seeking. */
+	std::atomic<uint32> _writePos;
+	/** Only advanced by the reader. */
+	std::atomic<uint32> _readPos;
+	/** Set once the parent stream has no more samples after the write position. */
+	std::atomic<bool> _parentEnded;
+
+	/** Guards the seek target, which is set by the reader and used by the timer. */
+	Common::Mutex _seekMutex;
+	Timestamp _seekTarget;
+	std::atomic<uint32> _seekRequests;
+	std::atomic<uint32> _seekDone;
+
+	/** Set by the reader once the stream was destroyed. */
+	std::atomic<bool> _released;
+
+	// The timer callback and the list of buffers it fills
+	static void timerProc(void *refCon);
+
+public:
+	/**
+	 * Add the buffer to the ones filled by the timer callback.
+	 *
+	 * @return false if there is no timer.
+	 */
+	static bool registerBuffer(PrefetchBuffer *buffer);
+
+private:
+	static Common::Mutex *_buffersMutex;
+	static Common::Array<PrefetchBuffer *> *_buffers;
+	static Common::TimerManager *_timerManager;
+};
+
+Common::Mutex *PrefetchBuffer::_buffersMutex = nullptr;
+Common::Array<PrefetchBuffer *> *PrefetchBuffer::_buffers = nullptr;
+Common::TimerManager *PrefetchBuffer::_timerManager = nullptr;
+
+PrefetchBuffer::PrefetchBuffer(AudioStream *parentStream, DisposeAfterUse::Flag disposeAfterUse, uint32 bufferLength) :
+		_parentStream(parentStream, disposeAfterUse), _seekableStream(dynamic_cast<SeekableAudioStream *>(parentStream)),
+		_writePos(0), _readPos(0), _parentEnded(false), _seekRequests(0), _seekDone(0), _released(false) {
+	const uint channels = parentStream->isStereo() ? 2 : 1;
+
+	// Keep whole sample frames, so that stereo channels never get mixed up
+	_bufferSize = MAX<uint32>(bufferLength * parentStream->getRate() / 1000, 1) * channels;
+	_buffer = new int16[_bufferSize];
+}
+
+PrefetchBuffer::~PrefetchBuffer() {
+	delete[] _buffer;
+}
+
+int PrefetchBuffer::read(int16 *buffer, int numSamples) {
+	if (isSeekPending())
+		return 0;
+
+	const uint32 writePos = _writePos.load(std::memory_order_acquire);
+	uint32 readPos = _readPos.load(std::memory_order_relaxed);
+
+	int samples = 0;
+	uint32 buffered = getBuffered(writePos, readPos);
+	while (samples < numSamples && buffered > 0) {
+		const uint32 index = getIndex(readPos);
+		const uint32 count = MIN<uint32>(MIN<uint32>(numSamples - samples, buffered), _bufferSize - index);
+		memcpy(buffer + samples, _buffer + index, count * sizeof(int16));
+
+		readPos = advance(readPos, count);
+		buffered -= count;
+		samples += count;
+	}
+
+	_readPos.store(readPos, std::memory_order_release);
+	return samples;
+}
+
+bool PrefetchBuffer::endOfData() const {
+	if (isSeekPending())
+		return false;
+
+	// The end flag has to be checked first, so that no samples written
+	// right before it was set are missed
+	const bool ended = _parentEnded.load(std::memory_order_acquire);
+	return ended && getBuffered(_writePos.load(std::memory_order_acquire), _readPos.load(std::memory_order_relaxed)) == 0;
+}
+
+void PrefetchBuffer::requestSeek(const Timestamp &where) {
+	{
+		Common::StackLock lock(_seekMutex);
+		_seekTarget = where;
+	}
+
+	_seekRequests.fetch_add(1, std::memory_order_release);
+}
+
+void PrefetchBuffer::release() {
+	_released.store(true, std::memory_order_release);
+}
+
+void PrefetchBuffer::prefetch() {
+	while (prefetchChunk())
+		;
+}
+
+bool PrefetchBuffer::prefetchChunk() {
+	const uint32 request = _seekRequests.load(std::memory_order_acquire);
+	if (request != _seekDone.load(std::memory_order_relaxed)) {
+		Timestamp where;
+		{
+			Common::StackLock lock(_seekMutex);
+			where = _seekTarget;
+		}
+
+		const bool result = _seekableStream && _seekableStream->seek(where);
+		_parentEnded.store(!result || _parentStream->endOfData(), std::memory_order_relaxed);
+
+		// Drop the samples from before the seek. The reader does not read
+		// while the request is pending, so its position stays the same.
+		_writePos.store(_readPos.load(std::memory_order_acquire), std::memory_order_relaxed);
+		_seekDone.store(request, std::memory_order_release);
+	}
+
+	if (_parentEnded.load(std::memory_order_relaxed))
+		return false;
+
+	const uint32 writePos = _writePos.load(std::memory_order_relaxed);
+	const uint32 samplesFree = _bufferSize - getBuffered(writePos, _readPos.load(std::memory_order_acquire));
+
+	// Only the part up to the end of the buffer can be filled at once. The
+	// chunk size is even, so stereo streams are still decoded in whole
+	// sample frames.
+	const uint32 index = getIndex(writePos);
+	const uint32 samplesToDecode = MIN<uint32>(MIN<uint32>(samplesFree, _bufferSize - index), kChunkSamples);
+	if (samplesToDecode == 0)
+		return false;
+
+	const int decoded = MAX(_parentStream->readBuffer(_buffer + index, samplesToDecode), 0);
+	const bool ended = (uint32)decoded < samplesToDecode || _parentStream->endOfData();
+
+	// Publish the samples before the end, see endOfData()
+	_writePos.store(advance(writePos, decoded), std::memory_order_release);
+	if (ended)
+		_parentEnded.store(true, std::memory_order_release);
+
+	return !ended && (uint32)decoded < samplesFree;
+}
+
+void PrefetchBuffer::timerProc(void *refCon) {
+	// Fill all buffers a chunk at a time, releasing the list lock in
+	// between, so that creating a stream never waits for long
+	bool more = true;
+	while (more) {
+		more = false;
+
+		Common::StackLock lock(*_buffersMutex);
+		for (uint i = 0; i < _buffers->size(); ) {
+			PrefetchBuffer *buffer = (*_buffers)[i];
+			if (buffer->_released.load(std::memory_order_acquire)) {
+				_buffers->remove_at(i);
+				delete buffer;
+				continue;
+			}
+
+			if (buffer->prefetchChunk())
+				more = true;
+			i++;
+		}
+	}
+}
+
+bool PrefetchBuffer::registerBuffer(PrefetchBuffer *buffer) {
+	Common::TimerManager *timer = g_system ? g_system->getTimerManager() : nullptr;
+	if (!timer)
+		return false;
+
+	if (!_buffersMutex) {
+		_buffersMutex = new Common::Mutex();
+		_buffers = new Common::Array<PrefetchBuffer *>();
+	}
+
+	bool installTimer;
+	{
+		Common::StackLock lock(*_buffersMutex);
+		_buffers->push_back(buffer);
+
+		// Reinstall the callback in case the backend was switched
+		installTimer = (_timerManager != timer);
+		_timerManager = timer;
+	}
+
+	// The list lock must not be held here, since the timer manager's lock
+	// is held while the callback runs
+	if (installTimer)
+		timer->installTimerProc(timerProc, 10000, nullptr, "AudioPrefetch");
+
+	return true;
+}
+
+/**
+ * A PrefetchingAudioStream reading from a PrefetchBuffer.
+ */
+class PrefetchingAudioStreamImpl : public PrefetchingAudioStream {
+public:
+	PrefetchingAudioStreamImpl(AudioStream *parentStream, DisposeAfterUse::Flag disposeAfterUse, uint32 bufferLength);
+	~PrefetchingAudioStreamImpl();
+
+	// Implement the AudioStream API
+	int readBuffer(int16 *buffer, const int numSamples) override;
+	bool isStereo() const override { return _stereo; }
+	int getRate() const override { return _rate; }
+	bool endOfData() const override { return _buffer->endOfData(); }
+	bool endOfStream() const override { return endOfData(); }
+
+	// Implement the SeekableAudioStream API
+	bool seek(const Timestamp &where) override;
+	Timestamp getLength() const override { return _length; }
+
+	// Implement the PrefetchingAudioStream API
+	uint32 getUnderrunCount() const override { return _underrunCount; }
+	uint32 getUnderrunSamples() const override { return _underrunSamples; }
+
+private:
+	PrefetchBuffer *_buffer;
+	bool _useTimer;
+
+	// The parent stream must only be accessed by the timer, so its
+	// properties are kept here
+	const bool _stereo;
+	const int _rate;
+	const bool _seekable;
+	const Timestamp _length;
+
+	uint32 _underrunCount, _underrunSamples;
+};
+
+PrefetchingAudioStreamImpl::PrefetchingAudioStreamImpl(AudioStream *parentStream, DisposeAfterUse::Flag disposeAfterUse, uint32 bufferLength) :
+		_stereo(parentStream->isStereo()), _rate(parentStream->getRate()),
+		_seekable(dynamic_cast<SeekableAudioStream *>(parentStream) != nullptr),
+		_length(_seekable ? dynamic_cast<SeekableAudioStream *>(parentStream)->getLength() : Timestamp(0, _rate)),
+		_underrunCount(0), _underrunSamples(0) {
+	_buffer = new PrefetchBuffer(parentStream, disposeAfterUse, bufferLength);
+
+	// Fill the buffer right away, so that playback does not start with
+	// an underrun
+	_buffer->prefetch();
+
+	_useTimer = PrefetchBuffer::registerBuffer(_buffer);
+}
+
+PrefetchingAudioStreamImpl::~PrefetchingAudioStreamImpl() {
+	// The timer deletes the buffer once it is done with it
+	if (_useTimer)
+		_buffer->release();
+	else
+		delete _buffer;
+}
+
+int PrefetchingAudioStreamImpl::readBuffer(int16 *buffer, const int numSamples) {
+	int samples = _buffer->read(buffer, numSamples);
+
+	// Without a timer, decode from the reading thread. Nothing else uses
+	// the buffer then.
+	while (!_useTimer && samples < numSamples && !_buffer->endOfData()) {
+		_buffer->prefetch();
+		samples += _buffer->read(buffer + samples, numSamples - samples);
+	}
+
+	if (samples < numSamples && !_buffer->endOfData()) {
+		// Never wait for the timer. Play silence instead, to keep the timing.
+		_underrunCount++;
+		_underrunSamples += numSamples - samples;
+
+		memset(buffer + samples, 0, (numSamples - samples) * sizeof(int16));
+		samples = numSamples;
+	}
+
+	return samples;
+}
+
+bool PrefetchingAudioStreamImpl::seek(const Timestamp &where) {
+	if (!_seekable || where > _length)
+		return false;
+
+	_buffer->requestSeek(where);
+	if (!_useTimer)
+		_buffer->prefetch();
+	return true;
+}
+
+PrefetchingAudioStream *makePrefetchingAudioStream(SeekableAudioStream *parentStream, DisposeAfterUse::Flag disposeAfterUse, uint32 bufferLength) {
+	return new PrefetchingAudioStreamImpl(parentStream, disposeAfterUse, bufferLength);
+}
+
+AudioStream *makePrefetchingAudioStream(AudioStream *parentStream, DisposeAfterUse::Flag disposeAfterUse, uint32 bufferLength) {
+	return new PrefetchingAudioStreamImpl(parentStream, disposeAfterUse, bufferLength);
+}
+
 /**
  * An AudioStream that plays nothing and immediately returns that
  * the endOfStream() has been reached
@@ -436,6 +436,55 @@ Timestamp convertTimeToStreamPos(const Timestamp &where, int rate, bool isStereo
  */
 AudioStream *makeLimitingAudioStream(AudioStream *parentStream, const Timestamp &length, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
 
+/**
+ * A SeekableAudioStream wrapper which decodes its parent stream ahead of
+ * time from a timer callback, so that reading from disk and decompressing
+ * does not happen while the mixer is waiting for samples.
+ *
+ * Reading never waits for the timer. If the prefetched samples run out,
+ * the missing samples are replaced with silence. Such underruns are
+ * counted, which allows to check whether the buffer is large enough.
+ * Seeking is done by the timer as well, so the stream plays silence until
+ * the timer caught up. Streams which loop should therefore be wrapped
+ * including their looping, see the factory function for AudioStreams.
+ *
+ * Without a timer manager, the samples are decoded while reading instead.
+ */
+class PrefetchingAudioStream : public SeekableAudioStream {
+public:
+	/**
+	 * Return how often a read could not be served from the prefetched
+	 * samples alone.
+	 */
+	virtual uint32 getUnderrunCount() const = 0;
+
+	/**
+	 * Return the total number of samples which were replaced with silence
+	 * because of underruns.
+	 */
+	virtual uint32 getUnderrunSamples() const = 0;
+};
+
+/**
+ * Factory function for a PrefetchingAudioStream.
+ *
+ * @param parentStream     The stream to decode ahead of time.
+ * @param disposeAfterUse  Whether the parent stream object should be destroyed on destruction of the returned stream.
+ * @param bufferLength     How far to decode ahead, in milliseconds.
+ */
+PrefetchingAudioStream *makePrefetchingAudioStream(SeekableAudioStream *parentStream, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES, uint32 bufferLength = 500);
+
+/**
+ * Factory function for an AudioStream which decodes any AudioStream ahead
+ * of time, like a PrefetchingAudioStream. This allows to prefetch looping
+ * streams, whose rewinding then happens in the timer as well.
+ *
+ * @param parentStream     The stream to decode ahead of time.
+ * @param disposeAfterUse  Whether the parent stream object should be destroyed on destruction of the returned stream.
+ * @param bufferLength     How far to decode ahead, in milliseconds.
+ */
+AudioStream *makePrefetchingAudioStream(AudioStream *parentStream, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES, uint32 bufferLength = 500);
+
 /**
  * An AudioStream designed to work in terms of packets.
  *
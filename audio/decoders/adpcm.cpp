@@ -47,14 +47,42 @@ ADPCMStream::ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Fl
 		_endpos(_startpos + size),
 		_channels(channels),
 		_blockAlign(blockAlign),
-		_rate(rate) {
+		_rate(rate),
+		_blockData(nullptr),
+		_blockSamples(nullptr) {
 
 	reset();
 }
 
+ADPCMStream::~ADPCMStream() {
+	delete[] _blockData;
+	delete[] _blockSamples;
+}
+
 void ADPCMStream::reset() {
 	memset(&_status, 0, sizeof(_status));
 	_blockPos[0] = _blockPos[1] = _blockAlign; // To make sure first header is read
+	_blockSampleCount = _blockSamplePos = 0;
+}
+
+void ADPCMStream::allocateBlockBuffers(uint32 dataSize, uint32 sampleCount) {
+	_blockData = new byte[dataSize];
+	_blockSamples = new int16[sampleCount];
+}
+
+uint32 ADPCMStream::readBlockData(uint32 size) {
+	const int32 pos = _stream->pos();
+	if (_stream->eos() || pos >= _endpos)
+		return 0;
+
+	return _stream->read(_blockData, MIN<uint32>(size, _endpos - pos));
+}
+
+int ADPCMStream::readBlockSamples(int16 *buffer, int numSamples) {
+	const int samples = MIN<int>(numSamples, _blockSampleCount - _blockSamplePos);
+	memcpy(buffer, _blockSamples + _blockSamplePos, samples * sizeof(int16));
+	_blockSamplePos += samples;
+	return samples;
 }
 
 bool ADPCMStream::rewind() {
@@ -69,20 +97,22 @@ bool ADPCMStream::rewind() {
 
 
 int Oki_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
-
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
-			_decodedSamples[0] = decodeOKI((data >> 4) & 0x0f);
-			_decodedSamples[1] = decodeOKI((data >> 0) & 0x0f);
-			_decodedSampleCount = 2;
+	int samples = readBlockSamples(buffer, numSamples);
+
+	while (samples < numSamples) {
+		const uint32 size = readBlockData(kADPCMChunkSize);
+		if (!size)
+			break;
+
+		int16 *dst = _blockSamples;
+		for (uint32 i = 0; i < size; i++) {
+			*dst++ = decodeOKI((_blockData[i] >> 4) & 0x0f);
+			*dst++ = decodeOKI((_blockData[i] >> 0) & 0x0f);
 		}
 
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
+		_blockSampleCount = size * 2;
+		_blockSamplePos = 0;
+		samples += readBlockSamples(buffer + samples, numSamples - samples);
 	}
 
 	return samples;
@@ -121,29 +151,22 @@ int16 Oki_ADPCMStream::decodeOKI(byte code) {
 
 
 int XA_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte *data = new byte[128];
-
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			uint32 bytesLeft = _stream->size() - _stream->pos();
-			if (bytesLeft < 128) {
-				_stream->skip(bytesLeft);
-				memset(&buffer[samples], 0, (numSamples - samples) * sizeof(uint16));
-				samples = numSamples;
-				break;
-			}
-			_stream->read(data, 128);
-			decodeXA(data);
-			_decodedSampleIndex = 0;
+	int samples = readBlockSamples(buffer, numSamples);
+
+	while (samples < numSamples && !endOfData()) {
+		uint32 bytesLeft = _stream->size() - _stream->pos();
+		if (bytesLeft < 128) {
+			_stream->skip(bytesLeft);
+			memset(&buffer[samples], 0, (numSamples - samples) * sizeof(uint16));
+			samples = numSamples;
+			break;
 		}
 
-		// _decodedSamples acts as a FIFO of depth 2 or 4;
-		buffer[samples] = _decodedSamples[_decodedSampleIndex++];
-		_decodedSampleCount--;
+		_stream->read(_blockData, 128);
+		decodeXA(_blockData);
+		samples += readBlockSamples(buffer + samples, numSamples - samples);
 	}
 
-	delete[] data;
 	return samples;
 }
 
@@ -156,8 +179,11 @@ static const int s_xaTable[5][2] = {
 };
 
 void XA_ADPCMStream::decodeXA(const byte *src) {
-	int16 *leftChannel = _decodedSamples;
-	int16 *rightChannel = _decodedSamples + 1;
+	int16 *leftChannel = _blockSamples;
+	int16 *rightChannel = _blockSamples + 1;
+
+	_blockSampleCount = 0;
+	_blockSamplePos = 0;
 
 	for (int i = 0; i < 4; i++) {
 		int shift = 12 - (src[4 + i * 2] & 0xf);
@@ -175,7 +201,7 @@ void XA_ADPCMStream::decodeXA(const byte *src) {
 			s_1 = CLIP<int>(s, -32768, 32767);
 			*leftChannel = s_1;
 			leftChannel += _channels;
-			_decodedSampleCount++;
+			_blockSampleCount++;
 		}
 
 		if (_channels == 2) {
@@ -203,7 +229,7 @@ void XA_ADPCMStream::decodeXA(const byte *src) {
 			} else {
 				*leftChannel++ = s_1;
 			}
-			_decodedSampleCount++;
+			_blockSampleCount++;
 		}
 
 		if (_channels == 2) {
@@ -221,20 +247,23 @@ void XA_ADPCMStream::decodeXA(const byte *src) {
 
 
 int DVI_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
-
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
-			_decodedSamples[0] = decodeIMA((data >> 4) & 0x0f, 0);
-			_decodedSamples[1] = decodeIMA((data >> 0) & 0x0f, _channels == 2 ? 1 : 0);
-			_decodedSampleCount = 2;
+	int samples = readBlockSamples(buffer, numSamples);
+	const int secondChannel = _channels == 2 ? 1 : 0;
+
+	while (samples < numSamples) {
+		const uint32 size = readBlockData(kADPCMChunkSize);
+		if (!size)
+			break;
+
+		int16 *dst = _blockSamples;
+		for (uint32 i = 0; i < size; i++) {
+			*dst++ = decodeIMA((_blockData[i] >> 4) & 0x0f, 0);
+			*dst++ = decodeIMA((_blockData[i] >> 0) & 0x0f, secondChannel);
 		}
 
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
+		_blockSampleCount = size * 2;
+		_blockSamplePos = 0;
+		samples += readBlockSamples(buffer + samples, numSamples - samples);
 	}
 
 	return samples;
@@ -247,63 +276,54 @@ int Apple_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 	// Need to write at least one samples per channel
 	assert((numSamples % _channels) == 0);
 
-	// Current sample positions
-	int samples[2] = { 0, 0};
+	int samples = readBlockSamples(buffer, numSamples);
 
-	// Number of samples per channel
-	int chanSamples = numSamples / _channels;
+	while (samples < numSamples && decodeBlock())
+		samples += readBlockSamples(buffer + samples, numSamples - samples);
 
-	for (int i = 0; i < _channels; i++) {
-		_stream->seek(_streamPos[i]);
-
-		while ((samples[i] < chanSamples) &&
-		       // Last byte read and a new one needed
-		       !((_stream->eos() || (_stream->pos() >= _endpos)) && (_chunkPos[i] == 0))) {
-
-			if (_blockPos[i] == _blockAlign) {
-				// 2 byte header per block
-				uint16 temp = _stream->readUint16BE();
-
-				// First 9 bits are the upper bits of the predictor
-				_status.ima_ch[i].last      = (int16) (temp & 0xFF80);
-				// Lower 7 bits are the step index
-				_status.ima_ch[i].stepIndex =          temp & 0x007F;
-
-				// Clip the step index
-				_status.ima_ch[i].stepIndex = CLIP<int32>(_status.ima_ch[i].stepIndex, 0, 88);
-
-				_blockPos[i] = 2;
-			}
-
-			if (_chunkPos[i] == 0) {
-				// Decode data
-				byte data = _stream->readByte();
-				_buffer[i][0] = decodeIMA(data &  0x0F, i);
-				_buffer[i][1] = decodeIMA(data >>    4, i);
-			}
-
-			// The original is interleaved block-wise, we want it sample-wise
-			buffer[_channels * samples[i] + i] = _buffer[i][_chunkPos[i]];
-
-			if (++_chunkPos[i] > 1) {
-				// We're about to decode the next byte, so advance the block position
-				_chunkPos[i] = 0;
-				_blockPos[i]++;
-			}
-
-			samples[i]++;
+	return samples;
+}
 
-			if (_channels == 2)
-				if (_blockPos[i] == _blockAlign)
-					// We're at the end of the block.
-					// Since the channels are interleaved, skip the next block
-					_stream->skip(MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
+bool Apple_ADPCMStream::decodeBlock() {
+	// The blocks of all channels are read at once. The last one may be
+	// truncated.
+	const uint32 size = readBlockData(_blockAlign * _channels);
+	if (size <= 2)
+		return false;
 
-			_streamPos[i] = _stream->pos();
+	// The original is interleaved block-wise, we want it sample-wise
+	uint32 channelSamples = (_blockAlign - 2) * 2;
+	for (int i = 0; i < _channels; i++) {
+		const byte *src = _blockData + i * _blockAlign;
+		const uint32 channelSize = MIN<uint32>(size - MIN<uint32>(size, i * _blockAlign), _blockAlign);
+		if (channelSize <= 2)
+			return false;
+
+		channelSamples = MIN<uint32>(channelSamples, (channelSize - 2) * 2);
+
+		// 2 byte header per block
+		uint16 temp = READ_BE_UINT16(src);
+
+		// First 9 bits are the upper bits of the predictor
+		_status.ima_ch[i].last      = (int16) (temp & 0xFF80);
+		// Lower 7 bits are the step index
+		_status.ima_ch[i].stepIndex =          temp & 0x007F;
+
+		// Clip the step index
+		_status.ima_ch[i].stepIndex = CLIP<int32>(_status.ima_ch[i].stepIndex, 0, 88);
+
+		int16 *dst = _blockSamples + i;
+		for (uint32 j = 2; j < channelSize; j++) {
+			*dst = decodeIMA(src[j] &  0x0F, i);
+			dst += _channels;
+			*dst = decodeIMA(src[j] >>    4, i);
+			dst += _channels;
 		}
 	}
 
-	return samples[0] + samples[1];
+	_blockSampleCount = channelSamples * _channels;
+	_blockSamplePos = 0;
+	return true;
 }
 
 
@@ -314,42 +334,47 @@ int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 	// Need to write at least one sample per channel
 	assert((numSamples % _channels) == 0);
 
-	int samples = 0;
+	int samples = readBlockSamples(buffer, numSamples);
 
-	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
-		if (_blockPos[0] == _blockAlign) {
-			for (int i = 0; i < _channels; i++) {
-				// read block header
-				_status.ima_ch[i].last = _stream->readSint16LE();
-				_status.ima_ch[i].stepIndex = _stream->readSint16LE();
-			}
+	while (samples < numSamples && decodeBlock())
+		samples += readBlockSamples(buffer + samples, numSamples - samples);
 
-			_blockPos[0] = _channels * 4;
-		}
+	return samples;
+}
+
+bool MSIma_ADPCMStream::decodeBlock() {
+	const uint32 size = readBlockData(_blockAlign);
+	const uint32 headerSize = _channels * 4;
+	if (size < headerSize)
+		return false;
 
-		// Decode a set of samples
+	const byte *src = _blockData;
+	for (int i = 0; i < _channels; i++) {
+		// read block header
+		_status.ima_ch[i].last = (int16)READ_LE_UINT16(src);
+		_status.ima_ch[i].stepIndex = CLIP<int32>((int16)READ_LE_UINT16(src + 2), 0, ARRAYSIZE(_imaTable) - 1);
+		src += 4;
+	}
+
+	// The stream encodes four bytes per channel at a time. A truncated set
+	// at the end of the data is dropped.
+	const uint32 setCount = (size - headerSize) / headerSize;
+	int16 *dst = _blockSamples;
+	for (uint32 set = 0; set < setCount; set++) {
 		for (int i = 0; i < _channels; i++) {
-			// The stream encodes four bytes per channel at a time
 			for (int j = 0; j < 4; j++) {
-				byte data = _stream->readByte();
-				_blockPos[0]++;
-				_buffer[i][j * 2] = decodeIMA(data & 0x0f, i);
-				_buffer[i][j * 2 + 1] = decodeIMA((data >> 4) & 0x0f, i);
-				_samplesLeft[i] += 2;
+				byte data = *src++;
+				dst[(j * 2) * _channels + i] = decodeIMA(data & 0x0f, i);
+				dst[(j * 2 + 1) * _channels + i] = decodeIMA((data >> 4) & 0x0f, i);
 			}
 		}
 
-		while (samples < numSamples && _samplesLeft[0] != 0) {
-			for (int i = 0; i < _channels; i++) {
-				buffer[samples + i] = _buffer[i][8 - _samplesLeft[i]];
-				_samplesLeft[i]--;
-			}
-
-			samples += _channels;
-		}
+		dst += 8 * _channels;
 	}
 
-	return samples;
+	_blockSampleCount = setCount * 8 * _channels;
+	_blockSamplePos = 0;
+	return true;
 }
 
 
@@ -388,48 +413,53 @@ int16 MS_ADPCMStream::decodeMS(ADPCMChannelStatus *c, byte code) {
 }
 
 int MS_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
-	int i;
+	int samples = readBlockSamples(buffer, numSamples);
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			if (_blockPos[0] == _blockAlign) {
-				// read block header
-				for (i = 0; i < _channels; i++) {
-					_status.ch[i].predictor = CLIP(_stream->readByte(), (byte)0, (byte)6);
-					_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
-					_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
-				}
+	while (samples < numSamples && decodeBlock())
+		samples += readBlockSamples(buffer + samples, numSamples - samples);
 
-				for (i = 0; i < _channels; i++)
-					_status.ch[i].delta = _stream->readSint16LE();
+	return samples;
+}
 
-				for (i = 0; i < _channels; i++)
-					_status.ch[i].sample1 = _stream->readSint16LE();
+bool MS_ADPCMStream::decodeBlock() {
+	const uint32 size = readBlockData(_blockAlign);
+	const uint32 headerSize = _channels * 7;
+	if (size < headerSize)
+		return false;
 
-				for (i = 0; i < _channels; i++)
-					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample2 = _stream->readSint16LE();
+	const byte *src = _blockData;
+	int16 *dst = _blockSamples;
+	int i;
 
-				for (i = 0; i < _channels; i++)
-					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample1;
+	// read block header
+	for (i = 0; i < _channels; i++) {
+		_status.ch[i].predictor = CLIP(*src++, (byte)0, (byte)6);
+		_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
+		_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
+	}
 
-				_blockPos[0] = _channels * 7;
-			} else {
-				data = _stream->readByte();
-				_blockPos[0]++;
-				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[0], (data >> 4) & 0x0f);
-				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[_channels - 1], data & 0x0f);
-			}
-			_decodedSampleIndex = 0;
-		}
+	for (i = 0; i < _channels; i++, src += 2)
+		_status.ch[i].delta = (int16)READ_LE_UINT16(src);
+
+	for (i = 0; i < _channels; i++, src += 2)
+		_status.ch[i].sample1 = (int16)READ_LE_UINT16(src);
+
+	for (i = 0; i < _channels; i++, src += 2)
+		*dst++ = _status.ch[i].sample2 = (int16)READ_LE_UINT16(src);
 
-		// _decodedSamples acts as a FIFO of depth 2 or 4;
-		buffer[samples] = _decodedSamples[_decodedSampleIndex++];
-		_decodedSampleCount--;
+	for (i = 0; i < _channels; i++)
+		*dst++ = _status.ch[i].sample1;
+
+	ADPCMChannelStatus *second = &_status.ch[_channels - 1];
+	for (uint32 j = headerSize; j < size; j++) {
+		const byte data = *src++;
+		*dst++ = decodeMS(&_status.ch[0], (data >> 4) & 0x0f);
+		*dst++ = decodeMS(second, data & 0x0f);
 	}
 
-	return samples;
+	_blockSampleCount = dst - _blockSamples;
+	_blockSamplePos = 0;
+	return true;
 }
 
 
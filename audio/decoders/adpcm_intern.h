@@ -57,12 +57,44 @@ protected:
 		} ima_ch[2];
 	} _status;
 
+	/**
+	 * Buffers for decoders which decode a whole block at once. The raw data
+	 * of a block is read into _blockData with a single read, and decoded
+	 * into _blockSamples, from which readBuffer() copies the samples.
+	 */
+	byte *_blockData;
+	int16 *_blockSamples;
+	uint32 _blockSampleCount; ///< Number of samples in _blockSamples
+	uint32 _blockSamplePos;   ///< Position of the next sample to return from _blockSamples
+
 	virtual void reset();
 
+	/**
+	 * Allocate the block buffers. Call this from the constructor of
+	 * decoders which use them.
+	 */
+	void allocateBlockBuffers(uint32 dataSize, uint32 sampleCount);
+
+	/**
+	 * Read up to size bytes of the stream into _blockData, without going
+	 * past the end of the ADPCM data.
+	 *
+	 * @return The number of bytes read.
+	 */
+	uint32 readBlockData(uint32 size);
+
+	/**
+	 * Copy up to numSamples samples from _blockSamples into buffer.
+	 *
+	 * @return The number of samples copied.
+	 */
+	int readBlockSamples(int16 *buffer, int numSamples);
+
 public:
 	ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign);
+	virtual ~ADPCMStream();
 
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos); }
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && _blockSamplePos == _blockSampleCount; }
 	virtual bool isStereo() const { return _channels == 2; }
 	virtual int getRate() const { return _rate; }
 
@@ -80,39 +112,31 @@ public:
 	static const int16 _stepAdjustTable[16];
 };
 
+/**
+ * Number of bytes which decoders of formats without blocks read at once.
+ */
+static const uint32 kADPCMChunkSize = 512;
+
 class Oki_ADPCMStream : public ADPCMStream {
 public:
 	Oki_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
-		: ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { _decodedSampleCount = 0; }
-
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+		: ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { allocateBlockBuffers(kADPCMChunkSize, kADPCMChunkSize * 2); }
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
 protected:
 	int16 decodeOKI(byte);
-
-private:
-	uint8 _decodedSampleCount;
-	int16 _decodedSamples[2];
 };
 
 class XA_ADPCMStream : public ADPCMStream {
 public:
 	XA_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
-		: ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { _decodedSampleCount = 0; }
-
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+		: ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { allocateBlockBuffers(128, 28 * 2 * 4); }
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
 protected:
 	void decodeXA(const byte *src);
-
-private:
-	uint8 _decodedSampleCount;
-	uint8 _decodedSampleIndex;
-	int16 _decodedSamples[28 * 2 * 4];
 };
 
 class Ima_ADPCMStream : public ADPCMStream {
@@ -132,43 +156,23 @@ public:
 class DVI_ADPCMStream : public Ima_ADPCMStream {
 public:
 	DVI_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
-		: Ima_ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { _decodedSampleCount = 0; }
-
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+		: Ima_ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { allocateBlockBuffers(kADPCMChunkSize, kADPCMChunkSize * 2); }
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
-
-private:
-	uint8 _decodedSampleCount;
-	int16 _decodedSamples[2];
 };
 
 class Apple_ADPCMStream : public Ima_ADPCMStream {
-protected:
-	// Apple QuickTime IMA ADPCM
-	int32 _streamPos[2];
-	int16 _buffer[2][2];
-	uint8 _chunkPos[2];
-
-	void reset() {
-		Ima_ADPCMStream::reset();
-		_chunkPos[0] = 0;
-		_chunkPos[1] = 0;
-		_streamPos[0] = 0;
-		_streamPos[1] = _blockAlign;
-	}
-
 public:
 	Apple_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
 		: Ima_ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) {
-		_chunkPos[0] = 0;
-		_chunkPos[1] = 0;
-		_streamPos[0] = 0;
-		_streamPos[1] = _blockAlign;
+		// Apple QuickTime IMA ADPCM, the blocks of the channels are interleaved
+		allocateBlockBuffers(_blockAlign * _channels, (_blockAlign - 2) * 2 * _channels);
 	}
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
+private:
+	bool decodeBlock();
 };
 
 class MSIma_ADPCMStream : public Ima_ADPCMStream {
@@ -182,21 +186,13 @@ public:
 		if (blockAlign % (_channels * 4))
 			error("MSIma_ADPCMStream(): invalid blockAlign");
 
-		_samplesLeft[0] = 0;
-		_samplesLeft[1] = 0;
+		allocateBlockBuffers(_blockAlign, _blockAlign * 2);
 	}
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
-	void reset() {
-		Ima_ADPCMStream::reset();
-		_samplesLeft[0] = 0;
-		_samplesLeft[1] = 0;
-	}
-
 private:
-	int16 _buffer[2][8];
-	int _samplesLeft[2];
+	bool decodeBlock();
 };
 
 class MS_ADPCMStream : public ADPCMStream {
@@ -226,21 +222,16 @@ public:
 		if (blockAlign == 0)
 			error("MS_ADPCMStream(): blockAlign isn't specified for MS ADPCM");
 		memset(&_status, 0, sizeof(_status));
-		_decodedSampleCount = 0;
-		_decodedSampleIndex = 0;
+		allocateBlockBuffers(_blockAlign, _blockAlign * 2);
 	}
 
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
-
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
 protected:
 	int16 decodeMS(ADPCMChannelStatus *c, byte);
 
 private:
-	uint8 _decodedSampleCount;
-	uint8 _decodedSampleIndex;
-	int16 _decodedSamples[4];
+	bool decodeBlock();
 };
 
 // Duck DK3 IMA ADPCM Decoder
@@ -23,6 +23,7 @@
 
 #ifdef USE_MAD
 
+#include "common/array.h"
 #include "common/debug.h"
 #include "common/mutex.h"
 #include "common/ptr.h"
@@ -108,6 +109,23 @@ protected:
 
 private:
 	static Common::SeekableReadStream *skipID3(Common::SeekableReadStream *stream, DisposeAfterUse::Flag dispose);
+
+	enum {
+		// Number of frames between two seek points, about a third of a
+		// second for 44.1kHz Layer III streams
+		SEEK_POINT_INTERVAL = 16
+	};
+
+	struct SeekPoint {
+		uint32 offset;     // Stream offset of the frame
+		mad_timer_t time;  // Start time of the frame
+	};
+
+	// Frame positions collected while scanning the stream for its length,
+	// so that seeking only has to walk the headers from the closest one
+	Common::Array<SeekPoint> _seekPoints;
+
+	const SeekPoint *findSeekPoint(const mad_timer_t &time) const;
 };
 
 class PacketizedMP3Stream : private BaseMP3Stream, public PacketizedAudioStream {
@@ -336,10 +354,20 @@ MP3Stream::MP3Stream(Common::SeekableReadStream *inStream, DisposeAfterUse::Flag
 	_channels = MAD_NCHANNELS(&_frame.header);
 	_rate = _frame.header.samplerate;
 
-	// Calculate the length of the stream
-	while (_state != MP3_STATE_EOS)
+	// Calculate the length of the stream, remembering where some of the
+	// frames start along the way
+	for (uint frame = 1; _state != MP3_STATE_EOS; frame++) {
+		const mad_timer_t frameStart = _curTime;
 		readHeader(*_inStream);
 
+		if (_state == MP3_STATE_READY && (frame % SEEK_POINT_INTERVAL) == 0) {
+			SeekPoint seekPoint;
+			seekPoint.offset = _inStream->pos() - (_stream.bufend - _stream.this_frame);
+			seekPoint.time = frameStart;
+			_seekPoints.push_back(seekPoint);
+		}
+	}
+
 	// To rule out any invalid sample rate to be encountered here, say in case the
 	// MP3 stream is invalid, we just check the MAD error code here.
 	// We need to assure this, since else we might trigger an assertion in Timestamp
@@ -376,9 +404,16 @@ bool MP3Stream::seek(const Timestamp &where) {
 	mad_timer_t destination;
 	mad_timer_set(&destination, time / 1000, time % 1000, 1000);
 
-	if (_state != MP3_STATE_READY || mad_timer_compare(destination, _curTime) < 0) {
-		_inStream->seek(0);
+	// Restart from the closest known frame, unless we are already closer
+	const SeekPoint *seekPoint = findSeekPoint(destination);
+
+	if (_state != MP3_STATE_READY || mad_timer_compare(destination, _curTime) < 0 ||
+			(seekPoint && mad_timer_compare(seekPoint->time, _curTime) > 0)) {
+		_inStream->seek(seekPoint ? seekPoint->offset : 0);
 		initStream(*_inStream);
+
+		if (seekPoint)
+			_curTime = seekPoint->time;
 	}
 
 	while (mad_timer_compare(destination, _curTime) > 0 && _state != MP3_STATE_EOS)
@@ -389,6 +424,20 @@ bool MP3Stream::seek(const Timestamp &where) {
 	return (_state != MP3_STATE_EOS);
 }
 
+const MP3Stream::SeekPoint *MP3Stream::findSeekPoint(const mad_timer_t &time) const {
+	// Binary search for the last seek point not after the given time
+	uint first = 0, last = _seekPoints.size();
+	while (first < last) {
+		const uint mid = (first + last) / 2;
+		if (mad_timer_compare(_seekPoints[mid].time, time) <= 0)
+			first = mid + 1;
+		else
+			last = mid;
+	}
+
+	return first ? &_seekPoints[first - 1] : 0;
+}
+
 Common::SeekableReadStream *MP3Stream::skipID3(Common::SeekableReadStream *stream, DisposeAfterUse::Flag dispose) {
 	// Skip ID3 TAG if any
 	// ID3v1 (beginning with with 'TAG') is located at the end of files. So we can ignore those.
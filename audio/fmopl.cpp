@@ -22,6 +22,7 @@
 #include "audio/fmopl.h"
 
 #include "audio/mixer.h"
+#include "audio/rendercache.h"
 #ifdef USE_RETROWAVE
 #include "audio/rwopl3.h"
 #endif
@@ -406,7 +407,8 @@ EmulatedOPL::EmulatedOPL() :
 	_nextTick(0),
 	_samplesPerTick(0),
 	_baseFreq(0),
-	_handle(new Audio::SoundHandle()) {
+	_handle(new Audio::SoundHandle()),
+	_renderCache(nullptr) {
 }
 
 EmulatedOPL::~EmulatedOPL() {
@@ -417,6 +419,7 @@ EmulatedOPL::~EmulatedOPL() {
 	stop();
 
 	delete _handle;
+	delete _renderCache;
 }
 
 int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
@@ -429,10 +432,19 @@ int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
 		if (step > (_nextTick >> FIXP_SHIFT))
 			step = (_nextTick >> FIXP_SHIFT);
 
-		generateSamples(buffer, step * stereoFactor);
+		int cached = _renderCache ? _renderCache->read(buffer, step) : 0;
+		if (cached < step) {
+			generateSamples(buffer + cached * stereoFactor, (step - cached) * stereoFactor);
+			if (_renderCache)
+				_renderCache->write(buffer + cached * stereoFactor, step - cached);
+		}
 
 		_nextTick -= step << FIXP_SHIFT;
 		if (!(_nextTick >> FIXP_SHIFT)) {
+			// Count the ticks of a cached song from its start
+			if (_renderCache && _renderCache->onTick())
+				_nextTick = 0;
+
 			if (_callback && _callback->isValid())
 				(*_callback)();
 
@@ -456,7 +468,9 @@ void EmulatedOPL::startCallbacks(int timerFrequency) {
 }
 
 void EmulatedOPL::stopCallbacks() {
-	g_system->getMixer()->stopHandle(*_handle);
+	// An OPL which was never started is not known to the mixer
+	if (_callback)
+		g_system->getMixer()->stopHandle(*_handle);
 }
 
 void EmulatedOPL::setCallbackFrequency(int timerFrequency) {
@@ -472,4 +486,34 @@ void EmulatedOPL::setCallbackFrequency(int timerFrequency) {
 	_samplesPerTick = (d << FIXP_SHIFT) + (r << FIXP_SHIFT) / _baseFreq;
 }
 
+void EmulatedOPL::setRenderCacheSong(const Common::String &song) {
+	if (!_renderCache)
+		return;
+
+	if (song.empty())
+		_renderCache->stopSong();
+	else
+		_renderCache->startSong(song);
+}
+
+void EmulatedOPL::initRenderCache(const Common::String &emulator) {
+	// Emulators which reset through init() keep their cache
+	if (!_renderCache && Audio::RenderCache::isEnabled())
+		_renderCache = createRenderCache(emulator);
+}
+
+Audio::RenderCache *EmulatedOPL::createRenderCache(const Common::String &emulator) {
+	return new Audio::RenderCache(emulator, getRate(), isStereo());
+}
+
+void EmulatedOPL::cacheWrite(int a, int v) {
+	if (_renderCache)
+		_renderCache->addInput(((uint32)a << 8) | (v & 0xFF));
+}
+
+void EmulatedOPL::cacheWriteReg(int r, int v) {
+	if (_renderCache)
+		_renderCache->addInput(0x80000000 | ((uint32)r << 8) | (v & 0xFF));
+}
+
 } // End of namespace OPL
@@ -29,6 +29,7 @@
 #include "common/scummsys.h"
 
 namespace Audio {
+class RenderCache;
 class SoundHandle;
 }
 
@@ -183,6 +184,16 @@ public:
 	 */
 	virtual void setCallbackFrequency(int timerFrequency) = 0;
 
+	/**
+	 * Start caching the output of the OPL for a song, see
+	 * Audio::RenderCache. This is ignored by real OPLs and when the render
+	 * cache is disabled. This must not be called from the audio thread.
+	 *
+	 * @param song	identifies the song and the driver playing it, or an
+	 *				empty string to stop caching
+	 */
+	virtual void setRenderCacheSong(const Common::String &song) {}
+
 	enum {
 		/**
 		 * The default callback frequency that start() uses
@@ -276,6 +287,7 @@ public:
 
 	// OPL API
 	void setCallbackFrequency(int timerFrequency);
+	void setRenderCacheSong(const Common::String &song);
 
 	// AudioStream API
 	int readBuffer(int16 *buffer, const int numSamples);
@@ -299,6 +311,26 @@ protected:
 	 */
 	virtual void generateSamples(int16 *buffer, int numSamples) = 0;
 
+	/**
+	 * Set up the render cache, if it is enabled. Emulators call this once
+	 * they know their output rate.
+	 *
+	 * @param emulator	identifies the emulator and its settings
+	 */
+	void initRenderCache(const Common::String &emulator);
+
+	/**
+	 * Create the render cache for initRenderCache().
+	 */
+	virtual Audio::RenderCache *createRenderCache(const Common::String &emulator);
+
+	/**
+	 * Add a write() or writeReg() call to the render cache. Emulators have
+	 * to call this for every write.
+	 */
+	void cacheWrite(int a, int v);
+	void cacheWriteReg(int r, int v);
+
 private:
 	int _baseFreq;
 
@@ -310,6 +342,7 @@ private:
 	int _samplesPerTick;
 
 	Audio::SoundHandle *_handle;
+	Audio::RenderCache *_renderCache;
 };
 /** @} */
 } // End of namespace OPL
@@ -457,7 +457,22 @@ public:
 		 * False: note offs for OPL rhythm mode instruments are processed.
 		 * True: note offs for OPL rhythm mode instruments are ignored.
 		 */
-		PROP_OPL_RHYTHM_MODE_IGNORE_NOTE_OFF = 10
+		PROP_OPL_RHYTHM_MODE_IGNORE_NOTE_OFF = 10,
+		/**
+		 * Set this property to start caching the output of an emulated
+		 * driver for the song with the given hash, see Audio::RenderCache.
+		 * The hash has to cover all song data that affects the output,
+		 * e.g. computed with Audio::RenderCache::hashSongData(). It is the
+		 * engine's responsibility to only use this for songs which are
+		 * played the same way every time.
+		 * Drivers without emulation or without the render cache enabled
+		 * ignore this property. Since this opens and closes the cache
+		 * files, it must not be set from the audio thread.
+		 *
+		 * Hash of the song data: start caching the song.
+		 * 0: stop caching.
+		 */
+		PROP_RENDER_CACHE_SONG = 11
 	};
 
 	/**
@@ -50,7 +50,9 @@ _activeTrack(255),
 _abortParse(false),
 _jumpingToTick(false),
 _doParse(true),
-_pause(false) {
+_pause(false),
+_jumpCheckpointTrack(nullptr),
+_jumpCheckpointTempo(0) {
 	memset(_activeNotes, 0, sizeof(_activeNotes));
 	memset(_tracks, 0, sizeof(_tracks));
 	_nextEvent.start = nullptr;
@@ -472,9 +474,53 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 	Tracker currentPos(_position);
 	EventInfo currentEvent(_nextEvent);
 
+	// The checkpoints depend on the tempo at the start of the jump, since
+	// the event times are calculated with it until the first tempo event.
+	if (_jumpCheckpointTrack != _tracks[_activeTrack] || _jumpCheckpointTempo != _tempo) {
+		clearJumpCheckpoints();
+		_jumpCheckpointTrack = _tracks[_activeTrack];
+		_jumpCheckpointTempo = _tempo;
+	}
+
+	// Continue from the last checkpoint before the target tick. When events
+	// have to be fired, the channel state at the checkpoint is sent instead
+	// of the events before it.
+	int checkpoint = -1;
+	if (tick > 0 && (!fireEvents || stopNotes)) {
+		uint lo = 0, hi = _jumpCheckpoints.size();
+		while (lo < hi) {
+			uint mid = (lo + hi) / 2;
+			if (_jumpCheckpoints[mid].nextEventTick < tick)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+
+		checkpoint = (int)lo - 1;
+		if (fireEvents) {
+			while (checkpoint >= 0 && !_jumpCheckpoints[checkpoint].state.replayable)
+				checkpoint--;
+		}
+	}
+
+	JumpState state;
 	resetTracking();
-	_position._playPos = _tracks[_activeTrack];
-	parseNextEvent(_nextEvent);
+	if (checkpoint >= 0) {
+		const JumpCheckpoint &cp = _jumpCheckpoints[checkpoint];
+		_position = cp.position;
+		_nextEvent = cp.nextEvent;
+		_tempo = cp.tempo;
+		_psecPerTick = cp.psecPerTick;
+		state = cp.state;
+
+		if (fireEvents)
+			sendJumpState(state);
+	} else {
+		_position._playPos = _tracks[_activeTrack];
+		parseNextEvent(_nextEvent);
+	}
+
+	uint eventsSinceCheckpoint = 0;
 	if (tick > 0) {
 		while (true) {
 			EventInfo &info = _nextEvent;
@@ -484,6 +530,11 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 				break;
 			}
 
+			if (eventsSinceCheckpoint >= kJumpCheckpointInterval && canCreateJumpCheckpoint()) {
+				addJumpCheckpoint(state);
+				eventsSinceCheckpoint = 0;
+			}
+
 			_position._lastEventTick += info.delta;
 			_position._lastEventTime += info.delta * _psecPerTick;
 			_position._playTick = _position._lastEventTick;
@@ -501,10 +552,12 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 				_jumpingToTick = false;
 				return false;
 			} else {
+				state.update(info);
 				processEvent(info, fireEvents);
 			}
 
 			parseNextEvent(_nextEvent);
+			eventsSinceCheckpoint++;
 		}
 	}
 
@@ -529,6 +582,99 @@ bool MidiParser::jumpToTick(uint32 tick, bool fireEvents, bool stopNotes, bool d
 	return true;
 }
 
+void MidiParser::addJumpCheckpoint(const JumpState &state) {
+	const uint32 nextEventTick = _position._lastEventTick + _nextEvent.delta;
+
+	// Only positions beyond the known ones are new
+	if (!_jumpCheckpoints.empty() && _jumpCheckpoints.back().nextEventTick >= nextEventTick)
+		return;
+
+	JumpCheckpoint cp;
+	cp.position = _position;
+	cp.nextEvent = _nextEvent;
+	cp.nextEventTick = nextEventTick;
+	cp.tempo = _tempo;
+	cp.psecPerTick = _psecPerTick;
+	cp.state = state;
+	_jumpCheckpoints.push_back(cp);
+}
+
+void MidiParser::sendJumpState(const JumpState &state) {
+	for (int i = 0; i < 16; ++i) {
+		for (int j = 0; j < 128; ++j) {
+			if (state.controllers[i][j] != 0xFF)
+				sendToDriver(0xB0 | i, j, state.controllers[i][j]);
+		}
+
+		if (state.programs[i] != 0xFF)
+			sendToDriver(0xC0 | i, state.programs[i], 0);
+		if (state.pressures[i] != 0xFF)
+			sendToDriver(0xD0 | i, state.pressures[i], 0);
+		if (state.pitchBends[i] != 0xFFFF)
+			sendToDriver(0xE0 | i, state.pitchBends[i] & 0x7F, state.pitchBends[i] >> 7);
+	}
+
+	if (state.tempoData)
+		sendMetaEventToDriver(0x51, state.tempoData, (uint16)state.tempoLength);
+}
+
+void MidiParser::clearJumpCheckpoints() {
+	_jumpCheckpoints.clear();
+	_jumpCheckpointTrack = nullptr;
+}
+
+void JumpState::clear() {
+	memset(controllers, 0xFF, sizeof(controllers));
+	memset(programs, 0xFF, sizeof(programs));
+	memset(pressures, 0xFF, sizeof(pressures));
+	memset(pitchBends, 0xFF, sizeof(pitchBends));
+	tempoData = nullptr;
+	tempoLength = 0;
+	replayable = true;
+}
+
+void JumpState::update(const EventInfo &info) {
+	if (info.noop) {
+		replayable = false;
+		return;
+	}
+
+	switch (info.command()) {
+	case 0x8:
+	case 0x9:
+	case 0xA:
+		// Notes don't outlast a jump which stops notes
+		break;
+	case 0xB:
+		// Data entry, (N)RPN selection, channel mode messages and
+		// format-specific controllers depend on the order of the events
+		if (info.basic.param1 == 6 || info.basic.param1 == 38 ||
+				(info.basic.param1 >= 96 && info.basic.param1 <= 101) || info.basic.param1 >= 102)
+			replayable = false;
+		else
+			controllers[info.channel()][info.basic.param1] = info.basic.param2;
+		break;
+	case 0xC:
+		programs[info.channel()] = info.basic.param1;
+		break;
+	case 0xD:
+		pressures[info.channel()] = info.basic.param1;
+		break;
+	case 0xE:
+		pitchBends[info.channel()] = info.basic.param1 | (info.basic.param2 << 7);
+		break;
+	default:
+		if (info.event == 0xFF && info.ext.type == 0x51) {
+			tempoData = info.ext.data;
+			tempoLength = info.length;
+		} else {
+			// SysEx and other meta events
+			replayable = false;
+		}
+		break;
+	}
+}
+
 void MidiParser::unloadMusic() {
 	if (_numTracks == 0)
 		// No music data loaded
@@ -538,6 +684,7 @@ void MidiParser::unloadMusic() {
 	_numTracks = 0;
 	_activeTrack = 255;
 	_abortParse = true;
+	clearJumpCheckpoints();
 
 	if (_centerPitchWheelOnUnload) {
 		// Center the pitch wheels in preparation for the next piece of
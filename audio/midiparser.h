@@ -25,6 +25,7 @@
 #define AUDIO_MIDIPARSER_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/endian.h"
 #include "common/stream.h"
 
@@ -125,6 +126,39 @@ struct NoteTimer {
 	NoteTimer() : channel(0), note(0), timeLeft(0) {}
 };
 
+/**
+ * Keeps track of the state that the events up to a point in a track leave
+ * the MIDI channels in. MidiParser::jumpToTick() uses this to send the
+ * state at a checkpoint, instead of all events before it.
+ */
+struct JumpState {
+	byte controllers[16][128]; ///< Last value of each controller, or 0xFF if not set
+	byte programs[16];         ///< Last program, or 0xFF if not set
+	byte pressures[16];        ///< Last channel pressure, or 0xFF if not set
+	uint16 pitchBends[16];     ///< Last pitch bend, or 0xFFFF if not set
+	byte *tempoData;           ///< Data of the last tempo event, if any
+	uint32 tempoLength;        ///< Length of the last tempo event
+	bool replayable;           ///< False if there were events which can't be summed up by the state
+
+	JumpState() { clear(); }
+
+	void clear();
+	void update(const EventInfo &info);
+};
+
+/**
+ * A position in a track reached while jumping, with everything needed to
+ * continue parsing from there.
+ */
+struct JumpCheckpoint {
+	Tracker position;     ///< The position at the checkpoint
+	EventInfo nextEvent;  ///< The next event to process
+	uint32 nextEventTick; ///< The tick of the next event
+	uint32 tempo;         ///< The tempo at the checkpoint
+	uint32 psecPerTick;   ///< Microseconds per tick at the checkpoint
+	JumpState state;      ///< The channel state at the checkpoint
+};
+
 
 
 
@@ -289,6 +323,7 @@ struct NoteTimer {
 class MidiParser {
 protected:
 	static const uint8 MAXIMUM_TRACKS = 120;
+	static const uint kJumpCheckpointInterval = 128; ///< Number of events between jump checkpoints
 
 	uint16    _activeNotes[128];   ///< Each uint16 is a bit mask for channels that have that note on.
 	NoteTimer _hangingNotes[32];   ///< Maintains expiration info for up to 32 notes.
@@ -320,6 +355,15 @@ protected:
 	bool   _doParse;       ///< True if the parser should be parsing; false if it should not be active
 	bool   _pause;		   ///< True if the parser has paused parsing
 
+	/**
+	 * Checkpoints recorded by jumpToTick() in the active track, ordered by
+	 * tick. They are only valid for the track data and the tempo which
+	 * were current when the first of them was recorded.
+	 */
+	Common::Array<JumpCheckpoint> _jumpCheckpoints;
+	byte  *_jumpCheckpointTrack;     ///< Track data the checkpoints were recorded for
+	uint32 _jumpCheckpointTempo;     ///< Tempo at the start of the jumps which recorded the checkpoints
+
 	/**
 	 * The source number to use when sending MIDI messages to the driver.
 	 * When using multiple sources, use source 0 and higher. This must be
@@ -347,6 +391,17 @@ protected:
 	 */
 	virtual void onTrackStart(uint8 track) { };
 
+	/**
+	 * Whether the state of the parser can be recorded in a jump checkpoint
+	 * at the current position. This requires that all format-specific
+	 * parsing state is part of the Tracker and the next event.
+	 * Subclasses which support this should implement it.
+	 */
+	virtual bool canCreateJumpCheckpoint() const { return false; }
+	void addJumpCheckpoint(const JumpState &state);
+	void sendJumpState(const JumpState &state);
+	void clearJumpCheckpoints();
+
 	virtual void sendToDriver(uint32 b);
 	void sendToDriver(byte status, byte firstOp, byte secondOp) {
 		sendToDriver(status | ((uint32)firstOp << 8) | ((uint32)secondOp << 16));
@@ -79,6 +79,9 @@ protected:
 		_loopCount = -1;
 	}
 	void onTrackStart(uint8 track) override;
+	// Loops are handled while parsing, so a checkpoint must not be inside
+	// one. Callbacks would be skipped when continuing from a checkpoint.
+	bool canCreateJumpCheckpoint() const override { return _loopCount < 0 && !_callbackProc; }
 public:
 	MidiParser_XMIDI(XMidiCallbackProc proc, void *data, int8 source = -1) :
 			MidiParser(source),
@@ -21,6 +21,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/profiler.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -37,6 +38,8 @@ namespace Audio {
 #pragma mark -
 
 
+class SubmixGroup;
+
 /**
  * Channel used by the default Mixer implementation.
  */
@@ -56,10 +59,32 @@ public:
 	 */
 	int mix(int16 *data, uint len);
 
+	/**
+	 * Mixes the channel's samples into a submix at the channel's own rate,
+	 * applying the channel volume and balance.
+	 *
+	 * @param sum     buffer to add the samples to, in the output layout
+	 * @param input   scratch buffer for at least 2 * frames samples
+	 * @param frames  number of sample frames to mix
+	 * @return number of sample frames mixed
+	 */
+	uint mixSubmix(int32 *sum, int16 *input, uint frames);
+
 	/**
 	 * Queries whether the channel is still playing or not.
 	 */
-	bool isFinished() const { return _stream->endOfStream() && !_converter->needsDraining(); }
+	bool isFinished() const { return _stream->endOfStream() && (!_converter || !_converter->needsDraining()); }
+
+	/**
+	 * Queries whether the channel is mixed as part of a submix group.
+	 */
+	bool isInSubmixGroup() const { return _submixGroup != nullptr; }
+
+	/**
+	 * Lets the channel be mixed by the given submix group, instead of
+	 * resampling it on its own.
+	 */
+	void setSubmixGroup(SubmixGroup *group);
 
 	/**
 	 * Queries whether the channel is a permanent channel.
@@ -190,6 +215,61 @@ private:
 
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
+
+	bool _reverseStereo;
+	SubmixGroup *_submixGroup;
+	uint32 _submixRemainder;
+
+	void leaveSubmixGroup();
+};
+
+/**
+ * A group of channels playing at the same rate.
+ *
+ * The channels are summed up at their own rate, with their volume and
+ * balance already applied, and the sum is resampled to the output rate
+ * once. This way the cost of resampling depends on the number of different
+ * rates, rather than on the number of channels.
+ */
+class SubmixGroup : public AudioStream {
+public:
+	SubmixGroup(Mixer *mixer, uint rate);
+	~SubmixGroup();
+
+	void addChannel(Channel *chan) { _channels.push_back(chan); }
+	void removeChannel(Channel *chan);
+
+	/**
+	 * Queries whether the group can be deleted.
+	 */
+	bool isUnused() const { return _channels.empty() && !_converter->needsDraining(); }
+
+	/**
+	 * Mixes the resampled sum of all channels into the given buffer.
+	 *
+	 * @see Channel::mix()
+	 */
+	int mix(int16 *data, uint len);
+
+	// AudioStream API, used by the rate converter
+	int readBuffer(int16 *buffer, const int numSamples) override;
+	bool isStereo() const override { return _stereo; }
+	int getRate() const override { return _rate; }
+	bool endOfData() const override;
+
+private:
+	enum {
+		CHUNK_FRAMES = 512
+	};
+
+	const uint _rate;
+	const bool _stereo;
+
+	Common::Array<Channel *> _channels;
+	RateConverter *_converter;
+
+	int32 _sum[CHUNK_FRAMES * 2];
+	int16 _input[CHUNK_FRAMES * 2];
 };
 
 #pragma mark -
@@ -197,7 +277,7 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings(), _submixing(false) {
 
 	assert(sampleRate > 0);
 
@@ -208,6 +288,9 @@ MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
 MixerImpl::~MixerImpl() {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	for (uint i = 0; i < _submixGroups.size(); i++)
+		delete _submixGroups[i];
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -228,6 +311,16 @@ uint MixerImpl::getOutputBufSize() const {
 	return _outBufSize;
 }
 
+void MixerImpl::setSubmixing(bool enable) {
+	Common::StackLock lock(_mutex);
+	_submixing = enable;
+}
+
+bool MixerImpl::getSubmixing() const {
+	Common::StackLock lock(_mutex);
+	return _submixing;
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
@@ -295,12 +388,29 @@ void MixerImpl::playStream(
 	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
+
+	// Channels which need resampling share it with others at the same rate
+	if (_submixing && (uint)stream->getRate() != _sampleRate)
+		chan->setSubmixGroup(getSubmixGroup(stream->getRate()));
+
 	insertChannel(handle, chan);
 }
 
+SubmixGroup *MixerImpl::getSubmixGroup(uint rate) {
+	for (uint i = 0; i < _submixGroups.size(); i++) {
+		if ((uint)_submixGroups[i]->getRate() == rate)
+			return _submixGroups[i];
+	}
+
+	SubmixGroup *group = new SubmixGroup(this, rate);
+	_submixGroups.push_back(group);
+	return group;
+}
+
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
+	PROFILE_ZONE("MixerImpl::mixCallback");
 	Common::StackLock lock(_mutex);
 
 	int16 *buf = (int16 *)samples;
@@ -327,7 +437,7 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 			if (_channels[i]->isFinished()) {
 				delete _channels[i];
 				_channels[i] = nullptr;
-			} else if (!_channels[i]->isPaused()) {
+			} else if (!_channels[i]->isPaused() && !_channels[i]->isInSubmixGroup()) {
 				tmp = _channels[i]->mix(buf, len);
 
 				if (tmp > res)
@@ -335,6 +445,20 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 			}
 		}
 
+	// mix the submix groups
+	for (uint i = 0; i < _submixGroups.size(); ) {
+		if (_submixGroups[i]->isUnused()) {
+			delete _submixGroups[i];
+			_submixGroups.remove_at(i);
+			continue;
+		}
+
+		tmp = _submixGroups[i]->mix(buf, len);
+		if (tmp > res)
+			res = tmp;
+		i++;
+	}
+
 	return res;
 }
 
@@ -577,7 +701,8 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
 	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
 	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
-	  _stream(stream, autofreeStream) {
+	  _stream(stream, autofreeStream), _reverseStereo(reverseStereo), _submixGroup(nullptr),
+	  _submixRemainder(0) {
 	assert(mixer);
 	assert(stream);
 
@@ -586,7 +711,28 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 }
 
 Channel::~Channel() {
+	if (_submixGroup)
+		_submixGroup->removeChannel(this);
+
+	delete _converter;
+}
+
+void Channel::setSubmixGroup(SubmixGroup *group) {
+	assert(!_submixGroup);
+
+	// The group does the resampling from now on
 	delete _converter;
+	_converter = nullptr;
+
+	_submixGroup = group;
+	_submixGroup->addChannel(this);
+}
+
+void Channel::leaveSubmixGroup() {
+	_converter = makeRateConverter(_submixGroup->getRate(), _mixer->getOutputRate(), _stream->isStereo(), _mixer->getOutputStereo(), _reverseStereo);
+
+	_submixGroup->removeChannel(this);
+	_submixGroup = nullptr;
 }
 
 void Channel::setVolume(const byte volume) {
@@ -608,11 +754,22 @@ int8 Channel::getBalance() {
 }
 
 void Channel::setRate(uint32 rate) {
+	// A channel with its own rate can't be mixed with the others anymore
+	if (_submixGroup) {
+		if (rate == (uint32)_submixGroup->getRate())
+			return;
+
+		leaveSubmixGroup();
+	}
+
 	if (_converter)
 		_converter->setInputRate(rate);
 }
 
 uint32 Channel::getRate() {
+	if (_submixGroup)
+		return _submixGroup->getRate();
+
 	if (_converter)
 		return _converter->getInputRate();
 	
@@ -707,6 +864,52 @@ void Channel::loop() {
 	}
 }
 
+uint Channel::mixSubmix(int32 *sum, int16 *input, uint frames) {
+	assert(_stream);
+	assert(_submixGroup);
+
+	if (_stream->endOfData())
+		return 0;
+
+	const bool inStereo = _stream->isStereo();
+	const bool outStereo = _mixer->getOutputStereo();
+
+	const int samples = _stream->readBuffer(input, frames * (inStereo ? 2 : 1));
+	if (samples <= 0)
+		return 0;
+
+	const uint framesRead = samples / (inStereo ? 2 : 1);
+
+	// Like the rate converters, only swap the channels of stereo input
+	const int left = (_reverseStereo && inStereo) ? 1 : 0;
+	const int right = left ^ 1;
+
+	for (uint i = 0; i < framesRead; i++) {
+		const int inL = inStereo ? input[i * 2] : input[i];
+		const int inR = inStereo ? input[i * 2 + 1] : inL;
+
+		const int outL = (inL * (int)_volL) / Mixer::kMaxMixerVolume;
+		const int outR = (inR * (int)_volR) / Mixer::kMaxMixerVolume;
+
+		if (outStereo) {
+			sum[i * 2 + left] += outL;
+			sum[i * 2 + right] += outR;
+		} else {
+			sum[i] += (outL + outR) / 2;
+		}
+	}
+
+	// Count the played samples at the output rate, like mix() does
+	const uint32 scaled = framesRead * _mixer->getOutputRate() + _submixRemainder;
+	_samplesConsumed = _samplesDecoded;
+	_mixerTimeStamp = g_system->getMillis(true);
+	_pauseTime = 0;
+	_samplesDecoded += scaled / _submixGroup->getRate();
+	_submixRemainder = scaled % _submixGroup->getRate();
+
+	return framesRead;
+}
+
 int Channel::mix(int16 *data, uint len) {
 	assert(_stream);
 	assert(_converter);
@@ -723,4 +926,68 @@ int Channel::mix(int16 *data, uint len) {
 	return res;
 }
 
+#pragma mark -
+#pragma mark --- Submix group implementation ---
+#pragma mark -
+
+SubmixGroup::SubmixGroup(Mixer *mixer, uint rate) : _rate(rate), _stereo(mixer->getOutputStereo()) {
+	_converter = makeRateConverter(rate, mixer->getOutputRate(), _stereo, _stereo, false);
+}
+
+SubmixGroup::~SubmixGroup() {
+	delete _converter;
+}
+
+void SubmixGroup::removeChannel(Channel *chan) {
+	for (uint i = 0; i < _channels.size(); i++) {
+		if (_channels[i] == chan) {
+			_channels.remove_at(i);
+			return;
+		}
+	}
+}
+
+int SubmixGroup::mix(int16 *data, uint len) {
+	// The volume has already been applied by the channels
+	return _converter->convert(*this, data, len, Mixer::kMaxMixerVolume, Mixer::kMaxMixerVolume);
+}
+
+int SubmixGroup::readBuffer(int16 *buffer, const int numSamples) {
+	const uint channels = _stereo ? 2 : 1;
+	const uint frames = numSamples / channels;
+	uint framesDone = 0;
+
+	while (framesDone < frames) {
+		const uint chunkFrames = MIN<uint>(frames - framesDone, CHUNK_FRAMES);
+		uint framesMixed = 0;
+
+		memset(_sum, 0, chunkFrames * channels * sizeof(int32));
+
+		for (uint i = 0; i < _channels.size(); i++) {
+			if (!_channels[i]->isPaused())
+				framesMixed = MAX(framesMixed, _channels[i]->mixSubmix(_sum, _input, chunkFrames));
+		}
+
+		// Channels which ended early simply added silence
+		int16 *out = buffer + framesDone * channels;
+		for (uint i = 0; i < framesMixed * channels; i++)
+			out[i] = (int16)CLIP<int32>(_sum[i], ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+
+		framesDone += framesMixed;
+		if (framesMixed < chunkFrames)
+			break;
+	}
+
+	return framesDone * channels;
+}
+
+bool SubmixGroup::endOfData() const {
+	for (uint i = 0; i < _channels.size(); i++) {
+		if (!_channels[i]->isPaused() && !_channels[i]->isFinished())
+			return false;
+	}
+
+	return true;
+}
+
 } // End of namespace Audio
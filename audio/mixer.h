@@ -345,6 +345,25 @@ public:
 	 * @return The number of samples processed at each audio callback.
 	 */
 	virtual uint getOutputBufSize() const = 0;
+
+	/**
+	 * Enable or disable submixing. When it is enabled, the channels which
+	 * play at the same rate are summed up at that rate, and resampled to the
+	 * output rate together. This is faster with many channels, but the sum
+	 * is clipped before resampling, and channels can start and end up to
+	 * 512 samples late.
+	 *
+	 * Submixing is disabled by default. It only affects the channels
+	 * started afterwards.
+	 *
+	 * @param enable  Whether channels are submixed.
+	 */
+	virtual void setSubmixing(bool enable) = 0;
+
+	/**
+	 * Check whether submixing is enabled, see setSubmixing().
+	 */
+	virtual bool getSubmixing() const = 0;
 };
 
 /** @} */
@@ -23,11 +23,14 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
 
 namespace Audio {
 
+class SubmixGroup;
+
 /**
  * @defgroup audio_mixer_intern Mixer implementation
  * @ingroup audio
@@ -79,6 +82,13 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	/**
+	 * Channels playing at the same rate are summed up at that rate and
+	 * resampled together, see SubmixGroup.
+	 */
+	Common::Array<SubmixGroup *> _submixGroups;
+	bool _submixing;
+
 
 public:
 
@@ -136,8 +146,12 @@ public:
 	virtual bool getOutputStereo() const;
 	virtual uint getOutputBufSize() const;
 
+	virtual void setSubmixing(bool enable);
+	virtual bool getSubmixing() const;
+
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
+	SubmixGroup *getSubmixGroup(uint rate);
 
 public:
 	/**
@@ -1183,45 +1183,50 @@ void ModXmS3mStream::resample(const Channel &channel, int *mixBuf, int offset, i
 		loopEnd = sample->loopStart + loopLen;
 		outIdx = offset * 2;
 		outEnd = (offset + count) * 2;
-		if (_interpolation) {
-			while (outIdx < outEnd) {
-				if (samIdx >= loopEnd) {
-					if (loopLen > 1) {
-						while (samIdx >= loopEnd) {
-							samIdx -= loopLen;
-						}
-					} else {
-						break;
+		while (outIdx < outEnd) {
+			if (samIdx >= loopEnd) {
+				if (loopLen > 1) {
+					while (samIdx >= loopEnd) {
+						samIdx -= loopLen;
 					}
+				} else {
+					break;
 				}
-				c = sampleData[samIdx];
-				m = sampleData[samIdx + 1] - c;
-				y = ((m * samFra) >> FP_SHIFT) + c;
-				mixBuf[outIdx++] += (y * lGain) >> FP_SHIFT;
-				mixBuf[outIdx++] += (y * rGain) >> FP_SHIFT;
-				samFra += step;
-				samIdx += samFra >> FP_SHIFT;
-				samFra &= FP_MASK;
 			}
-		} else {
-			while (outIdx < outEnd) {
-				if (samIdx >= loopEnd) {
-					if (loopLen > 1) {
-						while (samIdx >= loopEnd) {
-							samIdx -= loopLen;
-						}
-					} else {
-						break;
-					}
+			if (!_interpolation && samIdx < 0)
+				samIdx = 0;
+
+			// Mix everything up to the loop end at once. With a negative
+			// step, the position has to be clamped for every sample.
+			int span = (outEnd - outIdx) / 2;
+			if (step > 0) {
+				const int64 left = ((int64)(loopEnd - samIdx) << FP_SHIFT) - samFra;
+				span = (int)MIN<int64>(span, (left + step - 1) / step);
+			} else if (step < 0 && !_interpolation) {
+				span = 1;
+			}
+
+			const int spanEnd = outIdx + span * 2;
+			if (_interpolation) {
+				while (outIdx < spanEnd) {
+					c = sampleData[samIdx];
+					m = sampleData[samIdx + 1] - c;
+					y = ((m * samFra) >> FP_SHIFT) + c;
+					mixBuf[outIdx++] += (y * lGain) >> FP_SHIFT;
+					mixBuf[outIdx++] += (y * rGain) >> FP_SHIFT;
+					samFra += step;
+					samIdx += samFra >> FP_SHIFT;
+					samFra &= FP_MASK;
+				}
+			} else {
+				while (outIdx < spanEnd) {
+					y = sampleData[samIdx];
+					mixBuf[outIdx++] += (y * lGain) >> FP_SHIFT;
+					mixBuf[outIdx++] += (y * rGain) >> FP_SHIFT;
+					samFra += step;
+					samIdx += samFra >> FP_SHIFT;
+					samFra &= FP_MASK;
 				}
-				if (samIdx < 0)
-					samIdx = 0;
-				y = sampleData[samIdx];
-				mixBuf[outIdx++] += (y * lGain) >> FP_SHIFT;
-				mixBuf[outIdx++] += (y * rGain) >> FP_SHIFT;
-				samFra += step;
-				samIdx += samFra >> FP_SHIFT;
-				samFra &= FP_MASK;
 			}
 		}
 	}
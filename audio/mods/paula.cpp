@@ -157,11 +157,13 @@ inline int32 filter(int32 input, Paula::FilterState &state, int voice) {
 	return CLIP<int32>(state.ledFilter ? ledOutput : normalOutput, -32768, 32767);
 }
 
-template<bool stereo>
-inline int mixBuffer(int16 *&buf, const int8 *data, Paula::Offset &offset, frac_t rate, int neededSamples, uint bufSize, byte volume, byte panning, Paula::FilterState &filterState, int voice) {
-	int samples;
-	for (samples = 0; samples < neededSamples && offset.int_off < bufSize; ++samples) {
-		const int32 tmp = filter(((int32) data[offset.int_off]) * volume, filterState, voice);
+template<bool stereo, bool filtered>
+inline void mixSpan(int16 *&buf, const int8 *data, uint64 &pos, frac_t rate, int count, byte volume, byte panning, Paula::FilterState &filterState, int voice) {
+	for (int i = 0; i < count; ++i) {
+		int32 tmp = ((int32) data[pos >> FRAC_BITS]) * volume;
+		if (filtered)
+			tmp = filter(tmp, filterState, voice);
+
 		if (stereo) {
 			*buf++ += (tmp * (255 - panning)) >> 7;
 			*buf++ += (tmp * (panning)) >> 7;
@@ -169,13 +171,31 @@ inline int mixBuffer(int16 *&buf, const int8 *data, Paula::Offset &offset, frac_
 			*buf++ += tmp;
 
 		// Step to next source sample
-		offset.rem_off += rate;
-		if (offset.rem_off >= (frac_t)FRAC_ONE) {
-			offset.int_off += fracToInt(offset.rem_off);
-			offset.rem_off &= FRAC_LO_MASK;
-		}
+		pos += rate;
 	}
+}
+
+template<bool stereo>
+inline int mixBuffer(int16 *&buf, const int8 *data, Paula::Offset &offset, frac_t rate, int neededSamples, uint bufSize, byte volume, byte panning, Paula::FilterState &filterState, int voice) {
+	// Work on the offset as a single fixed point number, and compute how
+	// many samples fit before the end of the buffer is reached. The span
+	// is then mixed without checking the offset for every sample.
+	uint64 pos = ((uint64)offset.int_off << FRAC_BITS) + offset.rem_off;
+	const uint64 end = (uint64)bufSize << FRAC_BITS;
+	if (pos >= end)
+		return 0;
+
+	int samples = neededSamples;
+	if (rate > 0)
+		samples = (int)MIN<uint64>(samples, (end - pos + rate - 1) / rate);
+
+	if (filterState.mode == Paula::kFilterModeNone)
+		mixSpan<stereo, false>(buf, data, pos, rate, samples, volume, panning, filterState, voice);
+	else
+		mixSpan<stereo, true>(buf, data, pos, rate, samples, volume, panning, filterState, voice);
 
+	offset.int_off = (uint)(pos >> FRAC_BITS);
+	offset.rem_off = (frac_t)(pos & FRAC_LO_MASK);
 	return samples;
 }
 
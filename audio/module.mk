@@ -3,6 +3,7 @@ MODULE := audio
 MODULE_OBJS := \
 	adlib.o \
 	adlib_ms.o \
+	audiocache.o \
 	audiostream.o \
 	casio.o \
 	cms.o \
@@ -23,6 +24,7 @@ MODULE_OBJS := \
 	musicplugin.o \
 	null.o \
 	rate.o \
+	rendercache.o \
 	timestamp.o \
 	decoders/3do.o \
 	decoders/aac.o \
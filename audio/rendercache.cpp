@@ -0,0 +1,558 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/rendercache.h"
+
+#include "common/config-manager.h"
+#include "common/crc.h"
+#include "common/debug.h"
+#include "common/endian.h"
+#include "common/hash-str.h"
+#include "common/savefile.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "common/timer.h"
+
+namespace Audio {
+
+enum {
+	kRenderCacheVersion = 1,
+	// Songs are recorded for at most this many seconds, since looping
+	// music would otherwise be recorded forever.
+	kMaxRecordingLength = 10 * 60,
+	// No new recordings are made once all of them take this many bytes
+	kMaxCacheSize = 256 * 1024 * 1024
+};
+
+Common::Mutex *RenderCache::_cachesMutex = nullptr;
+Common::Array<RenderCache *> *RenderCache::_caches = nullptr;
+Common::TimerManager *RenderCache::_timerManager = nullptr;
+
+Common::Mutex *RenderCache::_sizeMutex = nullptr;
+uint32 RenderCache::_cacheSize = 0;
+bool RenderCache::_cacheSizeKnown = false;
+
+RenderCache::RenderCache(const Common::String &emulator, int rate, bool stereo)
+	: _emulator(emulator), _rate(rate), _channels(stereo ? 2 : 1),
+	  _inFile(nullptr), _outFile(nullptr), _state(kStateIdle), _startState(kStateIdle), _queueStart(0), _queueCount(0),
+	  _blockPos(0), _inputHash(0), _totalFrames(0), _maxFrames(0),
+	  _complete(false), _inEnded(false), _discard(false) {
+	for (int i = 0; i < kQueueBlocks; i++) {
+		_blocks[i].hash = 0;
+		_blocks[i].frames = 0;
+		_blocks[i].samples = new int16[kBlockFrames * _channels];
+	}
+
+	registerCache(this);
+}
+
+RenderCache::~RenderCache() {
+	// Waits for the timer callback to finish with this cache
+	unregisterCache(this);
+
+	stopSong();
+
+	for (int i = 0; i < kQueueBlocks; i++)
+		delete[] _blocks[i].samples;
+}
+
+bool RenderCache::isEnabled() {
+	return ConfMan.hasKey("music_render_cache") && ConfMan.getBool("music_render_cache");
+}
+
+uint32 RenderCache::hashSongData(const byte *data, uint32 size) {
+	Common::CRC32 crc;
+	return crc.crcFast(data, size);
+}
+
+void RenderCache::startSong(const Common::String &song) {
+	stopSong();
+
+	Common::StackLock ioLock(_ioMutex);
+
+	const Common::String key = Common::String::format("%s/%s/%d/%d", _emulator.c_str(), song.c_str(), _rate, _channels);
+	{
+		Common::StackLock lock(_mutex);
+		_key = key;
+	}
+
+	// Hidden files are not synced to the cloud
+	_fileName = Common::String::format(".rendercache-%08x.rnd", Common::hashit(key.c_str()));
+
+	Common::SeekableReadStream *file = openRecording(_fileName);
+	if (file && startReplaying(file))
+		return;
+
+	delete file;
+	_inFile = nullptr;
+	startRecording();
+}
+
+void RenderCache::stopSong() {
+	Common::StackLock ioLock(_ioMutex);
+
+	{
+		Common::StackLock lock(_mutex);
+
+		// Queue the last, partial block
+		if (_state == kStateRecording && _blockPos && _queueCount < kQueueBlocks) {
+			Block &block = _blocks[(_queueStart + _queueCount) % kQueueBlocks];
+			block.hash = _inputHash;
+			block.frames = _blockPos;
+			_queueCount++;
+			_totalFrames += _blockPos;
+		}
+
+		// The audio thread does not touch the queue anymore from here on
+		_state = kStateIdle;
+	}
+
+	bool written = false;
+	if (_outFile) {
+		writeQueued();
+
+		if (!_discard && _complete) {
+			// An empty block marks a recording of the maximum length
+			_outFile->writeUint32LE(0);
+			_outFile->writeUint32LE(0);
+		}
+
+		_outFile->finalize();
+		if (_outFile->err()) {
+			warning("RenderCache: Failed to write '%s'", _fileName.c_str());
+			_discard = true;
+		}
+
+		// Too short recordings are not worth keeping
+		if (_totalFrames < kBlockFrames)
+			_discard = true;
+
+		delete _outFile;
+		_outFile = nullptr;
+		written = !_discard;
+	}
+
+	delete _inFile;
+	_inFile = nullptr;
+
+	if (_discard)
+		removeFile(_fileName);
+	else if (written)
+		updateCacheSize(0, getRecordingSize(_fileName));
+
+	Common::StackLock lock(_mutex);
+	_queueStart = _queueCount = 0;
+	_complete = _inEnded = _discard = false;
+}
+
+bool RenderCache::onTick() {
+	Common::StackLock lock(_mutex);
+
+	if (_state != kStateStarting)
+		return false;
+
+	// Input sent before the first tick counts as sent at its start
+	_state = _startState;
+	return true;
+}
+
+void RenderCache::addInput(uint32 value) {
+	Common::StackLock lock(_mutex);
+
+	if (_state == kStateStarting || _state == kStateRecording || _state == kStateReplaying)
+		hashInput(value);
+}
+
+void RenderCache::addInput(const byte *data, uint32 length) {
+	Common::StackLock lock(_mutex);
+
+	if (_state != kStateStarting && _state != kStateRecording && _state != kStateReplaying)
+		return;
+
+	hashInput(length);
+
+	for (uint32 i = 0; i < length; i += 4) {
+		uint32 value = 0;
+		for (uint32 j = i; j < MIN<uint32>(i + 4, length); j++)
+			value = (value << 8) | data[j];
+		hashInput(value);
+	}
+}
+
+int RenderCache::read(int16 *buffer, int frames) {
+	Common::StackLock lock(_mutex);
+
+	int done = 0;
+	while (done < frames && _state == kStateReplaying) {
+		if (!_queueCount) {
+			if (!_inEnded) {
+				debug(3, "RenderCache: Reading '%s' did not keep up after %d samples", _key.c_str(), _totalFrames);
+			} else if (!_complete) {
+				// The song is played longer than it was recorded
+				debug(3, "RenderCache: Recording of '%s' ends after %d samples", _key.c_str(), _totalFrames);
+				_discard = true;
+			}
+
+			_state = kStateLive;
+			break;
+		}
+
+		Block &block = _blocks[_queueStart];
+		const uint32 count = MIN<uint32>(frames - done, block.frames - _blockPos);
+
+		memcpy(buffer + done * _channels, block.samples + _blockPos * _channels, count * _channels * sizeof(int16));
+		_blockPos += count;
+		done += count;
+
+		if (_blockPos == block.frames) {
+			if (_inputHash != block.hash) {
+				debug(3, "RenderCache: Input of '%s' differs after %d samples", _key.c_str(), _totalFrames + block.frames);
+				_state = kStateLive;
+			}
+
+			_totalFrames += block.frames;
+			_queueStart = (_queueStart + 1) % kQueueBlocks;
+			_queueCount--;
+			startBlock();
+		}
+	}
+
+	return done;
+}
+
+void RenderCache::write(const int16 *buffer, int frames) {
+	Common::StackLock lock(_mutex);
+
+	while (frames > 0 && _state == kStateRecording) {
+		if (!_blockPos && _queueCount == kQueueBlocks) {
+			debug(3, "RenderCache: Writing '%s' did not keep up after %d samples", _key.c_str(), _totalFrames);
+			_discard = true;
+			_state = kStateLive;
+			break;
+		}
+
+		Block &block = _blocks[(_queueStart + _queueCount) % kQueueBlocks];
+		const uint32 count = MIN<uint32>(frames, kBlockFrames - _blockPos);
+
+		memcpy(block.samples + _blockPos * _channels, buffer, count * _channels * sizeof(int16));
+		_blockPos += count;
+		buffer += count * _channels;
+		frames -= count;
+
+		if (_blockPos == kBlockFrames) {
+			block.hash = _inputHash;
+			block.frames = _blockPos;
+			_queueCount++;
+			_totalFrames += _blockPos;
+			startBlock();
+
+			if (_totalFrames >= _maxFrames) {
+				// Keep what has been recorded so far
+				_complete = _totalFrames >= (uint32)_rate * kMaxRecordingLength;
+				_state = kStateLive;
+			}
+		}
+	}
+}
+
+Common::SeekableReadStream *RenderCache::openRecording(const Common::String &name) {
+	Common::SaveFileManager *saveMan = g_system ? g_system->getSavefileManager() : nullptr;
+	return saveMan ? saveMan->openForLoading(name) : nullptr;
+}
+
+Common::WriteStream *RenderCache::createRecording(const Common::String &name) {
+	Common::SaveFileManager *saveMan = g_system ? g_system->getSavefileManager() : nullptr;
+	return saveMan ? saveMan->openForSaving(name) : nullptr;
+}
+
+void RenderCache::removeRecording(const Common::String &name) {
+	Common::SaveFileManager *saveMan = g_system ? g_system->getSavefileManager() : nullptr;
+	if (saveMan)
+		saveMan->removeSavefile(name);
+}
+
+Common::StringArray RenderCache::listRecordings() {
+	Common::SaveFileManager *saveMan = g_system ? g_system->getSavefileManager() : nullptr;
+	return saveMan ? saveMan->listSavefiles(".rendercache-*.rnd") : Common::StringArray();
+}
+
+uint32 RenderCache::getRecordingSize(const Common::String &name) {
+	Common::SaveFileManager *saveMan = g_system ? g_system->getSavefileManager() : nullptr;
+	Common::InSaveFile *file = saveMan ? saveMan->openRawFile(name) : nullptr;
+	const uint32 size = file ? file->size() : 0;
+	delete file;
+	return size;
+}
+
+uint32 RenderCache::getCacheSize() {
+	Common::StackLock lock(*_sizeMutex);
+
+	if (!_cacheSizeKnown) {
+		const Common::StringArray names = listRecordings();
+		for (uint i = 0; i < names.size(); i++)
+			_cacheSize += getRecordingSize(names[i]);
+		_cacheSizeKnown = true;
+	}
+
+	return _cacheSize;
+}
+
+void RenderCache::updateCacheSize(uint32 removedSize, uint32 addedSize) {
+	Common::StackLock lock(*_sizeMutex);
+
+	// Until the recordings are listed, the change is included in the list
+	if (_cacheSizeKnown)
+		_cacheSize = _cacheSize - MIN(_cacheSize, removedSize) + addedSize;
+}
+
+void RenderCache::removeFile(const Common::String &name) {
+	const uint32 size = getRecordingSize(name);
+	if (!size)
+		return;
+
+	removeRecording(name);
+	updateCacheSize(size, 0);
+}
+
+void RenderCache::timerProc(void *refCon) {
+	Common::StackLock lock(*_cachesMutex);
+
+	for (uint i = 0; i < _caches->size(); i++)
+		(*_caches)[i]->update();
+}
+
+void RenderCache::registerCache(RenderCache *cache) {
+	if (!_cachesMutex) {
+		_cachesMutex = new Common::Mutex();
+		_caches = new Common::Array<RenderCache *>();
+		_sizeMutex = new Common::Mutex();
+	}
+
+	Common::TimerManager *timer = g_system ? g_system->getTimerManager() : nullptr;
+
+	bool installTimer;
+	{
+		Common::StackLock lock(*_cachesMutex);
+		_caches->push_back(cache);
+
+		// Reinstall the callback in case the backend was switched
+		installTimer = timer && _timerManager != timer;
+		if (timer)
+			_timerManager = timer;
+	}
+
+	// The list lock must not be held here, since the timer manager's lock
+	// is held while the callback runs
+	if (installTimer)
+		timer->installTimerProc(&timerProc, 10000, nullptr, "RenderCache");
+}
+
+void RenderCache::unregisterCache(RenderCache *cache) {
+	Common::StackLock lock(*_cachesMutex);
+
+	for (uint i = 0; i < _caches->size(); i++) {
+		if ((*_caches)[i] == cache) {
+			_caches->remove_at(i);
+			break;
+		}
+	}
+}
+
+void RenderCache::update() {
+	Common::StackLock ioLock(_ioMutex);
+
+	if (_outFile)
+		writeQueued();
+	else if (_inFile)
+		readAhead();
+}
+
+bool RenderCache::startReplaying(Common::SeekableReadStream *file) {
+	if (file->readUint32BE() != MKTAG('R', 'N', 'D', 'C') || file->readUint32LE() != kRenderCacheVersion)
+		return false;
+
+	// Make sure the file is not for another song with the same hash
+	const uint32 keySize = file->readUint32LE();
+	if (keySize != _key.size() || file->readString(0, keySize) != _key)
+		return false;
+
+	// Fill the queue, so that playback does not have to wait for the timer
+	_inFile = file;
+	readAhead();
+
+	Common::StackLock lock(_mutex);
+	if (!_queueCount) {
+		_inFile = nullptr;
+		_complete = _inEnded = false;
+		return false;
+	}
+
+	debug(3, "RenderCache: Replaying '%s'", _key.c_str());
+
+	_state = kStateStarting;
+	_startState = kStateReplaying;
+	_totalFrames = 0;
+	startBlock();
+	return true;
+}
+
+void RenderCache::startRecording() {
+	// An outdated or broken recording is replaced, so it does not count
+	removeFile(_fileName);
+
+	// Recordings are compressed, so this is only an upper bound of their
+	// size on disk
+	const uint32 cacheSize = getCacheSize();
+	const uint32 maxFrames = cacheSize < kMaxCacheSize ? (kMaxCacheSize - cacheSize) / (_channels * sizeof(int16)) : 0;
+	if (maxFrames < kBlockFrames) {
+		debug(3, "RenderCache: Not recording '%s', the cache is full", _key.c_str());
+		Common::StackLock lock(_mutex);
+		_state = kStateLive;
+		return;
+	}
+
+	_outFile = createRecording(_fileName);
+	if (!_outFile) {
+		Common::StackLock lock(_mutex);
+		_state = kStateLive;
+		return;
+	}
+
+	_outFile->writeUint32BE(MKTAG('R', 'N', 'D', 'C'));
+	_outFile->writeUint32LE(kRenderCacheVersion);
+	_outFile->writeUint32LE(_key.size());
+	_outFile->writeString(_key);
+
+	debug(3, "RenderCache: Recording '%s'", _key.c_str());
+
+	Common::StackLock lock(_mutex);
+	_state = kStateStarting;
+	_startState = kStateRecording;
+	_totalFrames = 0;
+	_maxFrames = MIN<uint32>(maxFrames, _rate * kMaxRecordingLength);
+	startBlock();
+}
+
+void RenderCache::readAhead() {
+	for (;;) {
+		uint32 next;
+		{
+			Common::StackLock lock(_mutex);
+			if (_inEnded || _queueCount == kQueueBlocks)
+				return;
+			next = (_queueStart + _queueCount) % kQueueBlocks;
+		}
+
+		// The audio thread does not touch the blocks after the queue, so
+		// reading into them does not need the lock
+		const int frames = readBlock(_blocks[next]);
+
+		Common::StackLock lock(_mutex);
+		if (frames > 0) {
+			_queueCount++;
+		} else {
+			_complete = (frames == 0);
+			_inEnded = true;
+		}
+	}
+}
+
+void RenderCache::writeQueued() {
+	for (;;) {
+		Block *block;
+		{
+			Common::StackLock lock(_mutex);
+			if (_discard || !_queueCount)
+				return;
+			block = &_blocks[_queueStart];
+		}
+
+		// The audio thread does not touch queued blocks, so writing them
+		// does not need the lock
+		writeBlock(*block);
+
+		Common::StackLock lock(_mutex);
+		if (_outFile->err()) {
+			_discard = true;
+			if (_state == kStateRecording)
+				_state = kStateLive;
+		}
+
+		_queueStart = (_queueStart + 1) % kQueueBlocks;
+		_queueCount--;
+	}
+}
+
+int RenderCache::readBlock(Block &block) {
+	block.hash = _inFile->readUint32LE();
+	block.frames = _inFile->readUint32LE();
+
+	if (_inFile->eos() || _inFile->err() || block.frames > kBlockFrames)
+		return -1;
+
+	// The end of a recording of the maximum length
+	if (!block.frames)
+		return 0;
+
+	const uint32 samples = block.frames * _channels;
+	if (_inFile->read(block.samples, samples * sizeof(int16)) != samples * sizeof(int16))
+		return -1;
+
+#ifdef SCUMM_BIG_ENDIAN
+	for (uint32 i = 0; i < samples; i++)
+		block.samples[i] = FROM_LE_16(block.samples[i]);
+#endif
+
+	return block.frames;
+}
+
+void RenderCache::writeBlock(Block &block) {
+	_outFile->writeUint32LE(block.hash);
+	_outFile->writeUint32LE(block.frames);
+
+	const uint32 samples = block.frames * _channels;
+
+#ifdef SCUMM_BIG_ENDIAN
+	for (uint32 i = 0; i < samples; i++)
+		block.samples[i] = TO_LE_16(block.samples[i]);
+#endif
+
+	_outFile->write(block.samples, samples * sizeof(int16));
+}
+
+void RenderCache::hashInput(uint32 value) {
+	// FNV-1a over the position and the input, so the timing of the input
+	// matters as well
+	const uint32 words[2] = { _blockPos, value };
+	for (int i = 0; i < 2; i++) {
+		for (int j = 0; j < 32; j += 8) {
+			_inputHash ^= (words[i] >> j) & 0xFF;
+			_inputHash *= 16777619;
+		}
+	}
+}
+
+void RenderCache::startBlock() {
+	_blockPos = 0;
+	_inputHash = 2166136261u;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,294 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RENDERCACHE_H
+#define AUDIO_RENDERCACHE_H
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/str.h"
+#include "common/str-array.h"
+#include "common/types.h"
+
+namespace Common {
+class SeekableReadStream;
+class TimerManager;
+class WriteStream;
+}
+
+namespace Audio {
+
+/**
+ * @defgroup audio_rendercache Render cache for emulated music
+ * @ingroup audio
+ *
+ * @brief Disk cache for the output of music emulators.
+ * @{
+ */
+
+/**
+ * A disk cache for the output of a music emulator, like an OPL emulator or
+ * MUNT.
+ *
+ * Emulating music hardware takes a lot of time, but the output only depends
+ * on what the driver sends to the emulator and when it does so. The cache
+ * records the output of a song the first time it is played, and plays it
+ * back from disk the next time the emulator gets the same input.
+ *
+ * The output is split into blocks. For every block, the cache keeps a hash
+ * of all input sent to the emulator during it. When playing back, the hash
+ * of the current input is compared with the recorded one at the end of each
+ * block. When the input differs, for example because an engine changed the
+ * music dynamically, the cache falls back to the emulator for the rest of
+ * the song. Since the emulator did not render the blocks played from the
+ * cache, notes playing at that point can sound off until they are restarted.
+ *
+ * Songs are started by the engine, see MidiDriver::PROP_RENDER_CACHE_SONG
+ * and OPL::OPL::setRenderCacheSong(). They should only be started when the
+ * output of the emulator does not depend on what was played before, e.g.
+ * right after the driver has been set up for the song. The cache is only
+ * used when the "music_render_cache" config option is enabled.
+ *
+ * The emulator has to call addInput() for everything sent to it, and has to
+ * pass its output through read() and write(), see MidiDriver_Emulated. The
+ * input only matches when it is sent on the same samples every time, so a
+ * song starts at the first timer tick of the driver after startSong(), and
+ * the emulator has to call onTick() at every tick.
+ *
+ * read() and write() are called from the audio thread, so they only copy
+ * blocks from and to a small queue in memory. A timer callback shared by
+ * all caches reads the blocks ahead from disk and writes the recorded ones.
+ * Files are only opened, finalized and removed by startSong() and
+ * stopSong(), which must not be called from the audio thread.
+ *
+ * A recording which was stopped before reaching the maximum length may not
+ * cover the whole song. When a later replay runs past its end, the emulator
+ * takes over and the recording is discarded, so that the song is recorded
+ * again the next time. Recordings are also discarded when the queue ran
+ * full or writing failed, and no new recordings are made once the cache
+ * exceeds its maximum size.
+ */
+class RenderCache {
+public:
+	/**
+	 * Create a render cache.
+	 *
+	 * @param emulator  Identifies the emulator and all settings which
+	 *                  affect its output.
+	 * @param rate      The sample rate of the emulator.
+	 * @param stereo    Whether the emulator produces stereo samples.
+	 */
+	RenderCache(const Common::String &emulator, int rate, bool stereo);
+	virtual ~RenderCache();
+
+	/**
+	 * Check whether the user enabled the render cache.
+	 */
+	static bool isEnabled();
+
+	/**
+	 * Compute a hash for song data, for use in song keys.
+	 */
+	static uint32 hashSongData(const byte *data, uint32 size);
+
+	/**
+	 * Start caching a song. Any song cached before is stopped. This opens
+	 * the recording of the song and reads its beginning.
+	 *
+	 * @param song  Identifies the song and the driver playing it, e.g.
+	 *              "adlib-1a2b3c4d".
+	 */
+	void startSong(const Common::String &song);
+
+	/**
+	 * Stop caching the current song. This writes the rest of the recording,
+	 * if the song is being recorded.
+	 */
+	void stopSong();
+
+	/**
+	 * Notify the cache of a timer tick of the driver, before the driver's
+	 * timer callback runs.
+	 *
+	 * @return Whether the song started at this tick. The emulator has to
+	 *         count the following ticks from here, so that they fall on the
+	 *         same samples every time the song is played.
+	 */
+	bool onTick();
+
+	/**
+	 * Add input sent to the emulator at the current position.
+	 */
+	void addInput(uint32 value);
+	void addInput(const byte *data, uint32 length);
+
+	/**
+	 * Read the output of the emulator from the cache.
+	 *
+	 * @param buffer  The buffer to fill with samples.
+	 * @param frames  The number of sample frames to read.
+	 * @return The number of frames read. The rest has to be rendered by the
+	 *         emulator and passed to write().
+	 */
+	int read(int16 *buffer, int frames);
+
+	/**
+	 * Pass the output of the emulator to the cache.
+	 *
+	 * @param buffer  The samples rendered by the emulator.
+	 * @param frames  The number of sample frames in the buffer.
+	 */
+	void write(const int16 *buffer, int frames);
+
+protected:
+	/**
+	 * Open a recording for reading.
+	 *
+	 * @return The stream, or nullptr if there is no such recording.
+	 */
+	virtual Common::SeekableReadStream *openRecording(const Common::String &name);
+
+	/**
+	 * Create a recording, replacing any recording with the same name.
+	 *
+	 * @return The stream, or nullptr on failure.
+	 */
+	virtual Common::WriteStream *createRecording(const Common::String &name);
+
+	/**
+	 * Remove a recording.
+	 */
+	virtual void removeRecording(const Common::String &name);
+
+	/**
+	 * List the names of all recordings.
+	 */
+	virtual Common::StringArray listRecordings();
+
+	/**
+	 * Return the size of a recording on disk, in bytes.
+	 *
+	 * @return The size, or 0 if there is no such recording.
+	 */
+	virtual uint32 getRecordingSize(const Common::String &name);
+
+private:
+	enum State {
+		kStateIdle,
+		/** Waiting for the first tick of the song. */
+		kStateStarting,
+		kStateRecording,
+		kStateReplaying,
+		kStateLive
+	};
+
+	enum {
+		kBlockFrames = 4096,
+		/** The number of blocks kept in memory, about 1.5s at 44.1kHz. */
+		kQueueBlocks = 16
+	};
+
+	struct Block {
+		uint32 hash;
+		uint32 frames;
+		int16 *samples;
+	};
+
+	// The timer callback and the list of caches it updates
+	static void timerProc(void *refCon);
+	static void registerCache(RenderCache *cache);
+	static void unregisterCache(RenderCache *cache);
+	void update();
+
+	static Common::Mutex *_cachesMutex;
+	static Common::Array<RenderCache *> *_caches;
+	static Common::TimerManager *_timerManager;
+
+	/**
+	 * The size of all recordings is listed once, and then kept up to date
+	 * as recordings are written and removed.
+	 */
+	uint32 getCacheSize();
+	static void updateCacheSize(uint32 removedSize, uint32 addedSize);
+	void removeFile(const Common::String &name);
+
+	static Common::Mutex *_sizeMutex;
+	static uint32 _cacheSize;
+	static bool _cacheSizeKnown;
+
+	bool startReplaying(Common::SeekableReadStream *file);
+	void startRecording();
+
+	void readAhead();
+	void writeQueued();
+	int readBlock(Block &block);
+	void writeBlock(Block &block);
+
+	void hashInput(uint32 value);
+	void startBlock();
+
+	const Common::String _emulator;
+	const int _rate;
+	const int _channels;
+
+	/**
+	 * Guards the files. It is held by startSong(), stopSong() and the timer
+	 * callback while accessing them, and taken before _mutex.
+	 */
+	Common::Mutex _ioMutex;
+	Common::String _fileName;
+	Common::SeekableReadStream *_inFile;
+	Common::WriteStream *_outFile;
+
+	/** Guards everything shared with the audio thread. */
+	Common::Mutex _mutex;
+
+	State _state;
+	/** The state after the first tick of the song. */
+	State _startState;
+	Common::String _key;
+
+	/**
+	 * The queue of full blocks. When recording, they wait to be written,
+	 * and the block after them is being filled. When replaying, they have
+	 * been read ahead, and the first one is being played.
+	 */
+	Block _blocks[kQueueBlocks];
+	uint32 _queueStart;
+	uint32 _queueCount;
+
+	uint32 _blockPos;
+	uint32 _inputHash;
+	uint32 _totalFrames;
+	uint32 _maxFrames;
+
+	/** Whether the recording covers the maximum length. */
+	bool _complete;
+	/** Whether all blocks of the recording have been read. */
+	bool _inEnded;
+	/** Whether the recording should be removed when the song stops. */
+	bool _discard;
+};
+
+/** @} */
+} // End of namespace Audio
+
+#endif
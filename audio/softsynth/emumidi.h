@@ -25,6 +25,7 @@
 #include "audio/audiostream.h"
 #include "audio/mididrv.h"
 #include "audio/mixer.h"
+#include "audio/rendercache.h"
 
 class MidiDriver_Emulated : public Audio::AudioStream, public MidiDriver {
 protected:
@@ -46,9 +47,35 @@ private:
 protected:
 	int _baseFreq;
 
+	/**
+	 * The render cache used for the output, if it is enabled.
+	 * Subclasses have to add everything they send to the emulator to it.
+	 */
+	Audio::RenderCache *_renderCache;
+
 	virtual void generateSamples(int16 *buf, int len) = 0;
 	virtual void onTimer() {}
 
+	/**
+	 * Called instead of generateSamples() for samples which were read from
+	 * the render cache. Emulators can use this to process pending input.
+	 */
+	virtual void skipSamples(int len) {}
+
+	/**
+	 * Set up the render cache, if it is enabled. Call this from open(),
+	 * once the output rate is known.
+	 *
+	 * @param emulator  Identifies the emulator and its settings.
+	 */
+	void initRenderCache(const Common::String &emulator) {
+		delete _renderCache;
+		_renderCache = nullptr;
+
+		if (Audio::RenderCache::isEnabled())
+			_renderCache = new Audio::RenderCache(emulator, getRate(), isStereo());
+	}
+
 public:
 	MidiDriver_Emulated(Audio::Mixer *mixer) :
 		_mixer(mixer),
@@ -57,7 +84,12 @@ public:
 		_timerParam(0),
 		_nextTick(0),
 		_samplesPerTick(0),
-		_baseFreq(250) {
+		_baseFreq(250),
+		_renderCache(nullptr) {
+	}
+
+	virtual ~MidiDriver_Emulated() {
+		delete _renderCache;
 	}
 
 	// MidiDriver API
@@ -86,6 +118,21 @@ public:
 		return 1000000 / _baseFreq;
 	}
 
+	virtual uint32 property(int prop, uint32 param) {
+		if (prop == PROP_RENDER_CACHE_SONG) {
+			if (!_renderCache)
+				return 0;
+
+			if (param)
+				_renderCache->startSong(Common::String::format("midi-%08x", param));
+			else
+				_renderCache->stopSong();
+			return 1;
+		}
+
+		return 0;
+	}
+
 	// AudioStream API
 	virtual int readBuffer(int16 *data, const int numSamples) {
 		const int stereoFactor = isStereo() ? 2 : 1;
@@ -97,10 +144,21 @@ public:
 			if (step > (_nextTick >> FIXP_SHIFT))
 				step = (_nextTick >> FIXP_SHIFT);
 
-			generateSamples(data, step);
+			int cached = _renderCache ? _renderCache->read(data, step) : 0;
+			if (cached)
+				skipSamples(cached);
+			if (cached < step) {
+				generateSamples(data + cached * stereoFactor, step - cached);
+				if (_renderCache)
+					_renderCache->write(data + cached * stereoFactor, step - cached);
+			}
 
 			_nextTick -= step << FIXP_SHIFT;
 			if (!(_nextTick >> FIXP_SHIFT)) {
+				// Count the ticks of a cached song from its start
+				if (_renderCache && _renderCache->onTick())
+					_nextTick = 0;
+
 				if (_timerProc)
 					(*_timerProc)(_timerParam);
 
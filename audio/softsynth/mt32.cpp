@@ -28,6 +28,7 @@
 #include "audio/musicplugin.h"
 #include "audio/mpu401.h"
 
+#include "common/array.h"
 #include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/error.h"
@@ -37,6 +38,7 @@
 #include "common/util.h"
 #include "common/archive.h"
 #include "common/textconsole.h"
+#include "common/timer.h"
 #include "common/translation.h"
 #include "common/osd_message_queue.h"
 
@@ -118,8 +120,28 @@ private:
 
 	int _outputRate;
 
+	/**
+	 * Render-ahead mode: Munt renders up to this many frames ahead of the
+	 * mixer in a timer callback, and MIDI events are scheduled at the same
+	 * distance ahead. 0 if disabled.
+	 */
+	uint32 _renderAheadFrames;
+	int16 *_renderBuffer;          ///< Ring buffer for the rendered frames
+	uint32 _renderReadPos;         ///< Position of the next frame to play
+	uint32 _renderWritePos;        ///< Position of the next frame to render
+	uint32 _renderFramesBuffered;  ///< Number of rendered frames not played yet
+	uint32 _playedFrames;          ///< Number of frames played since opening
+	Common::Mutex _renderBufferMutex;
+
+	static void renderAheadTimerProc(void *refCon);
+	void renderAhead();
+	int readRenderedFrames(int16 *data, int len);
+	uint32 getEventTimestamp();
+	void playSysexAt(byte device, const byte *data, uint32 length);
+
 protected:
 	void generateSamples(int16 *buf, int len) override;
+	void skipSamples(int len) override;
 
 public:
 	MidiDriver_MT32(Audio::Mixer *mixer);
@@ -155,6 +177,10 @@ MidiDriver_MT32::MidiDriver_MT32(Audio::Mixer *mixer) : MidiDriver_Emulated(mixe
 	_outputRate = 0;
 	_controlData = nullptr;
 	_pcmData = nullptr;
+	_renderAheadFrames = 0;
+	_renderBuffer = nullptr;
+	_renderReadPos = _renderWritePos = _renderFramesBuffered = 0;
+	_playedFrames = 0;
 }
 
 MidiDriver_MT32::~MidiDriver_MT32() {
@@ -181,20 +207,23 @@ int MidiDriver_MT32::open() {
 		}
 	}
 
-	_controlData = new byte[controlFile.size()];
-	controlFile.read(_controlData, controlFile.size());
-	_pcmData = new byte[pcmFile.size()];
-	pcmFile.read(_pcmData, pcmFile.size());
+	const uint32 controlSize = controlFile.size();
+	const uint32 pcmSize = pcmFile.size();
+
+	_controlData = new byte[controlSize];
+	controlFile.read(_controlData, controlSize);
+	_pcmData = new byte[pcmSize];
+	pcmFile.read(_pcmData, pcmSize);
 
 	_service.createContext(_reportHandler);
 
-	if (_service.addROMData(_controlData, controlFile.size()) != MT32EMU_RC_ADDED_CONTROL_ROM) {
+	if (_service.addROMData(_controlData, controlSize) != MT32EMU_RC_ADDED_CONTROL_ROM) {
 		error("Adding control ROM failed. Check that your control ROM is valid");
 	}
 
 	controlFile.close();
 
-	if (_service.addROMData(_pcmData, pcmFile.size()) != MT32EMU_RC_ADDED_PCM_ROM) {
+	if (_service.addROMData(_pcmData, pcmSize) != MT32EMU_RC_ADDED_PCM_ROM) {
 		error("Adding PCM ROM failed. Check that your PCM ROM is valid");
 	}
 
@@ -220,6 +249,26 @@ int MidiDriver_MT32::open() {
 
 	MidiDriver_Emulated::open();
 
+	if (Audio::RenderCache::isEnabled()) {
+		const uint32 romHash = Audio::RenderCache::hashSongData(_controlData, controlSize) ^ Audio::RenderCache::hashSongData(_pcmData, pcmSize);
+		initRenderCache(Common::String::format("mt32-%08x-%d", romHash, ConfMan.getInt("midi_gain")));
+	}
+
+	// Rendering ahead is pointless when the output comes from the render
+	// cache, which also needs the emulator to be in sync with the mixer
+	const int renderAheadTime = ConfMan.getInt("mt32_render_ahead");
+	if (renderAheadTime > 0 && !_renderCache) {
+		_renderAheadFrames = _outputRate * renderAheadTime / 1000;
+		_renderBuffer = new int16[_renderAheadFrames * 2];
+		_renderReadPos = _renderWritePos = _renderFramesBuffered = 0;
+		_playedFrames = 0;
+
+		// Start with a full buffer, so that playback does not begin with
+		// an underrun
+		renderAhead();
+		g_system->getTimerManager()->installTimerProc(renderAheadTimerProc, 10000, this, "MT32RenderAhead");
+	}
+
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 
 	return 0;
@@ -229,7 +278,12 @@ void MidiDriver_MT32::send(uint32 b) {
 	midiDriverCommonSend(b);
 
 	Common::StackLock lock(_mutex);
-	_service.playMsg(b);
+	if (_renderCache)
+		_renderCache->addInput(b);
+	if (_renderAheadFrames)
+		_service.playMsgAt(b, getEventTimestamp());
+	else
+		_service.playMsg(b);
 }
 
 // Indiana Jones and the Fate of Atlantis (including the demo) uses
@@ -240,14 +294,25 @@ void MidiDriver_MT32::setPitchBendRange(byte channel, uint range) {
 	}
 	byte benderRangeSysex[4] = { 0, 0, 4, (uint8)range };
 	Common::StackLock lock(_mutex);
-	_service.writeSysex(channel, benderRangeSysex, 4);
+	if (_renderCache)
+		_renderCache->addInput(benderRangeSysex, 4);
+	if (_renderAheadFrames)
+		playSysexAt(channel, benderRangeSysex, 4);
+	else
+		_service.writeSysex(channel, benderRangeSysex, 4);
 }
 
 void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
 	midiDriverCommonSysEx(msg, length);
+	if (_renderCache)
+		_renderCache->addInput(msg, length);
+
 	if (msg[0] == 0xf0) {
 		Common::StackLock lock(_mutex);
-		_service.playSysex(msg, length);
+		if (_renderAheadFrames)
+			_service.playSysexAt(msg, length, getEventTimestamp());
+		else
+			_service.playSysex(msg, length);
 	} else {
 		enum {
 			SYSEX_CMD_DT1 = 0x12,
@@ -256,7 +321,10 @@ void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
 
 		if (msg[3] == SYSEX_CMD_DT1 || msg[3] == SYSEX_CMD_DAT) {
 			Common::StackLock lock(_mutex);
-			_service.writeSysex(msg[1], msg + 4, length - 5);
+			if (_renderAheadFrames)
+				playSysexAt(msg[1], msg + 4, length - 5);
+			else
+				_service.writeSysex(msg[1], msg + 4, length - 5);
 		} else {
 			warning("Unused sysEx command %d", msg[3]);
 		}
@@ -273,6 +341,16 @@ void MidiDriver_MT32::close() {
 	// Detach the mixer callback handler
 	_mixer->stopHandle(_mixerSoundHandle);
 
+	if (_renderAheadFrames) {
+		g_system->getTimerManager()->removeTimerProc(renderAheadTimerProc);
+		_renderAheadFrames = 0;
+		delete[] _renderBuffer;
+		_renderBuffer = nullptr;
+	}
+
+	delete _renderCache;
+	_renderCache = nullptr;
+
 	Common::StackLock lock(_mutex);
 	_service.closeSynth();
 	_service.freeContext();
@@ -283,10 +361,120 @@ void MidiDriver_MT32::close() {
 }
 
 void MidiDriver_MT32::generateSamples(int16 *data, int len) {
+	if (_renderAheadFrames) {
+		int frames = readRenderedFrames(data, len);
+		if (frames == len)
+			return;
+
+		// Render the rest directly. The timer may have rendered more frames
+		// in the meantime, which have to be played first.
+		Common::StackLock lock(_mutex);
+		frames += readRenderedFrames(data + frames * 2, len - frames);
+		if (frames < len) {
+			debug(5, "MT-32 render ahead underrun, rendering %d frames directly", len - frames);
+			_service.renderBit16s(data + frames * 2, len - frames);
+
+			Common::StackLock bufferLock(_renderBufferMutex);
+			_playedFrames += len - frames;
+		}
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 	_service.renderBit16s(data, len);
 }
 
+void MidiDriver_MT32::renderAheadTimerProc(void *refCon) {
+	static_cast<MidiDriver_MT32 *>(refCon)->renderAhead();
+}
+
+void MidiDriver_MT32::renderAhead() {
+	enum {
+		// Rendering happens in small steps, so that MIDI events sent in
+		// the meantime don't have to wait long for the lock
+		kMaxRenderFrames = 256
+	};
+
+	while (true) {
+		Common::StackLock lock(_mutex);
+		if (!_renderAheadFrames)
+			return;
+
+		uint32 writePos, framesFree;
+		{
+			Common::StackLock bufferLock(_renderBufferMutex);
+			writePos = _renderWritePos;
+			framesFree = _renderAheadFrames - _renderFramesBuffered;
+		}
+
+		// The mixer never reads the free part of the buffer, so it is safe
+		// to render into it without holding the buffer lock
+		const uint32 frames = MIN<uint32>(MIN<uint32>(framesFree, _renderAheadFrames - writePos), kMaxRenderFrames);
+		if (frames == 0)
+			return;
+
+		_service.renderBit16s(_renderBuffer + writePos * 2, frames);
+
+		Common::StackLock bufferLock(_renderBufferMutex);
+		_renderWritePos = (_renderWritePos + frames) % _renderAheadFrames;
+		_renderFramesBuffered += frames;
+	}
+}
+
+int MidiDriver_MT32::readRenderedFrames(int16 *data, int len) {
+	Common::StackLock lock(_renderBufferMutex);
+
+	int frames = 0;
+	while (frames < len && _renderFramesBuffered > 0) {
+		const uint32 count = MIN<uint32>(MIN<uint32>(len - frames, _renderFramesBuffered), _renderAheadFrames - _renderReadPos);
+		memcpy(data + frames * 2, _renderBuffer + _renderReadPos * 2, count * 2 * sizeof(int16));
+
+		_renderReadPos = (_renderReadPos + count) % _renderAheadFrames;
+		_renderFramesBuffered -= count;
+		frames += count;
+	}
+
+	_playedFrames += frames;
+	return frames;
+}
+
+uint32 MidiDriver_MT32::getEventTimestamp() {
+	// Events are played as far after the frame being played as Munt renders
+	// ahead of it. This keeps the timing between events intact, and Munt
+	// has not rendered past that point yet.
+	Common::StackLock lock(_renderBufferMutex);
+	return _service.convertOutputToSynthTimestamp(_playedFrames + _renderAheadFrames);
+}
+
+void MidiDriver_MT32::playSysexAt(byte device, const byte *data, uint32 length) {
+	// writeSysex() would apply the data immediately, which is too early when
+	// rendering ahead. Queue it as a complete DT1 message instead.
+	Common::Array<byte> sysex;
+	sysex.reserve(length + 7);
+	sysex.push_back(0xF0);
+	sysex.push_back(0x41);
+	sysex.push_back(device);
+	sysex.push_back(0x16);
+	sysex.push_back(0x12);
+
+	byte checksum = 0;
+	for (uint32 i = 0; i < length; ++i) {
+		sysex.push_back(data[i]);
+		checksum += data[i];
+	}
+	sysex.push_back((0x80 - (checksum & 0x7F)) & 0x7F);
+	sysex.push_back(0xF7);
+
+	_service.playSysexAt(sysex.begin(), sysex.size(), getEventTimestamp());
+}
+
+void MidiDriver_MT32::skipSamples(int len) {
+	// Keep the MIDI queue from overflowing while the output comes from the
+	// render cache
+	Common::StackLock lock(_mutex);
+	_service.flushMIDIQueue();
+}
+
 uint32 MidiDriver_MT32::property(int prop, uint32 param) {
 	switch (prop) {
 	case PROP_CHANNEL_MASK:
@@ -296,7 +484,7 @@ uint32 MidiDriver_MT32::property(int prop, uint32 param) {
 		break;
 	}
 
-	return 0;
+	return MidiDriver_Emulated::property(prop, param);
 }
 
 MidiChannel *MidiDriver_MT32::allocateChannel() {
@@ -34,6 +34,7 @@
 #include "audio/mixer.h"
 #include "common/system.h"
 #include "common/scummsys.h"
+#include "common/str.h"
 #include "common/util.h"
 
 #include <math.h>
@@ -180,6 +181,8 @@ bool OPL::init() {
 		_emulator->WriteReg(0x105, 1);
 	}
 
+	initRenderCache(Common::String::format("dosbox-%d", _type));
+
 	return true;
 }
 
@@ -188,6 +191,8 @@ void OPL::reset() {
 }
 
 void OPL::write(int port, int val) {
+	cacheWrite(port, val);
+
 	if (port&1) {
 		switch (_type) {
 		case Config::kOpl2:
@@ -259,6 +264,8 @@ byte OPL::read(int port) {
 }
 
 void OPL::writeReg(int r, int v) {
+	cacheWriteReg(r, v);
+
 	int tempReg = 0;
 	switch (_type) {
 	case Config::kOpl2:
@@ -35,6 +35,7 @@
 #include "mame.h"
 
 #include "audio/mixer.h"
+#include "common/str.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "common/util.h"
@@ -59,6 +60,7 @@ bool OPL::init() {
 	}
 
 	_opl = MAME::makeAdLibOPL(g_system->getMixer()->getOutputRate());
+	initRenderCache("mame");
 
 	return (_opl != nullptr);
 }
@@ -68,6 +70,7 @@ void OPL::reset() {
 }
 
 void OPL::write(int a, int v) {
+	cacheWrite(a, v);
 	MAME::OPLWrite(_opl, a, v);
 }
 
@@ -76,6 +79,7 @@ byte OPL::read(int a) {
 }
 
 void OPL::writeReg(int r, int v) {
+	cacheWriteReg(r, v);
 	MAME::OPLWriteReg(_opl, r, v);
 }
 
@@ -31,6 +31,7 @@
 #include "audio/mixer.h"
 #include "common/system.h"
 #include "common/scummsys.h"
+#include "common/str.h"
 #include "nuked.h"
 
 #ifndef DISABLE_NUKED_OPL
@@ -379,6 +380,14 @@ static void OPL3_EnvelopeCalc(opl3_slot *slot)
     Bit8u reset = 0;
     slot->eg_out = slot->eg_rout + (slot->reg_tl << 2)
                  + (slot->eg_ksl >> kslshift[slot->reg_ksl]) + *slot->trem;
+    // ScummVM: Fast path for released operators which have reached the
+    // maximum attenuation. They stay there until they are keyed on again,
+    // so the rest of the envelope calculation would not change anything.
+    if (!slot->key && slot->eg_gen == envelope_gen_num_release && slot->eg_rout == 0x1ff)
+    {
+        slot->pg_reset = 0;
+        return;
+    }
     if (slot->key && slot->eg_gen == envelope_gen_num_release)
     {
         reset = 1;
@@ -1414,6 +1423,8 @@ bool OPL::init() {
 		OPL3_WriteReg(&chip, 0x105, 0x01);
 	}
 
+	initRenderCache(Common::String::format("nuked-%d", _type));
+
 	return true;
 }
 
@@ -1422,6 +1433,8 @@ void OPL::reset() {
 }
 
 void OPL::write(int port, int val) {
+	cacheWrite(port, val);
+
 	if (port & 1) {
 		switch (_type) {
 		case Config::kOpl2:
@@ -1470,6 +1483,7 @@ void OPL::write(int port, int val) {
 
 
 void OPL::writeReg(int r, int v) {
+	cacheWriteReg(r, v);
 	OPL3_WriteRegBuffered(&chip, (Bit16u)r, (Bit8u)v);
 }
 
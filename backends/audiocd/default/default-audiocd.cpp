@@ -125,9 +125,11 @@ bool DefaultAudioCDManager::play(int track, int numLoops, int startFrame, int du
 			while all other positive numbers indicate precisely the number of desired
 			repetitions. Finally, -1 means infinitely many
 			*/
+			// Decode the compressed track ahead of time, including the
+			// seeking when looping
 			_emulating = true;
 			_mixer->playStream(soundType, &_handle,
-			                        Audio::makeLoopingAudioStream(stream, start, end, (numLoops < 1) ? numLoops + 1 : numLoops), -1, _cd.volume, _cd.balance);
+			                        Audio::makePrefetchingAudioStream(Audio::makeLoopingAudioStream(stream, start, end, (numLoops < 1) ? numLoops + 1 : numLoops)), -1, _cd.volume, _cd.balance);
 			return true;
 		}
 	}
@@ -305,6 +305,9 @@ void SavesSyncRequest::fileDownloadedCallback(const Storage::BoolResponse &respo
 		return;
 	}
 
+	//the cached metadata of the replaced save is outdated
+	g_system->getSavefileManager()->invalidateSavefileMetadata(_currentDownloadingFile.name());
+
 	//update local timestamp for downloaded file
 	_localFilesTimestamps[_currentDownloadingFile.name()] = _currentDownloadingFile.timestamp();
 	DefaultSaveFileManager::saveTimestamps(_localFilesTimestamps);
@@ -29,7 +29,7 @@
 #define JOY_XAXIS 0
 #define JOY_YAXIS 1
 
-LegacySdlEventSource::LegacySdlEventSource() {
+LegacySdlEventSource::LegacySdlEventSource() : _kbdMouseSpeed("kbdmouse_speed"), _joystickDeadzone("joystick_deadzone") {
 	// Reset mouse state
 	memset(&_km, 0, sizeof(_km));
 
@@ -152,7 +152,7 @@ bool LegacySdlEventSource::handleJoyAxisMotion(SDL_Event &ev, Common::Event &eve
 int16 LegacySdlEventSource::computeJoystickMouseSpeedFactor() const {
 	int16 speedFactor;
 
-	switch (ConfMan.getInt("kbdmouse_speed")) {
+	switch (_kbdMouseSpeed.get()) {
 	// 0.25 keyboard pointer speed
 	case 0:
 		speedFactor = 100;
@@ -206,7 +206,7 @@ bool LegacySdlEventSource::handleAxisToMouseMotion(int16 xAxis, int16 yAxis) {
 
 	float analogX = (float)xAxis;
 	float analogY = (float)yAxis;
-	float deadZone = (float)ConfMan.getInt("joystick_deadzone") * 1000.0f;
+	float deadZone = (float)_joystickDeadzone.get() * 1000.0f;
 
 	float magnitude = sqrt(analogX * analogX + analogY * analogY);
 
@@ -24,6 +24,8 @@
 
 #include "backends/events/sdl/sdl-events.h"
 
+#include "common/config-manager.h"
+
 // multiplier used to increase resolution for keyboard/joystick mouse
 #define MULTIPLIER 16
 
@@ -51,6 +53,10 @@ protected:
 	};
 	KbdMouse _km;
 
+	/** The settings read on every joystick axis event */
+	Common::ConfigManager::Handle<int> _kbdMouseSpeed;
+	Common::ConfigManager::Handle<int> _joystickDeadzone;
+
 	virtual void updateKbdMouse();
 	virtual bool handleKbdMouse(Common::Event &event);
 
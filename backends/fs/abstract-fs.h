@@ -172,6 +172,30 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Returns the time of the last modification of the object referred by
+	 * this path. For a directory, this has to change whenever an entry is
+	 * added, removed or renamed in it.
+	 *
+	 * @note By default, this method returns 0, which means that the time is
+	 * unknown.
+	 *
+	 * @return The modification time in backend specific units, or 0.
+	 */
+	virtual int64 getModificationTime() const { return 0; }
+
+	/**
+	 * Returns the child node with the given name, which is known to exist
+	 * and to be a directory or not, e.g. because it was listed before.
+	 * Backends can use this to create the node without querying the file system.
+	 *
+	 * @note By default, this method returns the value of getChild().
+	 *
+	 * @param name Name of the child to create a new node for.
+	 * @param isDirectoryFlag Whether the child is a directory.
+	 */
+	virtual AbstractFSNode *getChildWithKnownType(const Common::String &name, bool isDirectoryFlag) const { return getChild(name); }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
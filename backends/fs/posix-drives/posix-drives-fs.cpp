@@ -94,6 +94,14 @@ Common::SeekableWriteStream *DrivePOSIXFilesystemNode::createWriteStream() {
 	return writeStream;
 }
 
+int64 DrivePOSIXFilesystemNode::getModificationTime() const {
+	// The list of drives is not a real directory
+	if (_isPseudoRoot)
+		return 0;
+
+	return POSIXFilesystemNode::getModificationTime();
+}
+
 DrivePOSIXFilesystemNode *DrivePOSIXFilesystemNode::getChildWithKnownType(const Common::String &n, bool isDirectoryFlag) const {
 	assert(_isDirectory);
 
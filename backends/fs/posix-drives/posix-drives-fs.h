@@ -67,7 +67,9 @@ public:
 	// AbstractFSNode API
 	Common::SeekableReadStream *createReadStream() override;
 	Common::SeekableWriteStream *createWriteStream() override;
+	int64 getModificationTime() const override;
 	AbstractFSNode *getChild(const Common::String &n) const override;
+	DrivePOSIXFilesystemNode *getChildWithKnownType(const Common::String &n, bool isDirectoryFlag) const override;
 	bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const override;
 	AbstractFSNode *getParent() const override;
 
@@ -77,7 +79,6 @@ protected:
 private:
 	bool _isPseudoRoot;
 
-	DrivePOSIXFilesystemNode *getChildWithKnownType(const Common::String &n, bool isDirectoryFlag) const;
 	bool isDrive(const Common::String &path) const;
 	void configureStream(StdioStream *stream);
 };
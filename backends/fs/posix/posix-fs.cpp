@@ -67,6 +67,14 @@ bool POSIXFilesystemNode::isWritable() const {
 	return access(_path.c_str(), W_OK) == 0;
 }
 
+int64 POSIXFilesystemNode::getModificationTime() const {
+	struct stat st;
+
+	if (stat(_path.c_str(), &st) != 0)
+		return 0;
+	return st.st_mtime;
+}
+
 void POSIXFilesystemNode::setFlags() {
 	struct stat st;
 
@@ -137,6 +145,24 @@ AbstractFSNode *POSIXFilesystemNode::getChild(const Common::String &n) const {
 	return makeNode(newPath);
 }
 
+AbstractFSNode *POSIXFilesystemNode::getChildWithKnownType(const Common::String &n, bool isDirectoryFlag) const {
+	assert(_isDirectory);
+
+	// Make sure the string contains no slashes
+	assert(!n.contains('/'));
+
+	// Start with a clone of this node, like getChildren() does
+	POSIXFilesystemNode *child = new POSIXFilesystemNode(*this);
+	child->_displayName = n;
+	if (_path.lastChar() != '/')
+		child->_path += '/';
+	child->_path += n;
+	child->_isValid = true;
+	child->_isDirectory = isDirectoryFlag;
+
+	return child;
+}
+
 bool POSIXFilesystemNode::getChildren(AbstractFSList &myList, ListMode mode, bool hidden) const {
 	assert(_isDirectory);
 
@@ -60,8 +60,10 @@ public:
 	bool isDirectory() const override { return _isDirectory; }
 	bool isReadable() const override;
 	bool isWritable() const override;
+	int64 getModificationTime() const override;
 
 	AbstractFSNode *getChild(const Common::String &n) const override;
+	AbstractFSNode *getChildWithKnownType(const Common::String &n, bool isDirectoryFlag) const override;
 	bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const override;
 	AbstractFSNode *getParent() const override;
 
@@ -41,7 +41,9 @@ VirtualMouse::VirtualMouse(EventDispatcher *eventDispatcher) :
 		_slowModifier(1.f),
 		_subPixelRemainderX(0.f),
 		_subPixelRemainderY(0.f),
-		_lastUpdateMillis(0) {
+		_lastUpdateMillis(0),
+		_kbdMouseSpeed("kbdmouse_speed"),
+		_joystickDeadzone("joystick_deadzone") {
 	ConfMan.registerDefault("kbdmouse_speed", 3);
 	ConfMan.registerDefault("joystick_deadzone", 3);
 
@@ -185,7 +187,7 @@ void VirtualMouse::handleAxisMotion(int16 axisPositionX, int16 axisPositionY) {
 
 	float analogX  = (float)_inputAxisPositionX;
 	float analogY  = (float)_inputAxisPositionY;
-	float deadZone = (float)ConfMan.getInt("joystick_deadzone") * 1000.0f;
+	float deadZone = (float)_joystickDeadzone.get() * 1000.0f;
 
 	float magnitude = sqrt(analogX * analogX + analogY * analogY);
 
@@ -201,7 +203,7 @@ void VirtualMouse::handleAxisMotion(int16 axisPositionX, int16 axisPositionY) {
 }
 
 float VirtualMouse::computeJoystickMouseSpeedFactor() const {
-	switch (ConfMan.getInt("kbdmouse_speed")) {
+	switch (_kbdMouseSpeed.get()) {
 	case 0:
 		return 0.25; // 0.25 keyboard pointer speed
 	case 1:
@@ -24,6 +24,7 @@
 
 #include "common/scummsys.h"
 
+#include "common/config-manager.h"
 #include "common/events.h"
 
 namespace Common {
@@ -83,6 +84,9 @@ private:
 	float _subPixelRemainderY;
 
 	uint32 _lastUpdateMillis;
+
+	ConfigManager::Handle<int> _kbdMouseSpeed;
+	ConfigManager::Handle<int> _joystickDeadzone;
 };
 
 } // End of namespace Common
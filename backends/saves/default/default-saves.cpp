@@ -37,13 +37,18 @@
 #include "common/archive.h"
 #include "common/config-manager.h"
 #include "common/compression/deflate.h"
+#include "common/ptr.h"
 
-#include <errno.h>	// for removeSavefile()
+#include <errno.h>	// for removeSavefile() and moveSavefile()
 
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 const char *const DefaultSaveFileManager::TIMESTAMPS_FILENAME = "timestamps";
 #endif
 
+enum {
+	kMetadataIndexVersion = 1
+};
+
 DefaultSaveFileManager::DefaultSaveFileManager() {
 }
 
@@ -142,6 +147,8 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 		}
 	}
 
+	invalidateMetadata(filename);
+
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 	// Update file's timestamp
 	Common::HashMap<Common::String, uint32> timestamps = loadTimestamps();
@@ -189,6 +196,8 @@ bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
 	}
 #endif
 
+	invalidateMetadata(filename);
+
 	// Obtain node if exists.
 	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
 	if (file == _saveFileCache.end()) {
@@ -219,6 +228,79 @@ Common::ErrorCode DefaultSaveFileManager::removeFile(const Common::FSNode &fileN
 	return Common::kUnknownError;
 }
 
+bool DefaultSaveFileManager::moveSavefile(const Common::String &oldFilename, const Common::String &newFilename) {
+	// Assure the savefile name cache is up-to-date.
+	const Common::Path savePathName = getSavePath();
+	assureCached(savePathName);
+	if (getError().getCode() != Common::kNoError)
+		return false;
+
+	for (Common::StringArray::const_iterator i = _lockedFiles.begin(), end = _lockedFiles.end(); i != end; ++i) {
+		if (oldFilename == *i || newFilename == *i) {
+			return false; //file is locked, no saving available
+		}
+	}
+
+	SaveFileCache::const_iterator file = _saveFileCache.find(oldFilename);
+	if (file == _saveFileCache.end())
+		return false;
+
+	const Common::FSNode oldNode = file->_value;
+	const Common::FSNode newNode = Common::FSNode(savePathName).getChild(newFilename);
+
+	Common::ErrorCode result = moveFile(oldNode, newNode);
+	if (result != Common::kNoError) {
+		Common::Error error(result);
+		setError(error, "Failed to move savefile '" + oldNode.getName() + "': " + error.getDesc());
+		return false;
+	}
+
+	invalidateMetadata(oldFilename);
+	invalidateMetadata(newFilename);
+
+#if defined(USE_CLOUD) && defined(USE_LIBCURL)
+	// Update files' timestamps
+	Common::HashMap<Common::String, uint32> timestamps = loadTimestamps();
+	timestamps.erase(oldFilename);
+	timestamps[newFilename] = INVALID_TIMESTAMP;
+	saveTimestamps(timestamps);
+#endif
+
+	// This invalidates the 'file' iterator.
+	_saveFileCache.erase(oldFilename);
+	_saveFileCache[newFilename] = Common::FSNode(newNode.getPath());
+
+#if defined(USE_CLOUD) && defined(USE_LIBCURL)
+	// The moved file is only complete now, like after finalizing it
+	CloudMan.syncSaves();
+#endif
+
+	return true;
+}
+
+Common::ErrorCode DefaultSaveFileManager::moveFile(const Common::FSNode &oldNode, const Common::FSNode &newNode) {
+	Common::String oldPath(oldNode.getPath().toString(Common::Path::kNativeSeparator));
+	Common::String newPath(newNode.getPath().toString(Common::Path::kNativeSeparator));
+#ifdef WIN32
+	// rename() does not replace existing files on Windows
+	if (remove(newPath.c_str()) != 0 && errno != ENOENT)
+		return errno == EACCES ? Common::kWritePermissionDenied : Common::kUnknownError;
+#endif
+	if (rename(oldPath.c_str(), newPath.c_str()) == 0)
+		return Common::kNoError;
+	if (errno == EACCES)
+		return Common::kWritePermissionDenied;
+	if (errno == ENOENT)
+		return Common::kPathDoesNotExist;
+	return Common::kUnknownError;
+}
+
+bool DefaultSaveFileManager::getFileStamp(const Common::FSNode &fileNode, uint32 &size, uint32 &modTime) {
+	// Without the modification time, a replaced save file of the same size
+	// can't be told apart from the old one
+	return false;
+}
+
 bool DefaultSaveFileManager::exists(const Common::String &filename) {
 	// Assure the savefile name cache is up-to-date.
 	assureCached(getSavePath());
@@ -296,6 +378,191 @@ void DefaultSaveFileManager::assureCached(const Common::Path &savePathName) {
 	_cachedDirectory = savePathName;
 }
 
+bool DefaultSaveFileManager::getSavefileMetadata(const Common::String &target, const Common::String &filename, Common::SaveFileMetadata &metadata) {
+	// Assure the savefile name cache is up-to-date.
+	assureCached(getSavePath());
+	if (getError().getCode() != Common::kNoError)
+		return false;
+
+	for (Common::StringArray::const_iterator i = _lockedFiles.begin(), end = _lockedFiles.end(); i != end; ++i) {
+		if (filename == *i) {
+			return false; //file is locked, no loading available
+		}
+	}
+
+	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
+	if (file == _saveFileCache.end())
+		return false;
+
+	MetadataIndex &index = loadMetadataIndex(target);
+	MetadataEntryMap::iterator entry = index.entries.find(filename);
+	if (entry == index.entries.end())
+		return false;
+
+	// Check whether the file was changed behind our back
+	uint32 size, modTime;
+	if (!getFileStamp(file->_value, size, modTime) || !modTime || size != entry->_value.fileSize || modTime != entry->_value.fileTime) {
+		index.entries.erase(entry);
+		index.dirty = true;
+		return false;
+	}
+
+	metadata = entry->_value.metadata;
+	return true;
+}
+
+void DefaultSaveFileManager::setSavefileMetadata(const Common::String &target, const Common::String &filename, const Common::SaveFileMetadata &metadata) {
+	// Assure the savefile name cache is up-to-date.
+	assureCached(getSavePath());
+	if (getError().getCode() != Common::kNoError)
+		return;
+
+	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
+	if (file == _saveFileCache.end())
+		return;
+
+	MetadataEntry entry;
+	entry.metadata = metadata;
+	if (!getFileStamp(file->_value, entry.fileSize, entry.fileTime) || !entry.fileTime)
+		return;
+
+	MetadataIndex &index = loadMetadataIndex(target);
+	index.entries[filename] = entry;
+	index.dirty = true;
+}
+
+void DefaultSaveFileManager::flushSavefileMetadata() {
+	// Assure the savefile name cache is up-to-date.
+	assureCached(getSavePath());
+	if (getError().getCode() != Common::kNoError)
+		return;
+
+	// The indexes of another save directory can not be written anymore
+	if (_metadataDirectory != _cachedDirectory) {
+		_metadataIndexes.clear();
+		return;
+	}
+
+	for (MetadataIndexMap::iterator i = _metadataIndexes.begin(); i != _metadataIndexes.end(); ++i) {
+		if (i->_value.dirty)
+			saveMetadataIndex(i->_key, i->_value);
+	}
+}
+
+Common::String DefaultSaveFileManager::getMetadataIndexName(const Common::String &target) {
+	// Hidden files are not synced to the cloud, and are not matched by the
+	// save file patterns of the engines
+	return "." + target + ".saveindex";
+}
+
+DefaultSaveFileManager::MetadataIndex &DefaultSaveFileManager::loadMetadataIndex(const Common::String &target) {
+	if (_metadataDirectory != _cachedDirectory) {
+		_metadataIndexes.clear();
+		_metadataDirectory = _cachedDirectory;
+	}
+
+	MetadataIndexMap::iterator i = _metadataIndexes.find(target);
+	if (i != _metadataIndexes.end())
+		return i->_value;
+
+	MetadataIndex &index = _metadataIndexes[target];
+	index.dirty = false;
+
+	Common::ScopedPtr<Common::InSaveFile> in(openRawFile(getMetadataIndexName(target)));
+	if (!in || in->readUint32BE() != MKTAG('S', 'V', 'I', 'X') || in->readByte() != kMetadataIndexVersion)
+		return index;
+
+	const uint32 count = in->readUint32LE();
+	for (uint32 n = 0; n < count; n++) {
+		const Common::String filename = in->readString();
+
+		MetadataEntry entry;
+		entry.fileSize = in->readUint32LE();
+		entry.fileTime = in->readUint32LE();
+		entry.metadata.description = in->readString();
+		entry.metadata.saveDate = in->readUint32LE();
+		entry.metadata.saveTime = in->readUint16LE();
+		entry.metadata.playtime = in->readUint32LE();
+		entry.metadata.isAutosave = in->readByte() != 0;
+		entry.metadata.thumbnailOffset = in->readUint32LE();
+
+		if (in->eos() || in->err()) {
+			warning("DefaultSaveFileManager: Metadata index '%s' is truncated", getMetadataIndexName(target).c_str());
+			index.entries.clear();
+			break;
+		}
+
+		index.entries[filename] = entry;
+	}
+
+	return index;
+}
+
+void DefaultSaveFileManager::saveMetadataIndex(const Common::String &target, MetadataIndex &index) {
+	const Common::String filename = getMetadataIndexName(target);
+	const Common::FSNode fileNode = Common::FSNode(_cachedDirectory).getChild(filename);
+
+	Common::ScopedPtr<Common::SeekableWriteStream> out(fileNode.createWriteStream());
+	if (!out) {
+		warning("DefaultSaveFileManager: Failed to write metadata index '%s'", filename.c_str());
+		return;
+	}
+
+	out->writeUint32BE(MKTAG('S', 'V', 'I', 'X'));
+	out->writeByte(kMetadataIndexVersion);
+	out->writeUint32LE(index.entries.size());
+
+	for (MetadataEntryMap::const_iterator i = index.entries.begin(); i != index.entries.end(); ++i) {
+		const MetadataEntry &entry = i->_value;
+		out->writeString(i->_key);
+		out->writeByte(0);
+		out->writeUint32LE(entry.fileSize);
+		out->writeUint32LE(entry.fileTime);
+		out->writeString(entry.metadata.description);
+		out->writeByte(0);
+		out->writeUint32LE(entry.metadata.saveDate);
+		out->writeUint16LE(entry.metadata.saveTime);
+		out->writeUint32LE(entry.metadata.playtime);
+		out->writeByte(entry.metadata.isAutosave);
+		out->writeUint32LE(entry.metadata.thumbnailOffset);
+	}
+
+	out->finalize();
+	if (!out->err())
+		index.dirty = false;
+
+	// Add file to cache now that it exists.
+	_saveFileCache[filename] = Common::FSNode(fileNode.getPath());
+}
+
+void DefaultSaveFileManager::invalidateSavefileMetadata(const Common::String &filename) {
+	// Assure the savefile name cache is up-to-date.
+	assureCached(getSavePath());
+	if (getError().getCode() != Common::kNoError)
+		return;
+
+	// The file can be listed in the index of any target, so load all of them
+	const Common::String suffix = getMetadataIndexName("");
+	for (SaveFileCache::const_iterator file = _saveFileCache.begin(), end = _saveFileCache.end(); file != end; ++file) {
+		const Common::String &name = file->_key;
+		if (name.size() > suffix.size() && name.hasPrefix(".") && name.hasSuffixIgnoreCase(suffix.c_str() + 1))
+			loadMetadataIndex(Common::String(name.c_str() + 1, name.size() - suffix.size()));
+	}
+
+	invalidateMetadata(filename);
+	flushSavefileMetadata();
+}
+
+void DefaultSaveFileManager::invalidateMetadata(const Common::String &filename) {
+	for (MetadataIndexMap::iterator i = _metadataIndexes.begin(); i != _metadataIndexes.end(); ++i) {
+		MetadataEntryMap::iterator entry = i->_value.entries.find(filename);
+		if (entry != i->_value.entries.end()) {
+			i->_value.entries.erase(entry);
+			i->_value.dirty = true;
+		}
+	}
+}
+
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
 
 Common::HashMap<Common::String, uint32> DefaultSaveFileManager::loadTimestamps() {
@@ -42,8 +42,14 @@ public:
 	Common::InSaveFile *openForLoading(const Common::String &filename) override;
 	Common::OutSaveFile *openForSaving(const Common::String &filename, bool compress = true) override;
 	bool removeSavefile(const Common::String &filename) override;
+	bool moveSavefile(const Common::String &oldFilename, const Common::String &newFilename) override;
 	bool exists(const Common::String &filename) override;
 
+	bool getSavefileMetadata(const Common::String &target, const Common::String &filename, Common::SaveFileMetadata &metadata) override;
+	void setSavefileMetadata(const Common::String &target, const Common::String &filename, const Common::SaveFileMetadata &metadata) override;
+	void flushSavefileMetadata() override;
+	void invalidateSavefileMetadata(const Common::String &filename) override;
+
 #ifdef USE_LIBCURL
 
 	static const uint32 INVALID_TIMESTAMP = UINT_MAX;
@@ -75,6 +81,21 @@ protected:
 	 */
 	virtual Common::ErrorCode removeFile(const Common::FSNode &fileNode);
 
+	/**
+	 * Moves the given file, replacing the destination if it exists.
+	 * This is called from moveSavefile() with the full file paths.
+	 */
+	virtual Common::ErrorCode moveFile(const Common::FSNode &oldNode, const Common::FSNode &newNode);
+
+	/**
+	 * Get the size and the modification time of the given file. These are
+	 * used to check whether cached metadata of a save file is still valid.
+	 *
+	 * The default implementation can't get the modification time, and
+	 * returns false, so no metadata is cached.
+	 */
+	virtual bool getFileStamp(const Common::FSNode &fileNode, uint32 &size, uint32 &modTime);
+
 	/**
 	 * Assure that the given save path is cached.
 	 *
@@ -104,6 +125,41 @@ private:
 	 * The currently cached directory.
 	 */
 	Common::Path _cachedDirectory;
+
+	struct MetadataEntry {
+		Common::SaveFileMetadata metadata;
+		uint32 fileSize;
+		uint32 fileTime;
+	};
+
+	typedef Common::HashMap<Common::String, MetadataEntry, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> MetadataEntryMap;
+
+	/**
+	 * The metadata of the saves of one target. It is stored in a hidden
+	 * file in the save directory, see getMetadataIndexName().
+	 */
+	struct MetadataIndex {
+		MetadataEntryMap entries;
+		bool dirty;
+	};
+
+	typedef Common::HashMap<Common::String, MetadataIndex, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> MetadataIndexMap;
+
+	static Common::String getMetadataIndexName(const Common::String &target);
+	MetadataIndex &loadMetadataIndex(const Common::String &target);
+	void saveMetadataIndex(const Common::String &target, MetadataIndex &index);
+
+	/**
+	 * Remove the cached metadata of a save file which is being changed.
+	 */
+	void invalidateMetadata(const Common::String &filename);
+
+	/**
+	 * The loaded metadata indexes of the targets, and the directory they
+	 * belong to.
+	 */
+	MetadataIndexMap _metadataIndexes;
+	Common::Path _metadataDirectory;
 };
 
 #endif
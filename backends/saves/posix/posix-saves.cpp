@@ -122,4 +122,14 @@ POSIXSaveFileManager::POSIXSaveFileManager() {
 	}
 }
 
+bool POSIXSaveFileManager::getFileStamp(const Common::FSNode &fileNode, uint32 &size, uint32 &modTime) {
+	struct stat sb;
+	if (stat(fileNode.getPath().toString(Common::Path::kNativeSeparator).c_str(), &sb) != 0)
+		return false;
+
+	size = sb.st_size;
+	modTime = sb.st_mtime;
+	return true;
+}
+
 #endif
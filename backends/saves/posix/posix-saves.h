@@ -27,13 +27,16 @@
 #if defined(POSIX) && !defined(DISABLE_DEFAULT_SAVEFILEMANAGER)
 /**
  * Customization of the DefaultSaveFileManager for POSIX platforms.
- * The only two differences are that the default constructor sets
- * up the savepath based on HOME, and that checkPath tries to
- * create the savedir, if missing, via the mkdir() syscall.
+ * The differences are that the default constructor sets up the
+ * savepath based on HOME, and that the size and modification time
+ * of save files are looked up with the stat() syscall.
  */
 class POSIXSaveFileManager : public DefaultSaveFileManager {
 public:
 	POSIXSaveFileManager();
+
+protected:
+	bool getFileStamp(const Common::FSNode &fileNode, uint32 &size, uint32 &modTime) override;
 };
 #endif
 
@@ -58,6 +58,7 @@
 #include "gui/message.h"
 
 #include "audio/mididrv.h"
+#include "audio/mixer.h"
 #include "audio/musicplugin.h"  /* for music manager */
 
 #include "graphics/cursorman.h"
@@ -548,6 +549,14 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 		ConfMan.registerDefault("dump_midi", true);
 	}
 
+	// Keep the listings of deep directory scans next to the config file
+	if (ConfMan.getBool("fs_listing_cache")) {
+		Common::Path configFile = ConfMan.getCustomConfigFileName();
+		if (configFile.empty())
+			configFile = system.getDefaultConfigFileName();
+		Common::FSDirectory::setListingCacheDirectory(configFile.getParent().appendComponent("dirlists"));
+	}
+
 #ifdef USE_OPENGL
 	if (settings.contains("last_window_width")) {
 		ConfMan.setInt("last_window_width", atoi(settings["last_window_width"].c_str()));
@@ -572,6 +581,10 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	// the command line params) was read.
 	system.initBackend();
 
+	// Resampling channels together is an optimization for slow devices
+	if (system.getMixer())
+		system.getMixer()->setSubmixing(ConfMan.getBool("audio_submix"));
+
 	// If we received an invalid graphics mode parameter via command line
 	// we check this here. We can't do it until after the backend is inited,
 	// or there won't be a graphics manager to ask for the supported modes.
@@ -791,6 +804,8 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 				g_eventRec.init(recordFileName, GUI::EventRecorder::kRecorderUpdate);
 			} else if (recordMode == "playback") {
 				g_eventRec.init(recordFileName, GUI::EventRecorder::kRecorderPlayback);
+			} else if (recordMode == "timedemo") {
+				g_eventRec.init(recordFileName, GUI::EventRecorder::kRecorderPlayback, true);
 			} else if ((recordMode == "info") && (!recordFileName.empty())) {
 				Common::PlaybackFile record;
 				record.openRead(recordFileName);
@@ -50,6 +50,8 @@ char const *const ConfigManager::kCloudDomain = "cloud";
 #pragma mark -
 
 
+uint32 ConfigManager::_generation = 0;
+
 ConfigManager::ConfigManager() : _activeDomain(nullptr) {
 }
 
@@ -75,6 +77,7 @@ void ConfigManager::copyFrom(ConfigManager &source) {
 	_activeDomainName = source._activeDomainName;
 	_activeDomain = &_gameDomains[_activeDomainName];
 	_filename = source._filename;
+	_generation++;
 }
 
 
@@ -167,6 +170,7 @@ void ConfigManager::addDomain(const String &domainName, const ConfigManager::Dom
 
 		_miscDomains[domainName] = domain;
 	}
+	_generation++;
 }
 
 
@@ -571,6 +575,26 @@ Path ConfigManager::getPath(const String &key, const String &domName) const {
 	return Path::fromConfig(get(key, domName));
 }
 
+template<>
+int ConfigManager::Handle<int>::lookUp() const {
+	return ConfMan.getInt(_key, _domName);
+}
+
+template<>
+bool ConfigManager::Handle<bool>::lookUp() const {
+	return ConfMan.getBool(_key, _domName);
+}
+
+template<>
+String ConfigManager::Handle<String>::lookUp() const {
+	return ConfMan.get(_key, _domName);
+}
+
+template<>
+Path ConfigManager::Handle<Path>::lookUp() const {
+	return ConfMan.getPath(_key, _domName);
+}
+
 
 #pragma mark -
 
@@ -697,6 +721,7 @@ void ConfigManager::setActiveDomain(const String &domName) {
 		_activeDomain = &_gameDomains[domName];
 	}
 	_activeDomainName = domName;
+	_generation++;
 }
 
 void ConfigManager::addGameDomain(const String &domName) {
@@ -728,12 +753,14 @@ void ConfigManager::removeGameDomain(const String &domName) {
 		_activeDomain = nullptr;
 	}
 	_gameDomains.erase(domName);
+	_generation++;
 }
 
 void ConfigManager::removeMiscDomain(const String &domName) {
 	assert(!domName.empty());
 	assert(isValidDomainName(domName));
 	_miscDomains.erase(domName);
+	_generation++;
 }
 
 
@@ -743,10 +770,12 @@ void ConfigManager::renameGameDomain(const String &oldName, const String &newNam
 		_activeDomainName = newName;
 		_activeDomain = &_gameDomains[newName];
 	}
+	_generation++;
 }
 
 void ConfigManager::renameMiscDomain(const String &oldName, const String &newName) {
 	renameDomain(oldName, newName, _miscDomains);
+	_generation++;
 }
 
 /**
@@ -79,10 +79,10 @@ public:
 		 */
 		const String &operator[](const String &key) const { return _entries[key]; }
 
-		void           setVal(const String &key, const String &value) { _entries.setVal(key, value); } /*!< Assign a @p value to a @p key. */
+		void           setVal(const String &key, const String &value) { _generation++; _entries.setVal(key, value); } /*!< Assign a @p value to a @p key. */
 
-		String &getOrCreateVal(const String &key) { return _entries.getOrCreateVal(key); }
-		String        &getVal(const String &key) { return _entries.getVal(key); } /*!< Retrieve the value of a @p key. */
+		String &getOrCreateVal(const String &key) { _generation++; return _entries.getOrCreateVal(key); }
+		String        &getVal(const String &key) { _generation++; return _entries.getVal(key); } /*!< Retrieve the value of a @p key. */
 		const String  &getVal(const String &key) const { return _entries.getVal(key); } /*!< @overload */
 		 /**
 		  * Retrieve the value of @p key if it exists and leave the referenced variable unchanged if the key does not exist.
@@ -92,9 +92,9 @@ public:
 		const String &getValOrDefault(const String &key) const { return _entries.getValOrDefault(key); }
 		bool tryGetVal(const String &key, String &out) const { return _entries.tryGetVal(key, out); }
 
-		void           clear() { _entries.clear(); } /*!< Clear all configuration entries in the domain. */
+		void           clear() { _generation++; _entries.clear(); } /*!< Clear all configuration entries in the domain. */
 
-		void           erase(const String &key) { _entries.erase(key); } /*!< Remove a key from the domain. */
+		void           erase(const String &key) { _generation++; _entries.erase(key); } /*!< Remove a key from the domain. */
 
 		void           setDomainComment(const String &comment); /*!< Add a @p comment for this configuration domain. */
 		const String  &getDomainComment() const; /*!< Retrieve the comment of this configuration domain. */
@@ -104,6 +104,63 @@ public:
 		bool           hasKVComment(const String &key) const; /*!< Check whether a @p key has a key-value comment. */
 	};
 
+	/**
+	 * A typed configuration value, which is only looked up again when the
+	 * configuration changed.
+	 *
+	 * Use this for values which are read in frame or audio paths, instead of
+	 * calling getInt() or getBool() with the same key over and over:
+	 *
+	 * @code
+	 * ConfigManager::Handle<bool> _subtitles("subtitles");
+	 * ...
+	 * if (_subtitles.get())
+	 * @endcode
+	 *
+	 * Handles are available for int, bool, String and Path values. Like the
+	 * accessors, they must only be used from the thread which changes the
+	 * configuration.
+	 */
+	template<typename T>
+	class Handle {
+	public:
+		/**
+		 * @param key      The configuration key.
+		 * @param domName  The domain to read the value from. If empty, the
+		 *                 domains are searched in the order of their priority.
+		 */
+		Handle(const String &key, const String &domName = String()) : _key(key), _domName(domName), _generation(0), _valid(false), _value() {}
+
+		/** Return the current value of the key. */
+		const T &get() const {
+			if (!_valid || _generation != ConfigManager::_generation) {
+				_value = lookUp();
+				_generation = ConfigManager::_generation;
+				_valid = true;
+			}
+			return _value;
+		}
+
+		operator const T &() const { return get(); }
+
+		const String &getKey() const { return _key; } /*!< Return the configuration key. */
+
+	private:
+		T lookUp() const;
+
+		String _key;
+		String _domName;
+		mutable uint32 _generation;
+		mutable bool _valid;
+		mutable T _value;
+	};
+
+	/**
+	 * Return a counter which changes whenever a configuration value or the
+	 * active domain changes.
+	 */
+	static uint32            getGeneration() { return _generation; }
+
 	/** A hash map of existing configuration domains. */
 	typedef HashMap<String, Domain, IgnoreCase_Hash, IgnoreCase_EqualTo> DomainMap;
 
@@ -257,8 +314,16 @@ private:
 	Domain *		_activeDomain;
 
 	Path			_filename;
+
+	/** Incremented on every change, to invalidate the handles. */
+	static uint32	_generation;
 };
 
+template<> int ConfigManager::Handle<int>::lookUp() const;
+template<> bool ConfigManager::Handle<bool>::lookUp() const;
+template<> String ConfigManager::Handle<String>::lookUp() const;
+template<> Path ConfigManager::Handle<Path>::lookUp() const;
+
 /** @} */
 
 } // End of namespace Common
@@ -24,6 +24,8 @@
 
 #include "common/scummsys.h"
 
+#include "common/debug.h"
+
 #include "common/hashmap.h"
 #include "common/hash-str.h"
 #include "common/list.h"
@@ -148,7 +150,15 @@ public:
 	/**
 	 * Test whether the given debug channel is enabled.
 	 */
-	bool isDebugChannelEnabled(uint32 channel, bool enforce = false);
+	bool isDebugChannelEnabled(uint32 channel, bool enforce = false) {
+		// Debug level 11 turns on all special debug level messages
+		if (gDebugLevel == 11 && enforce == false)
+			return true;
+		// Most channels are disabled, which the filter tells without a lookup
+		if (!(gDebugChannelsFilter & debugChannelFilterBit(channel)))
+			return false;
+		return lookUpDebugChannel(channel);
+	}
 
 private:
 	typedef HashMap<String, DebugChannel, IgnoreCase_Hash, IgnoreCase_EqualTo> DebugChannelMap;
@@ -166,6 +176,17 @@ private:
 	 * Internal method for adding an array of debug channels.
 	 */
 	void addDebugChannels(const DebugChannelDef *channels);
+
+	/**
+	 * Internal method for checking whether a channel is enabled.
+	 */
+	bool lookUpDebugChannel(uint32 channel) const;
+
+	/**
+	 * Internal method for updating gDebugChannelsFilter after channels were
+	 * enabled or disabled.
+	 */
+	void updateChannelsFilter();
 };
 
 /** Shortcut for accessing the Debug Manager. */
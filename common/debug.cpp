@@ -30,6 +30,7 @@
 // TODO: Move gDebugLevel into namespace Common.
 int gDebugLevel = -1;
 bool gDebugChannelsOnly = false;
+uint64 gDebugChannelsFilter = 0;
 
 const DebugChannelDef gDebugChannels[] = {
 	{ kDebugLevelEventRec,   "eventrec",  "Event recorder debug level" },
@@ -98,6 +99,8 @@ void DebugManager::removeAllDebugChannels() {
 	for (DebugChannelMap::iterator i = _debugChannels.begin(); i != _debugChannels.end(); ++i)
 		if (oldMap.contains(i->_value.channel))
 			_debugChannelsEnabled[i->_value.channel] = oldMap[i->_value.channel];
+
+	updateChannelsFilter();
 }
 
 bool DebugManager::enableDebugChannel(const String &name) {
@@ -105,6 +108,7 @@ bool DebugManager::enableDebugChannel(const String &name) {
 
 	if (i != _debugChannels.end()) {
 		_debugChannelsEnabled[i->_value.channel] = true;
+		updateChannelsFilter();
 
 		return true;
 	} else {
@@ -114,6 +118,7 @@ bool DebugManager::enableDebugChannel(const String &name) {
 
 bool DebugManager::enableDebugChannel(uint32 channel) {
 	_debugChannelsEnabled[channel] = true;
+	updateChannelsFilter();
 	return true;
 }
 
@@ -122,6 +127,7 @@ bool DebugManager::disableDebugChannel(const String &name) {
 
 	if (i != _debugChannels.end()) {
 		_debugChannelsEnabled[i->_value.channel] = false;
+		updateChannelsFilter();
 
 		return true;
 	} else {
@@ -131,6 +137,7 @@ bool DebugManager::disableDebugChannel(const String &name) {
 
 bool DebugManager::disableDebugChannel(uint32 channel) {
 	_debugChannelsEnabled[channel] = false;
+	updateChannelsFilter();
 	return true;
 }
 
@@ -153,12 +160,16 @@ void DebugManager::disableAllDebugChannels() {
 		disableDebugChannel(i->_value.name);
 }
 
-bool DebugManager::isDebugChannelEnabled(uint32 channel, bool enforce) {
-	// Debug level 11 turns on all special debug level messages
-	if (gDebugLevel == 11 && enforce == false)
-		return true;
-	else
-		return (_debugChannelsEnabled.contains(channel) && _debugChannelsEnabled[channel] == true);
+bool DebugManager::lookUpDebugChannel(uint32 channel) const {
+	EnabledChannelsMap::const_iterator i = _debugChannelsEnabled.find(channel);
+	return i != _debugChannelsEnabled.end() && i->_value;
+}
+
+void DebugManager::updateChannelsFilter() {
+	gDebugChannelsFilter = 0;
+	for (EnabledChannelsMap::const_iterator i = _debugChannelsEnabled.begin(); i != _debugChannelsEnabled.end(); ++i)
+		if (i->_value)
+			gDebugChannelsFilter |= debugChannelFilterBit(i->_key);
 }
 
 void DebugManager::addDebugChannels(const DebugChannelDef *channels) {
@@ -169,16 +180,8 @@ void DebugManager::addDebugChannels(const DebugChannelDef *channels) {
 
 } // End of namespace Common
 
-bool debugLevelSet(int level) {
-	return level <= gDebugLevel;
-}
-
-bool debugChannelSet(int level, uint32 debugChannels) {
-	if (gDebugLevel != 11 || level == -1)
-		if ((level != -1 && level > gDebugLevel) || !(DebugMan.isDebugChannelEnabled(debugChannels, level == -1)))
-			return false;
-
-	return true;
+bool debugChannelEnabled(uint32 debugChannel) {
+	return DebugMan.isDebugChannelEnabled(debugChannel, true);
 }
 
 
@@ -214,7 +217,7 @@ void debug(const char *s, ...) {
 void debug(int level, const char *s, ...) {
 	va_list va;
 
-	if (level > gDebugLevel || gDebugChannelsOnly)
+	if (!debugLevelSet(level) || gDebugChannelsOnly)
 		return;
 
 	va_start(va, s);
@@ -237,7 +240,7 @@ void debugN(const char *s, ...) {
 void debugN(int level, const char *s, ...) {
 	va_list va;
 
-	if (level > gDebugLevel || gDebugChannelsOnly)
+	if (!debugLevelSet(level) || gDebugChannelsOnly)
 		return;
 
 	va_start(va, s);
@@ -248,6 +251,11 @@ void debugN(int level, const char *s, ...) {
 void debugC(int level, uint32 debugChannels, const char *s, ...) {
 	va_list va;
 
+#ifdef MAX_DEBUG_LEVEL
+	if (level > MAX_DEBUG_LEVEL)
+		return;
+#endif
+
 	// Debug level 11 turns on all special debug level messages
 	if (gDebugLevel != 11)
 		if (level > gDebugLevel || !(DebugMan.isDebugChannelEnabled(debugChannels)))
@@ -261,6 +269,11 @@ void debugC(int level, uint32 debugChannels, const char *s, ...) {
 void debugCN(int level, uint32 debugChannels, const char *s, ...) {
 	va_list va;
 
+#ifdef MAX_DEBUG_LEVEL
+	if (level > MAX_DEBUG_LEVEL)
+		return;
+#endif
+
 	// Debug level 11 turns on all special debug level messages
 	if (gDebugLevel != 11)
 		if (level > gDebugLevel || !(DebugMan.isDebugChannelEnabled(debugChannels)))
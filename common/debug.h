@@ -128,10 +128,56 @@ void debugCN(uint32 debugChannels, MSVC_PRINTF const char *s, ...) GCC_PRINTF(2,
 
 #endif
 
+/**
+ * The debug level. Initially set to -1, indicating that no debug output
+ * should be shown. Positive values usually imply that an increasing number of
+ * debug output shall be generated. The higher the value, the more verbose the
+ * information (although the exact semantics are up to the engines).
+ */
+extern int gDebugLevel;
+
+/**
+ * Specify whether to show only the debug channels and suppress
+ * the non-channeled output.
+ *
+ * This option is useful when you want to have higher levels of channels
+ * visible without the noise from other subsystems or OSystem.
+ */
+extern bool gDebugChannelsOnly;
+
+/**
+ * A bit for each enabled debug channel, as returned by debugChannelFilterBit().
+ * Different channels may share a bit, so a set bit only means that the
+ * channel might be enabled. It is kept up to date by the DebugManager.
+ */
+extern uint64 gDebugChannelsFilter;
+
+/**
+ * Return the bit of a debug channel in gDebugChannelsFilter.
+ */
+inline uint64 debugChannelFilterBit(uint32 debugChannel) {
+	return (uint64)1 << ((debugChannel * 0x9E3779B1U) >> 26);
+}
+
 /**
  * Check whether the debug level is set to the specified level.
+ *
+ * If ScummVM was configured with a maximum debug level, higher levels are
+ * never set, so that code depending on them is compiled out.
+ */
+inline bool debugLevelSet(int level) {
+#ifdef MAX_DEBUG_LEVEL
+	if (level > MAX_DEBUG_LEVEL)
+		return false;
+#endif
+	return level <= gDebugLevel;
+}
+
+/**
+ * Check whether a debug channel is enabled, ignoring the debug level.
+ * Use debugChannelSet() instead.
  */
-bool debugLevelSet(int level);
+bool debugChannelEnabled(uint32 debugChannel);
 
 /**
  * Check whether the debug level and channel are active.
@@ -140,24 +186,74 @@ bool debugLevelSet(int level);
  * @param debugChannels Bitfield of channels to check against.
  * @see enableDebugChannel
  */
-bool debugChannelSet(int level, uint32 debugChannels);
+inline bool debugChannelSet(int level, uint32 debugChannels) {
+#ifdef MAX_DEBUG_LEVEL
+	if (level > MAX_DEBUG_LEVEL)
+		return false;
+#endif
+
+	// Debug level 11 turns on all special debug level messages
+	if (gDebugLevel == 11 && level != -1)
+		return true;
+	if (level > gDebugLevel)
+		return false;
+
+	if (!(gDebugChannelsFilter & debugChannelFilterBit(debugChannels)))
+		return false;
+	return debugChannelEnabled(debugChannels);
+}
+
+#ifdef DISABLE_TEXT_CONSOLE
+
+#define DEBUG_TRACE(level, ...) do {} while (false)
+#define DEBUG_TRACE_N(level, ...) do {} while (false)
+#define DEBUG_TRACE_C(level, debugChannels, ...) do {} while (false)
+#define DEBUG_TRACE_CN(level, debugChannels, ...) do {} while (false)
+
+#else
 
 /**
- * The debug level. Initially set to -1, indicating that no debug output
- * should be shown. Positive values usually imply that an increasing number of
- * debug output shall be generated. The higher the value, the more verbose the
- * information (although the exact semantics are up to the engines).
+ * Like debug(level, ...), but the message arguments are only evaluated
+ * if the message is printed. Meant for hot code paths, like interpreter
+ * loops.
  */
-extern int gDebugLevel;
+#define DEBUG_TRACE(level, ...) \
+	do { \
+		if (debugLevelSet(level) && !gDebugChannelsOnly) \
+			debug(level, __VA_ARGS__); \
+	} while (false)
 
 /**
- * Specify whether to show only the debug channels and suppress
- * the non-channeled output.
- *
- * This option is useful when you want to have higher levels of channels
- * visible without the noise from other subsystems or OSystem.
+ * Like debugN(level, ...), but the message arguments are only evaluated
+ * if the message is printed.
  */
-extern bool gDebugChannelsOnly;
+#define DEBUG_TRACE_N(level, ...) \
+	do { \
+		if (debugLevelSet(level) && !gDebugChannelsOnly) \
+			debugN(level, __VA_ARGS__); \
+	} while (false)
+
+/**
+ * Like debugC(level, debugChannels, ...), but the message arguments are
+ * only evaluated if the message is printed.
+ */
+#define DEBUG_TRACE_C(level, debugChannels, ...) \
+	do { \
+		if (debugChannelSet(level, debugChannels)) \
+			debugC(level, debugChannels, __VA_ARGS__); \
+	} while (false)
+
+/**
+ * Like debugCN(level, debugChannels, ...), but the message arguments are
+ * only evaluated if the message is printed.
+ */
+#define DEBUG_TRACE_CN(level, debugChannels, ...) \
+	do { \
+		if (debugChannelSet(level, debugChannels)) \
+			debugCN(level, debugChannels, __VA_ARGS__); \
+	} while (false)
+
+#endif
 
 /** Global constant for EventRecorder debug channel. */
 enum GlobalDebugLevels {
@@ -21,7 +21,9 @@
 
 #include "common/system.h"
 #include "common/debug.h"
+#include "common/noncopyable.h"
 #include "common/punycode.h"
+#include "common/serializer.h"
 #include "common/textconsole.h"
 #include "backends/fs/abstract-fs.h"
 #include "backends/fs/fs-factory.h"
@@ -233,6 +235,10 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+int64 FSNode::getModificationTime() const {
+	return _realNode ? _realNode->getModificationTime() : 0;
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -423,19 +429,111 @@ FSDirectory *FSDirectory::getSubDirectory(const Path &prefix, const Path &name,
 	return new FSDirectory(prefix, *node, depth, flat, ignoreClashes);
 }
 
-void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix) const {
+struct FSDirectory::DirectoryListing : NonCopyable {
+	struct Entry {
+		String name;
+		bool isDirectory;
+		/** The listing of the sub-directory, if it was scanned */
+		DirectoryListing *listing;
+	};
+
+	int64 modificationTime;
+	Array<Entry> entries;
+
+	DirectoryListing() : modificationTime(0) {}
+	~DirectoryListing() {
+		for (uint i = 0; i < entries.size(); i++)
+			delete entries[i].listing;
+	}
+
+	/** Sync the listing, @p maxEntries guards against damaged files */
+	bool sync(Serializer &s, int depth, uint32 maxEntries);
+};
+
+bool FSDirectory::DirectoryListing::sync(Serializer &s, int depth, uint32 maxEntries) {
+	uint64 time = modificationTime;
+	uint32 count = entries.size();
+	s.syncAsUint64LE(time);
+	s.syncAsUint32LE(count);
+	modificationTime = time;
+
+	if (s.isLoading()) {
+		if (s.err() || count > maxEntries)
+			return false;
+		entries.resize(count);
+		for (uint i = 0; i < count; i++)
+			entries[i].listing = nullptr;
+	}
+
+	for (uint i = 0; i < count; i++) {
+		Entry &entry = entries[i];
+		byte hasListing = entry.listing != nullptr;
+		s.syncString(entry.name);
+		s.syncAsByte(entry.isDirectory);
+		s.syncAsByte(hasListing);
+
+		// Reading past the end of a truncated file gives empty names
+		if (entry.name.empty())
+			return false;
+
+		if (hasListing) {
+			if (!entry.isDirectory || depth <= 1)
+				return false;
+			if (s.isLoading())
+				entry.listing = new DirectoryListing();
+			if (!entry.listing->sync(s, depth - 1, maxEntries))
+				return false;
+		}
+	}
+
+	return !s.err();
+}
+
+Path FSDirectory::_listingCacheDirectory;
+
+void FSDirectory::setListingCacheDirectory(const Path &directory) {
+	_listingCacheDirectory = directory;
+}
+
+bool FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix, DirectoryListing *listing, bool fromListing) const {
 	if (depth <= 0)
-		return;
+		return true;
 
 	FSList list;
-	node.getChildren(list, FSNode::kListAll);
+	if (fromListing) {
+		// The listing is only valid as long as no entry has been added to,
+		// removed from or renamed in the directory
+		if (!listing || !listing->modificationTime || node._realNode->getModificationTime() != listing->modificationTime)
+			return false;
+
+		for (uint i = 0; i < listing->entries.size(); i++) {
+			const DirectoryListing::Entry &entry = listing->entries[i];
+			list.push_back(FSNode(node._realNode->getChildWithKnownType(entry.name, entry.isDirectory)));
+		}
+	} else {
+		// Get the time before the listing, so that changes made while
+		// listing invalidate it
+		if (listing)
+			listing->modificationTime = node._realNode->getModificationTime();
+
+		node.getChildren(list, FSNode::kListAll);
+
+		if (listing) {
+			listing->entries.resize(list.size());
+			for (uint i = 0; i < list.size(); i++) {
+				listing->entries[i].name = list[i].getRealName();
+				listing->entries[i].isDirectory = list[i].isDirectory();
+				listing->entries[i].listing = nullptr;
+			}
+		}
+	}
 
-	FSList::iterator it = list.begin();
-	for ( ; it != list.end(); ++it) {
-		Path name = prefix.appendComponent(it->getRealName());
+	for (uint i = 0; i < list.size(); i++) {
+		const FSNode &child = list[i];
+		Path name = prefix.appendComponent(child.getRealName());
 
 		// since the hashmap is case insensitive, we need to check for clashes when caching
-		if (it->isDirectory()) {
+		if (child.isDirectory()) {
 			if (!_flat && _subDirCache.contains(name)) {
 				// Always warn in this case as it's when there are 2 directories at the same place with different case
 				// That means a problem in user installation as lookups are always done case insensitive
@@ -448,8 +546,17 @@ void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const Path& pr
 						        Common::toPrintable(name.toString(Common::Path::kNativeSeparator)).c_str());
 					}
 				}
-				cacheDirectoryRecursive(*it, depth - 1, _flat ? prefix : name);
-				_subDirCache[name] = *it;
+
+				DirectoryListing *subListing = nullptr;
+				if (listing && depth > 1) {
+					if (!fromListing)
+						listing->entries[i].listing = new DirectoryListing();
+					subListing = listing->entries[i].listing;
+				}
+
+				if (!cacheDirectoryRecursive(child, depth - 1, _flat ? prefix : name, subListing, fromListing))
+					return false;
+				_subDirCache[name] = child;
 			}
 		} else {
 			if (_fileCache.contains(name)) {
@@ -458,19 +565,121 @@ void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const Path& pr
 					        Common::toPrintable(name.toString(Common::Path::kNativeSeparator)).c_str());
 				}
 			} else
-				_fileCache[name] = *it;
+				_fileCache[name] = child;
 		}
 	}
 
+	return true;
 }
 
 void FSDirectory::ensureCached() const  {
 	if (_cached)
 		return;
-	cacheDirectoryRecursive(_node, _depth, _prefix);
+
+	// A single directory is listed as fast as its listing would be loaded
+	if (_depth <= 1 || _listingCacheDirectory.empty() || !_node.isDirectory()) {
+		cacheDirectoryRecursive(_node, _depth, _prefix, nullptr, false);
+		_cached = true;
+		return;
+	}
+
+	DirectoryListing listing;
+	if (loadListing(listing)) {
+		if (cacheDirectoryRecursive(_node, _depth, _prefix, &listing, true)) {
+			debug(2, "FSDirectory::ensureCached: Using the stored listing of '%s'", _node.getPath().toString(Common::Path::kNativeSeparator).c_str());
+			_cached = true;
+			return;
+		}
+
+		debug(2, "FSDirectory::ensureCached: The stored listing of '%s' is outdated", _node.getPath().toString(Common::Path::kNativeSeparator).c_str());
+		_fileCache.clear();
+		_subDirCache.clear();
+	}
+
+	DirectoryListing newListing;
+	cacheDirectoryRecursive(_node, _depth, _prefix, &newListing, false);
+	saveListing(newListing);
 	_cached = true;
 }
 
+FSNode FSDirectory::getListingCacheFile() const {
+	const String path = _node.getPath().toString(Common::Path::kNativeSeparator);
+	const String fileName = String::format("dirlist-%08x-%d.dat", hashit(path.c_str()), _depth);
+	return FSNode(_listingCacheDirectory).getChild(fileName);
+}
+
+enum {
+	kListingVersion = 1
+};
+
+bool FSDirectory::loadListing(DirectoryListing &listing) const {
+	FSNode file = getListingCacheFile();
+	if (!file.exists())
+		return false;
+
+	SeekableReadStream *stream = file.createReadStream();
+	if (!stream)
+		return false;
+
+	bool valid;
+	{
+		Serializer s(stream, nullptr);
+		s.enableBuffering();
+
+		// Several directories can have the same file name, check which one is stored
+		String path;
+		int32 depth = 0;
+		valid = s.matchBytes("SVDL", 4) && s.syncVersion(kListingVersion);
+		if (valid) {
+			s.syncString(path);
+			s.syncAsSint32LE(depth);
+			valid = path == _node.getPath().toString(Common::Path::kNativeSeparator) && depth == _depth &&
+			        listing.sync(s, _depth, stream->size());
+		}
+	}
+
+	delete stream;
+	return valid;
+}
+
+void FSDirectory::saveListing(DirectoryListing &listing) const {
+	// The file system doesn't tell when directories change
+	if (!listing.modificationTime)
+		return;
+
+	FSNode directory(_listingCacheDirectory);
+	if (!directory.exists() && !directory.createDirectory()) {
+		debug(2, "FSDirectory::saveListing: Can't create '%s'", _listingCacheDirectory.toString(Common::Path::kNativeSeparator).c_str());
+		return;
+	}
+
+	FSNode file = getListingCacheFile();
+	SeekableWriteStream *stream = file.createWriteStream();
+	if (!stream) {
+		debug(2, "FSDirectory::saveListing: Can't create '%s'", file.getPath().toString(Common::Path::kNativeSeparator).c_str());
+		return;
+	}
+
+	{
+		Serializer s(nullptr, stream);
+		s.enableBuffering();
+
+		String path = _node.getPath().toString(Common::Path::kNativeSeparator);
+		int32 depth = _depth;
+		s.matchBytes("SVDL", 4);
+		s.syncVersion(kListingVersion);
+		s.syncString(path);
+		s.syncAsSint32LE(depth);
+		listing.sync(s, _depth, 0xFFFFFFFF);
+	}
+
+	stream->finalize();
+	if (stream->err())
+		debug(2, "FSDirectory::saveListing: Can't write '%s'", file.getPath().toString(Common::Path::kNativeSeparator).c_str());
+
+	delete stream;
+}
+
 int FSDirectory::listMatchingMembers(ArchiveMemberList &list, const Path &pattern, bool matchPathComponents) const {
 	if (!_node.isDirectory())
 		return 0;
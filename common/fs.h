@@ -252,6 +252,15 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Return the time of the last modification of the object referred by
+	 * this node, in backend specific units. This can only be compared with
+	 * other times returned for the same node.
+	 *
+	 * @return The modification time, or 0 if it is unknown.
+	 */
+	int64 getModificationTime() const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -332,6 +341,11 @@ public:
  * and using 'your' as a prefix, the cache entry would have been 'your/data/file.ext'.
  * This is done both in non-flat and flat mode.
  *
+ * When a listing cache directory is set, the listings of trees deeper than one
+ * level are also kept on disk, see setListingCacheDirectory(). They are used
+ * instead of scanning the tree again as long as the modification times of all
+ * the listed directories are unchanged.
+ *
  */
 class FSDirectory : public Archive {
 	FSNode _node;
@@ -349,15 +363,24 @@ class FSDirectory : public Archive {
 	mutable NodeCache	_fileCache, _subDirCache;
 	mutable bool _cached;
 
+	// listings kept between runs, see setListingCacheDirectory()
+	struct DirectoryListing;
+	static Path _listingCacheDirectory;
+
 	// look for a match
 	FSNode *lookupCache(NodeCache &cache, const Path &name) const;
 
 	// cache management
-	void cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix) const;
+	bool cacheDirectoryRecursive(FSNode node, int depth, const Path& prefix, DirectoryListing *listing, bool fromListing) const;
 
 	// fill cache if not already cached
 	void ensureCached() const;
 
+	// persistent listing cache management
+	FSNode getListingCacheFile() const;
+	bool loadListing(DirectoryListing &listing) const;
+	void saveListing(DirectoryListing &listing) const;
+
 public:
 	/**
 	 * Create a FSDirectory representing a tree with the specified depth. Will result in an
@@ -391,6 +414,16 @@ public:
 	 */
 	FSNode getFSNode() const;
 
+	/**
+	 * Set the directory in which the listings of deep directory trees are kept
+	 * between runs. An empty path disables the persistent listing cache,
+	 * which is the default.
+	 *
+	 * The cache is only used with file system backends which report the
+	 * modification times of directories.
+	 */
+	static void setListingCacheDirectory(const Path &directory);
+
 	/**
 	 * Create a new FSDirectory pointing to a subdirectory of the instance.
 	 * @return A new FSDirectory instance.
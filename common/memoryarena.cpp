@@ -0,0 +1,102 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/memoryarena.h"
+#include "common/memorytracker.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Common {
+
+MemoryArena::MemoryArena(size_t blockSize, MemoryTag *tag)
+	: _blockSize(blockSize), _tag(tag), _first(nullptr), _current(nullptr), _pos(nullptr), _end(nullptr), _reservedSize(0) {
+	assert(blockSize > sizeof(Block));
+}
+
+MemoryArena::~MemoryArena() {
+	freeBlocks();
+}
+
+void *MemoryArena::allocateSlow(size_t size, size_t alignment) {
+	// Use the next block if it is large enough, otherwise insert a new one
+	Block *block = _current ? _current->next : _first;
+	if (!block || getStart(block) + size + alignment - 1 > block->end) {
+		const size_t blockSize = MAX(_blockSize, sizeof(Block) + size + alignment - 1);
+		Block *newBlock = (Block *)malloc(blockSize);
+		if (!newBlock)
+			error("MemoryArena: Could not allocate a block of %u bytes", (uint)blockSize);
+
+		newBlock->next = block;
+		newBlock->end = (byte *)newBlock + blockSize;
+		if (_current)
+			_current->next = newBlock;
+		else
+			_first = newBlock;
+
+		_reservedSize += blockSize;
+		if (_tag)
+			_tag->allocated(blockSize);
+		block = newBlock;
+	}
+
+	_current = block;
+	_pos = getStart(block);
+	_end = block->end;
+
+	void *result = allocate(size, alignment);
+	assert(_pos);
+	return result;
+}
+
+void MemoryArena::release(const Mark &mark) {
+	if (!mark.block) {
+		reset();
+		return;
+	}
+
+	_current = mark.block;
+	_pos = mark.pos;
+	_end = mark.block->end;
+}
+
+void MemoryArena::reset() {
+	_current = _first;
+	_pos = _first ? getStart(_first) : nullptr;
+	_end = _first ? _first->end : nullptr;
+}
+
+void MemoryArena::freeBlocks() {
+	while (_first) {
+		Block *next = _first->next;
+		const size_t blockSize = _first->end - (byte *)_first;
+		if (_tag)
+			_tag->freed(blockSize);
+		free(_first);
+		_first = next;
+	}
+
+	_current = nullptr;
+	_pos = nullptr;
+	_end = nullptr;
+	_reservedSize = 0;
+}
+
+} // End of namespace Common
@@ -0,0 +1,156 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_MEMORYARENA_H
+#define COMMON_MEMORYARENA_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+class MemoryTag;
+
+/**
+ * @defgroup common_memory_arena Memory arena
+ * @ingroup common_memory
+ *
+ * @brief API for allocating transient data in bulk.
+ * @{
+ */
+
+/**
+ * An allocator for data which is freed all at once, like the data of a
+ * frame or of a room.
+ *
+ * Allocating just moves a pointer forward in a large block of memory.
+ * Nothing is freed individually. Instead, reset() releases all the
+ * allocations at once, and a Scope releases the allocations made during
+ * its lifetime. The blocks are kept for reuse until the arena is destroyed
+ * or freeBlocks() is called.
+ *
+ * No destructors are called, so the arena is meant for plain data.
+ */
+class MemoryArena : NonCopyable {
+private:
+	struct Block {
+		Block *next;
+		byte *end;
+	};
+
+public:
+	/**
+	 * A position in the arena, to release all allocations made after it.
+	 */
+	struct Mark {
+		Block *block;
+		byte *pos;
+	};
+
+	/**
+	 * Releases the allocations made during its lifetime.
+	 *
+	 * @code
+	 * void Scene::draw() {
+	 *     Common::MemoryArena::Scope scope(_frameArena);
+	 *     DrawItem *items = _frameArena.allocateArray<DrawItem>(_objects.size());
+	 *     ...
+	 * }
+	 * @endcode
+	 */
+	class Scope : NonCopyable {
+	public:
+		explicit Scope(MemoryArena &arena) : _arena(arena), _mark(arena.getMark()) {}
+		~Scope() { _arena.release(_mark); }
+
+	private:
+		MemoryArena &_arena;
+		Mark _mark;
+	};
+
+	/**
+	 * @param blockSize  The size of the blocks allocated from the system.
+	 *                   Larger allocations get a block of their own.
+	 * @param tag        The tag which counts the blocks, if any.
+	 */
+	explicit MemoryArena(size_t blockSize = 64 * 1024, MemoryTag *tag = nullptr);
+	~MemoryArena();
+
+	/**
+	 * Allocate @p size bytes, aligned to @p alignment, which has to be a
+	 * power of two.
+	 */
+	void *allocate(size_t size, size_t alignment = sizeof(void *)) {
+		const uintptr result = ((uintptr)_pos + alignment - 1) & ~(uintptr)(alignment - 1);
+		if (!_pos || result + size > (uintptr)_end)
+			return allocateSlow(size, alignment);
+		_pos = (byte *)result + size;
+		return (void *)result;
+	}
+
+	/** Allocate uninitialized memory for @p count objects of type T. */
+	template<class T>
+	T *allocateArray(size_t count) {
+		return (T *)allocate(count * sizeof(T), alignof(T));
+	}
+
+	/** Return the current position, to release the later allocations with release(). */
+	Mark getMark() const {
+		Mark mark = { _current, _pos };
+		return mark;
+	}
+
+	/** Release all allocations made after @p mark was taken. */
+	void release(const Mark &mark);
+
+	/** Release all allocations. */
+	void reset();
+
+	/**
+	 * Release all allocations and give the blocks back to the system.
+	 * Marks taken before can't be used anymore.
+	 */
+	void freeBlocks();
+
+	/** Return the total size of the blocks allocated from the system. */
+	size_t getReservedSize() const { return _reservedSize; }
+
+private:
+	void *allocateSlow(size_t size, size_t alignment);
+	static byte *getStart(Block *block) { return (byte *)(block + 1); }
+
+	const size_t _blockSize;
+	MemoryTag *_tag;
+
+	/** The blocks, in the order they are used. */
+	Block *_first;
+	Block *_current;
+	byte *_pos;
+	byte *_end;
+
+	size_t _reservedSize;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
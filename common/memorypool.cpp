@@ -20,6 +20,7 @@
  */
 
 #include "common/memorypool.h"
+#include "common/memorytracker.h"
 #include "common/util.h"
 
 namespace Common {
@@ -28,6 +29,12 @@ enum {
 	INITIAL_CHUNKS_PER_PAGE = 8
 };
 
+static MemoryTag &getMemoryTag() {
+	// Pools may be destroyed after static objects, so the tag is never freed
+	static MemoryTag *tag = new MemoryTag("Memory pools");
+	return *tag;
+}
+
 static size_t adjustChunkSize(size_t chunkSize) {
 	// You must at least fit the pointer in the node (technically unneeded considering the next rounding statement)
 	chunkSize = MAX(chunkSize, sizeof(void *));
@@ -54,8 +61,10 @@ MemoryPool::~MemoryPool() {
 		warning("Memory leak found in pool");
 #endif
 
-	for (size_t i = 0; i < _pages.size(); ++i)
+	for (size_t i = 0; i < _pages.size(); ++i) {
+		getMemoryTag().freed(_pages[i].numChunks * _chunkSize);
 		::free(_pages[i].start);
+	}
 }
 
 void MemoryPool::allocPage() {
@@ -68,6 +77,7 @@ void MemoryPool::allocPage() {
 	page.start = ::malloc(page.numChunks * _chunkSize);
 	assert(page.start);
 	_pages.push_back(page);
+	getMemoryTag().allocated(page.numChunks * _chunkSize);
 
 
 	// Next time, we'll allocate a page twice as big as this one.
@@ -150,6 +160,7 @@ void MemoryPool::freeUnusedPages() {
 					iter2 = *(void ***)iter2;
 			}
 
+			getMemoryTag().freed(_pages[i].numChunks * _chunkSize);
 			::free(_pages[i].start);
 			_pages[i].start = nullptr;
 		}
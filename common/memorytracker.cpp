@@ -0,0 +1,142 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Memory may be allocated before the backend is set up, so the mutexes of
+// the backend can't be used.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/memorytracker.h"
+
+#ifdef USE_MEMORY_TRACKER
+
+#include <mutex>
+
+namespace Common {
+
+namespace {
+
+/** Guards the counters and the list of tags */
+std::mutex g_mutex;
+MemoryTag *g_firstTag = nullptr;
+
+/** Keeps the size of an allocation, with the alignment malloc provides. */
+union AllocationHeader {
+	size_t size;
+	uint64 alignInt;
+	double alignDouble;
+	void *alignPointer;
+};
+
+} // End of anonymous namespace
+
+MemoryTag::MemoryTag(const char *name) : _name(name), _next(nullptr), _count(0), _totalCount(0), _bytes(0), _peakBytes(0) {
+	std::lock_guard<std::mutex> lock(g_mutex);
+	MemoryTag **last = &g_firstTag;
+	while (*last)
+		last = &(*last)->_next;
+	*last = this;
+}
+
+MemoryTag::~MemoryTag() {
+	std::lock_guard<std::mutex> lock(g_mutex);
+	for (MemoryTag **tag = &g_firstTag; *tag; tag = &(*tag)->_next) {
+		if (*tag == this) {
+			*tag = _next;
+			break;
+		}
+	}
+}
+
+void MemoryTag::allocated(size_t size) {
+	std::lock_guard<std::mutex> lock(g_mutex);
+	_count++;
+	_totalCount++;
+	_bytes += size;
+	if (_bytes > _peakBytes)
+		_peakBytes = _bytes;
+}
+
+void MemoryTag::freed(size_t size) {
+	std::lock_guard<std::mutex> lock(g_mutex);
+	assert(_count > 0 && _bytes >= size);
+	_count--;
+	_bytes -= size;
+}
+
+void *MemoryTag::allocate(size_t size) {
+	AllocationHeader *header = (AllocationHeader *)malloc(sizeof(AllocationHeader) + size);
+	if (!header)
+		return nullptr;
+
+	header->size = size;
+	allocated(size);
+	return header + 1;
+}
+
+void MemoryTag::deallocate(void *ptr) {
+	if (!ptr)
+		return;
+
+	AllocationHeader *header = (AllocationHeader *)ptr - 1;
+	freed(header->size);
+	free(header);
+}
+
+MemoryTag::Stats MemoryTag::getStats() const {
+	std::lock_guard<std::mutex> lock(g_mutex);
+	Stats stats;
+	stats.name = _name;
+	stats.count = _count;
+	stats.totalCount = _totalCount;
+	stats.bytes = _bytes;
+	stats.peakBytes = _peakBytes;
+	return stats;
+}
+
+void MemoryTag::resetPeak() {
+	std::lock_guard<std::mutex> lock(g_mutex);
+	_peakBytes = _bytes;
+}
+
+Array<MemoryTag::Stats> MemoryTag::getAllStats() {
+	Array<Stats> result;
+	std::lock_guard<std::mutex> lock(g_mutex);
+	for (const MemoryTag *tag = g_firstTag; tag; tag = tag->_next) {
+		Stats stats;
+		stats.name = tag->_name;
+		stats.count = tag->_count;
+		stats.totalCount = tag->_totalCount;
+		stats.bytes = tag->_bytes;
+		stats.peakBytes = tag->_peakBytes;
+		result.push_back(stats);
+	}
+	return result;
+}
+
+void MemoryTag::resetAllPeaks() {
+	std::lock_guard<std::mutex> lock(g_mutex);
+	for (MemoryTag *tag = g_firstTag; tag; tag = tag->_next)
+		tag->_peakBytes = tag->_bytes;
+}
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,140 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_MEMORYTRACKER_H
+#define COMMON_MEMORYTRACKER_H
+
+#include "common/scummsys.h"
+
+#ifdef USE_MEMORY_TRACKER
+#include "common/array.h"
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_memory_tracker Memory tracker
+ * @ingroup common_memory
+ *
+ * @brief Accounting of the memory allocated by each subsystem.
+ *
+ * The allocations are only counted when ScummVM is configured with
+ * --enable-memory-tracker. Otherwise, the tags do nothing but allocate
+ * memory, so they can stay in the code.
+ *
+ * The "memory" debugger command lists the statistics of all tags.
+ *
+ * @{
+ */
+
+#ifdef USE_MEMORY_TRACKER
+
+/**
+ * Counts the allocations of one subsystem.
+ *
+ * Memory can either be allocated through the tag, or allocated elsewhere
+ * and reported with allocated() and freed(). A tag has to outlive the
+ * memory counted for it, so tags shared by several objects are usually
+ * static:
+ *
+ * @code
+ * static Common::MemoryTag &getTag() {
+ *     static Common::MemoryTag tag("Scene objects");
+ *     return tag;
+ * }
+ * @endcode
+ *
+ * Tags may be used from any thread.
+ */
+class MemoryTag {
+public:
+	struct Stats {
+		const char *name;
+		/** The number of live allocations. */
+		uint32 count;
+		/** The number of allocations made so far. */
+		uint32 totalCount;
+		/** The number of bytes in live allocations. */
+		size_t bytes;
+		/** The highest number of bytes since the peak was last reset. */
+		size_t peakBytes;
+	};
+
+	/** @param name  The name shown by the debugger, must be a string literal. */
+	explicit MemoryTag(const char *name);
+	~MemoryTag();
+
+	/** Count an allocation of @p size bytes. */
+	void allocated(size_t size);
+
+	/** Count freeing an allocation of @p size bytes. */
+	void freed(size_t size);
+
+	/** Allocate memory counted for this tag. Free it with deallocate(). */
+	void *allocate(size_t size);
+
+	/** Free memory returned by allocate(). */
+	void deallocate(void *ptr);
+
+	Stats getStats() const;
+
+	/** Set the peak to the current number of bytes. */
+	void resetPeak();
+
+	/** Return the statistics of all tags, in the order they were created. */
+	static Array<Stats> getAllStats();
+
+	/** Reset the peak of all tags. */
+	static void resetAllPeaks();
+
+private:
+	MemoryTag(const MemoryTag &);
+	MemoryTag &operator=(const MemoryTag &);
+
+	const char *_name;
+	MemoryTag *_next;
+
+	uint32 _count;
+	uint32 _totalCount;
+	size_t _bytes;
+	size_t _peakBytes;
+};
+
+#else
+
+class MemoryTag {
+public:
+	explicit MemoryTag(const char *name) {}
+
+	void allocated(size_t size) {}
+	void freed(size_t size) {}
+
+	void *allocate(size_t size) { return malloc(size); }
+	void deallocate(void *ptr) { free(ptr); }
+};
+
+#endif
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
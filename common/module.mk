@@ -20,6 +20,7 @@ MODULE_OBJS := \
 	localization.o \
 	macresman.o \
 	memory.o \
+	memoryarena.o \
 	memorypool.o \
 	md5.o \
 	mutex.o \
@@ -30,6 +31,7 @@ MODULE_OBJS := \
 	random.o \
 	rational.o \
 	rendermode.o \
+	serializer.o \
 	str.o \
 	stream.o \
 	streamdebug.o \
@@ -57,5 +59,15 @@ MODULE_OBJS += \
 	updates.o
 endif
 
+ifdef USE_PROFILER
+MODULE_OBJS += \
+	profiler.o
+endif
+
+ifdef USE_MEMORY_TRACKER
+MODULE_OBJS += \
+	memorytracker.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
@@ -409,6 +409,7 @@ Path &Path::appendInPlace(const Path &x) {
 	if (x._str.empty()) {
 		return *this;
 	}
+	invalidateCache();
 
 	if (_str.empty()) {
 		_str = x._str;
@@ -459,6 +460,7 @@ Path &Path::appendInPlace(const char *str, char separator) {
 	if (!*str) {
 		return *this;
 	}
+	invalidateCache();
 	if (_str.empty()) {
 		set(str, separator);
 		return *this;
@@ -515,6 +517,7 @@ Path Path::appendComponent(const char *str) const {
 	if (isEscaped()) {
 		// We are escaped, escape str as well
 		Path ret(*this);
+		ret.invalidateCache();
 		if (addSeparator) {
 			ret._str += SEPARATOR;
 		}
@@ -535,6 +538,7 @@ Path Path::appendComponent(const char *str) const {
 	} else {
 		// No need to escape anything
 		Path ret(*this);
+		ret.invalidateCache();
 		if (addSeparator) {
 			ret._str += SEPARATOR;
 		}
@@ -547,6 +551,7 @@ Path &Path::joinInPlace(const Path &x) {
 	if (x.empty()) {
 		return *this;
 	}
+	invalidateCache();
 	if (_str.empty()) {
 		_str = x._str;
 		return *this;
@@ -570,6 +575,7 @@ Path &Path::joinInPlace(const char *str, char separator) {
 	if (*str == '\0') {
 		return *this;
 	}
+	invalidateCache();
 	if (_str.empty()) {
 		set(str, separator);
 		return *this;
@@ -585,6 +591,7 @@ Path &Path::joinInPlace(const char *str, char separator) {
 Path &Path::removeTrailingSeparators() {
 	while (_str.size() > 1 && _str.lastChar() == SEPARATOR) {
 		_str.deleteLastChar();
+		invalidateCache();
 	}
 	return *this;
 }
@@ -691,6 +698,10 @@ Path Path::relativeTo(const Common::Path &other) const {
 }
 
 Path Path::normalize() const {
+	if (_cacheFlags & kNormalized) {
+		return *this;
+	}
+
 	if (_str.empty()) {
 		return Path();
 	}
@@ -750,6 +761,7 @@ Path Path::normalize() const {
 		if (hasLeadingSeparator) {
 			result._str += SEPARATOR;
 		}
+		result._cacheFlags = kNormalized;
 		return result;
 	}
 
@@ -804,6 +816,7 @@ Path Path::normalize() const {
 		}
 	}
 
+	result._cacheFlags = kNormalized;
 	return result;
 }
 
@@ -1025,7 +1038,7 @@ uint Path::hash() const {
 	return hashit(_str.c_str());
 }
 
-uint Path::hashIgnoreCase() const {
+uint Path::computeHashIgnoreCase() const {
 	return hashit_lower(_str);
 }
 
@@ -1038,7 +1051,7 @@ struct hasher {
 	uint mult;
 };
 
-uint Path::hashIgnoreCaseAndMac() const {
+uint Path::computeHashIgnoreCaseAndMac() const {
 	hasher v = { 0x345678, 1000003 };
 	reduceComponents<hasher &>(
 		[](hasher &value, const String &in, bool last) -> hasher & {
@@ -1059,10 +1072,16 @@ bool Path::matchPattern(const Path &pattern) const {
 }
 
 bool Path::equalsIgnoreCase(const Path &other) const {
+	// Paths which were already hashed, like the keys of hash maps, differ
+	// if their hashes do
+	if ((_cacheFlags & other._cacheFlags & kHashIgnoreCaseCached) && _hashIgnoreCase != other._hashIgnoreCase)
+		return false;
 	return _str.equalsIgnoreCase(other._str);
 }
 
 bool Path::equalsIgnoreCaseAndMac(const Path &other) const {
+	if ((_cacheFlags & other._cacheFlags & kHashIgnoreCaseAndMacCached) && _hashIgnoreCaseAndMac != other._hashIgnoreCaseAndMac)
+		return false;
 	return compareComponents(
 		[](const String &x, const String &y) {
 			return getIdentifierComponent(x).equalsIgnoreCase(getIdentifierComponent(y));
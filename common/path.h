@@ -48,6 +48,11 @@ namespace Common {
  * Internally, this is just a simple wrapper around a String, using
  * "/" as a directory separator.
  * It escapes it using "|" if / is used inside a path component.
+ *
+ * The case-insensitive hashes are cached, and so is whether the path is
+ * normalized, so that looking up the same path in several archives or
+ * directories doesn't scan it again. The cache is copied along with the
+ * path.
  */
 class Path {
 #ifdef CXXTEST_RUNNING
@@ -70,6 +75,20 @@ private:
 
 	String _str;
 
+	enum {
+		kHashIgnoreCaseCached       = 1 << 0,
+		kHashIgnoreCaseAndMacCached = 1 << 1,
+		kNormalized                 = 1 << 2
+	};
+
+	/** The cached hashes of _str, which are valid if flagged in _cacheFlags. */
+	mutable uint _hashIgnoreCase;
+	mutable uint _hashIgnoreCaseAndMac;
+	mutable byte _cacheFlags;
+
+	/** Forget the cached values, has to be called whenever _str changes. */
+	void invalidateCache() { _cacheFlags = 0; }
+
 	/**
 	 * Escapes a path:
 	 * - all ESCAPE are encoded to ESCAPE ESCAPED_ESCAPE
@@ -175,6 +194,9 @@ private:
 		return *_str.c_str() == ESCAPE;
 	}
 
+	uint computeHashIgnoreCase() const;
+	uint computeHashIgnoreCaseAndMac() const;
+
 	/**
 	 * Returns the suffix in this path after @p other path
 	 * Returns nullptr if @p other isn't a prefix
@@ -237,10 +259,11 @@ public:
 	};
 
 	/** Construct a new empty path. */
-	Path() {}
+	Path() : _hashIgnoreCase(0), _hashIgnoreCaseAndMac(0), _cacheFlags(0) {}
 
 	/** Construct a copy of the given path. */
-	Path(const Path &path) : _str(path._str) { }
+	Path(const Path &path) : _str(path._str), _hashIgnoreCase(path._hashIgnoreCase),
+		_hashIgnoreCaseAndMac(path._hashIgnoreCaseAndMac), _cacheFlags(path._cacheFlags) { }
 
 	/**
 	 * Construct a new path from the given NULL-terminated C string.
@@ -252,7 +275,8 @@ public:
 	 *                  Defaults to '/'.
 	 */
 	Path(const char *str, char separator = '/') :
-		_str(needsEncoding(str, separator) ? encode(str, separator) : str) { }
+		_str(needsEncoding(str, separator) ? encode(str, separator) : str),
+		_hashIgnoreCase(0), _hashIgnoreCaseAndMac(0), _cacheFlags(0) { }
 
 	/**
 	 * Construct a new path from the given String.
@@ -264,7 +288,8 @@ public:
 	 *                  Defaults to '/'.
 	 */
 	explicit Path(const String &str, char separator = '/') :
-		_str(needsEncoding(str.c_str(), separator) ? encode(str.c_str(), separator) : str) { }
+		_str(needsEncoding(str.c_str(), separator) ? encode(str.c_str(), separator) : str),
+		_hashIgnoreCase(0), _hashIgnoreCaseAndMac(0), _cacheFlags(0) { }
 
 	/**
 	 * Converts a path to a string using the given directory separator.
@@ -279,7 +304,10 @@ public:
 	/**
 	 * Clears the path object
 	 */
-	void clear() { _str.clear(); }
+	void clear() {
+		_str.clear();
+		invalidateCache();
+	}
 
 	/**
 	 * Returns the Path for the parent directory of this path.
@@ -338,12 +366,24 @@ public:
 	/**
 	 * Calculate a case insensitive hash of path
 	 */
-	uint hashIgnoreCase() const;
+	uint hashIgnoreCase() const {
+		if (!(_cacheFlags & kHashIgnoreCaseCached)) {
+			_hashIgnoreCase = computeHashIgnoreCase();
+			_cacheFlags |= kHashIgnoreCaseCached;
+		}
+		return _hashIgnoreCase;
+	}
 	/**
 	 * Calculate a hash of path which is case insensitive.
 	 * Ignores case, punycode and Mac path separator.
 	 */
-	uint hashIgnoreCaseAndMac() const;
+	uint hashIgnoreCaseAndMac() const {
+		if (!(_cacheFlags & kHashIgnoreCaseAndMacCached)) {
+			_hashIgnoreCaseAndMac = computeHashIgnoreCaseAndMac();
+			_cacheFlags |= kHashIgnoreCaseAndMacCached;
+		}
+		return _hashIgnoreCaseAndMac;
+	}
 
 	bool operator<(const Path &x) const;
 
@@ -355,6 +395,9 @@ public:
 	/** Assign a given path to this path. */
 	Path &operator=(const Path &path) {
 		_str = path._str;
+		_hashIgnoreCase = path._hashIgnoreCase;
+		_hashIgnoreCaseAndMac = path._hashIgnoreCaseAndMac;
+		_cacheFlags = path._cacheFlags;
 		return *this;
 	}
 
@@ -371,6 +414,7 @@ public:
 	}
 
 	void set(const char *str, char separator = '/') {
+		invalidateCache();
 		if (needsEncoding(str, separator)) {
 			_str = encode(str, separator);
 		} else {
@@ -502,6 +546,7 @@ public:
 	void toLowercase() {
 		// Escapism is not changed by changing case
 		_str.toLowercase();
+		invalidateCache();
 	}
 
 	/**
@@ -513,6 +558,7 @@ public:
 	void toUppercase() {
 		// Escapism is not changed by changing case
 		_str.toUppercase();
+		invalidateCache();
 	}
 
 	/**
@@ -527,6 +573,8 @@ public:
 	 * - dot components are removed:  /foo/./bar -> /foo/bar
 	 * - double dot components are removed:  /foo/baz/../bar -> /foo/bar
 	 *
+	 * Normalizing a path which was returned by normalize() is cheap.
+	 *
 	 * @return      the normalized path
 	 */
 	Path normalize() const;
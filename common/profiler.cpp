@@ -0,0 +1,215 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The profiler is used from any thread, including before the backend is
+// set up, so it can't use the mutexes of the backend.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/profiler.h"
+
+#ifdef USE_PROFILER
+
+#include "common/array.h"
+#include "common/file.h"
+#include "common/path.h"
+#include "common/str.h"
+
+#include <chrono>
+#include <mutex>
+
+namespace Common {
+
+namespace {
+
+enum EventType {
+	kEventZone,
+	kEventCounter,
+	kEventFrame
+};
+
+struct ProfileEvent {
+	const char *name;
+	uint64 time;
+	/** The duration of a zone, or the value of a counter */
+	int64 value;
+	EventType type;
+};
+
+enum {
+	/** The number of events kept for each thread */
+	kBufferSize = 64 * 1024
+};
+
+struct ThreadBuffer {
+	ThreadBuffer(uint threadId) : id(threadId), next(0), count(0) {}
+
+	/** Guards the events, only contended while dumping */
+	std::mutex mutex;
+	uint id;
+	ProfileEvent events[kBufferSize];
+	uint next;
+	uint count;
+};
+
+std::mutex g_buffersMutex;
+// The buffers are never freed, as threads may still record while the
+// program exits
+Array<ThreadBuffer *> *g_buffers = nullptr;
+thread_local ThreadBuffer *t_buffer = nullptr;
+
+const std::chrono::steady_clock::time_point g_startTime = std::chrono::steady_clock::now();
+
+ThreadBuffer *getThreadBuffer() {
+	if (!t_buffer) {
+		std::lock_guard<std::mutex> lock(g_buffersMutex);
+		if (!g_buffers)
+			g_buffers = new Array<ThreadBuffer *>();
+		t_buffer = new ThreadBuffer(g_buffers->size() + 1);
+		g_buffers->push_back(t_buffer);
+	}
+	return t_buffer;
+}
+
+void record(EventType type, const char *name, uint64 time, int64 value) {
+	ThreadBuffer *buffer = getThreadBuffer();
+	std::lock_guard<std::mutex> lock(buffer->mutex);
+
+	ProfileEvent &event = buffer->events[buffer->next];
+	event.name = name;
+	event.time = time;
+	event.value = value;
+	event.type = type;
+
+	buffer->next = (buffer->next + 1) % kBufferSize;
+	if (buffer->count < kBufferSize)
+		buffer->count++;
+}
+
+String escapeName(const char *name) {
+	String result;
+	for (const char *c = name; *c; c++) {
+		if (*c == '"' || *c == '\\')
+			result += '\\';
+		result += *c;
+	}
+	return result;
+}
+
+} // End of anonymous namespace
+
+volatile bool Profiler::_enabled = true;
+
+uint64 Profiler::getTime() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - g_startTime).count();
+}
+
+void Profiler::zone(const char *name, uint64 start) {
+	const uint64 end = getTime();
+	record(kEventZone, name, start, end - start);
+}
+
+void Profiler::counter(const char *name, int64 value) {
+	record(kEventCounter, name, getTime(), value);
+}
+
+void Profiler::frame(const char *name) {
+	record(kEventFrame, name, getTime(), 0);
+}
+
+void Profiler::clear() {
+	std::lock_guard<std::mutex> lock(g_buffersMutex);
+	if (!g_buffers)
+		return;
+
+	for (uint i = 0; i < g_buffers->size(); i++) {
+		ThreadBuffer *buffer = (*g_buffers)[i];
+		std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+		buffer->next = 0;
+		buffer->count = 0;
+	}
+}
+
+int Profiler::dumpTrace(const Path &fileName) {
+	DumpFile file;
+	if (!file.open(fileName, true))
+		return -1;
+
+	file.writeString("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	std::lock_guard<std::mutex> lock(g_buffersMutex);
+	const uint threadCount = g_buffers ? g_buffers->size() : 0;
+	Array<ProfileEvent> events;
+	int written = 0;
+
+	for (uint i = 0; i < threadCount; i++) {
+		ThreadBuffer *buffer = (*g_buffers)[i];
+
+		// Copy the events, so that the thread isn't blocked while they are written
+		{
+			std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+			events.resize(buffer->count);
+			const uint first = (buffer->next + kBufferSize - buffer->count) % kBufferSize;
+			for (uint j = 0; j < buffer->count; j++)
+				events[j] = buffer->events[(first + j) % kBufferSize];
+		}
+
+		file.writeString(String::format("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Thread %u\"}}",
+			written ? ",\n" : "", buffer->id, buffer->id));
+		written++;
+
+		for (uint j = 0; j < events.size(); j++) {
+			const ProfileEvent &event = events[j];
+			const String name = escapeName(event.name);
+			String line;
+
+			switch (event.type) {
+			case kEventZone:
+				line = String::format("{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%lld,\"pid\":1,\"tid\":%u}",
+					name.c_str(), (unsigned long long)event.time, (long long)event.value, buffer->id);
+				break;
+			case kEventCounter:
+				line = String::format("{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%llu,\"pid\":1,\"tid\":%u,\"args\":{\"value\":%lld}}",
+					name.c_str(), (unsigned long long)event.time, buffer->id, (long long)event.value);
+				break;
+			case kEventFrame:
+				line = String::format("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%llu,\"pid\":1,\"tid\":%u}",
+					name.c_str(), (unsigned long long)event.time, buffer->id);
+				break;
+			default:
+				continue;
+			}
+
+			file.writeString(",\n");
+			file.writeString(line);
+			written++;
+		}
+	}
+
+	file.writeString("\n]}\n");
+	file.flush();
+	if (file.err())
+		return -1;
+	return written - threadCount;
+}
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_PROFILER_H
+#define COMMON_PROFILER_H
+
+#include "common/scummsys.h"
+
+/**
+ * @defgroup common_profiler Profiler
+ * @ingroup common
+ *
+ * @brief Low overhead instrumentation of hot code paths.
+ *
+ * The profiler is only built when ScummVM is configured with
+ * --enable-profiler. Otherwise, the macros below expand to nothing, so
+ * instrumentation can stay in the code.
+ *
+ * Each thread records into its own ring buffer, which keeps the most
+ * recent events. The "profile" debugger command writes the buffers as
+ * a Chrome trace file, which can be opened in chrome://tracing or
+ * https://ui.perfetto.dev.
+ *
+ * All names have to be string literals, as only the pointers are
+ * recorded.
+ *
+ * @{
+ */
+
+#ifdef USE_PROFILER
+
+namespace Common {
+
+class Path;
+
+class Profiler {
+public:
+	/** Return the time in microseconds since the profiler started. */
+	static uint64 getTime();
+
+	static bool isEnabled() { return _enabled; }
+
+	/** Start or stop recording. Recording is enabled by default. */
+	static void setEnabled(bool enabled) { _enabled = enabled; }
+
+	/** Record a zone which started at @p start and ends now. */
+	static void zone(const char *name, uint64 start);
+
+	/** Record the value of a counter. */
+	static void counter(const char *name, int64 value);
+
+	/** Mark the start of a new frame. */
+	static void frame(const char *name);
+
+	/** Discard the events recorded so far. */
+	static void clear();
+
+	/**
+	 * Write the recorded events of all threads as a Chrome trace.
+	 *
+	 * @param fileName  The name of the trace file to create.
+	 * @return The number of events written, or -1 if the file could not
+	 *         be created.
+	 */
+	static int dumpTrace(const Path &fileName);
+
+private:
+	static volatile bool _enabled;
+};
+
+/**
+ * Records the time between its construction and destruction as a zone.
+ */
+class ProfileZone {
+public:
+	ProfileZone(const char *name) : _name(Profiler::isEnabled() ? name : nullptr), _start(_name ? Profiler::getTime() : 0) {}
+	~ProfileZone() {
+		if (_name)
+			Profiler::zone(_name, _start);
+	}
+
+private:
+	const char *_name;
+	uint64 _start;
+};
+
+} // End of namespace Common
+
+#define PROFILE_CONCAT_(a, b) a ## b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+/** Record the rest of the enclosing scope as a zone. */
+#define PROFILE_ZONE(name) Common::ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+/** Record the current value of a counter. */
+#define PROFILE_COUNTER(name, value) \
+	do { \
+		if (Common::Profiler::isEnabled()) \
+			Common::Profiler::counter(name, value); \
+	} while (false)
+
+/** Mark the start of a new frame. */
+#define PROFILE_FRAME(name) \
+	do { \
+		if (Common::Profiler::isEnabled()) \
+			Common::Profiler::frame(name); \
+	} while (false)
+
+#else
+
+#define PROFILE_ZONE(name) do {} while (false)
+#define PROFILE_COUNTER(name, value) do {} while (false)
+#define PROFILE_FRAME(name) do {} while (false)
+
+#endif
+
+/** @} */
+
+#endif
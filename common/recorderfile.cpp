@@ -29,7 +29,7 @@
 #include "graphics/surface.h"
 #include "graphics/scaler.h"
 
-#define RECORD_VERSION 1
+#define RECORD_VERSION 2
 
 namespace Common {
 
@@ -133,6 +133,7 @@ bool PlaybackFile::checkPlaybackFileVersion() {
 	_version = _readStream->readUint32BE();
 	switch (_version) {
 	case 1:
+	case 2:
 		break;
 	default:
 		warning("Unknown playback file version %d. Maximum supported version is %d.", _version, RECORD_VERSION);
@@ -389,6 +390,8 @@ void PlaybackFile::readEvent(RecorderEvent& event) {
 		break;
 	case kRecorderEventTypeScreenUpdate:
 		event.time = _tmpPlaybackFile.readUint32BE();
+		if (_version >= 2)
+			event.screenChecksum = _tmpPlaybackFile.readUint32BE();
 		break;
 	default:
 		// fallthrough intended
@@ -578,6 +581,7 @@ void PlaybackFile::writeEvent(const RecorderEvent &event) {
 		break;
 	case kRecorderEventTypeScreenUpdate:
 		_tmpRecordFile.writeUint32BE(event.time);
+		_tmpRecordFile.writeUint32BE(event.screenChecksum);
 		break;
 	default:
 		// fallthrough intended
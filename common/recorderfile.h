@@ -48,10 +48,13 @@ struct RecorderEvent : Event {
 		uint32 time;
 		TimeDate timeDate;
 	};
+	/** CRC32 of the game screen, only set for screen updates */
+	uint32 screenChecksum;
 
 	RecorderEvent() {
 		recordedtype = kRecorderEventTypeNormal;
 		time = 0;
+		screenChecksum = 0;
 		timeDate.tm_sec = 0;
 		timeDate.tm_min = 0;
 		timeDate.tm_hour = 0;
@@ -64,6 +67,7 @@ struct RecorderEvent : Event {
 	RecorderEvent(const Event &e) : Event(e) {
 		recordedtype = kRecorderEventTypeNormal;
 		time = 0;
+		screenChecksum = 0;
 		timeDate.tm_sec = 0;
 		timeDate.tm_min = 0;
 		timeDate.tm_hour = 0;
@@ -159,6 +163,8 @@ public:
 	void addSaveFile(const String &fileName, InSaveFile *saveStream);
 
 	uint32 getVersion() const {return _version;}
+	/** Whether the screen updates of the recording carry screen checksums */
+	bool hasScreenChecksums() const {return _version >= 2;}
 private:
 	Array<byte> _tmpBuffer;
 	WriteStream *_recordFile;
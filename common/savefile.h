@@ -120,6 +120,24 @@ public:
 	int64 size() const override;
 };
 
+/**
+ * Metadata of a save file in the extended save format, see
+ * ExtendedSavegameHeader.
+ *
+ * Save file managers can cache it, so that save lists can be shown without
+ * opening every save file.
+ */
+struct SaveFileMetadata {
+	String description;     /*!< Description of the save. */
+	uint32 saveDate;        /*!< Date of the save, encoded as in the header. */
+	uint16 saveTime;        /*!< Time of the save, encoded as in the header. */
+	uint32 playtime;        /*!< Total play time until the save. */
+	bool isAutosave;        /*!< Whether the save is an autosave. */
+	uint32 thumbnailOffset; /*!< Position of the thumbnail in the uncompressed save. */
+
+	SaveFileMetadata() : saveDate(0), saveTime(0), playtime(0), isAutosave(false), thumbnailOffset(0) {}
+};
+
 /**
  * The SaveFileManager serves as a factory for InSaveFile
  * and OutSaveFile objects.
@@ -248,6 +266,20 @@ public:
 	 */
 	virtual bool copySavefile(const String &oldName, const String &newName, bool compress = true);
 
+	/**
+	 * Move the given save file, replacing any save file with the new name.
+	 *
+	 * Unlike renameSavefile(), the data is moved as it is, without being
+	 * decompressed or compressed, and without copying it.
+	 *
+	 * @param oldName  Old name.
+	 * @param newName  New name.
+	 *
+	 * @return True if the file was moved, false if an error occurred or
+	 *         the backend can't move files.
+	 */
+	virtual bool moveSavefile(const String &oldName, const String &newName) { return false; }
+
 	/**
 	 * List available save files matching a given pattern.
 	 *
@@ -276,6 +308,43 @@ public:
 	 * @return true if the file exists. false otherwise.
 	 */
 	virtual bool exists(const String &name) = 0;
+
+	/**
+	 * Look up the cached metadata of a save file.
+	 *
+	 * The metadata is only returned if the save file did not change since
+	 * it was cached. The default implementation does not cache anything.
+	 *
+	 * @param target    Target the save file belongs to.
+	 * @param name      Name of the save file.
+	 * @param metadata  Set to the cached metadata.
+	 *
+	 * @return true if valid metadata was found, false otherwise.
+	 */
+	virtual bool getSavefileMetadata(const String &target, const String &name, SaveFileMetadata &metadata) { return false; }
+
+	/**
+	 * Cache the metadata of a save file, which has been read from it.
+	 *
+	 * @param target    Target the save file belongs to.
+	 * @param name      Name of the save file.
+	 * @param metadata  The metadata of the save file.
+	 */
+	virtual void setSavefileMetadata(const String &target, const String &name, const SaveFileMetadata &metadata) {}
+
+	/**
+	 * Store cached metadata which changed, so that it can be used the next
+	 * time ScummVM runs.
+	 */
+	virtual void flushSavefileMetadata() {}
+
+	/**
+	 * Forget the cached metadata of a save file, which was written without
+	 * going through the save file manager, e.g. by the cloud sync.
+	 *
+	 * @param name  Name of the save file.
+	 */
+	virtual void invalidateSavefileMetadata(const String &name) {}
 };
 
 /** @} */
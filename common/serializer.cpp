@@ -0,0 +1,128 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/serializer.h"
+#include "common/debug.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+Serializer::~Serializer() {
+	flush();
+}
+
+void Serializer::enableBuffering(uint32 size) {
+	assert(size > 0);
+	flush();
+
+	_buffer = (byte *)malloc(size);
+	if (!_buffer) {
+		warning("Serializer: Could not allocate a buffer of %u bytes", size);
+		return;
+	}
+	_bufferSize = size;
+	_bufferPos = 0;
+	_bufferEnd = 0;
+	_startTime = g_system ? g_system->getMillis() : 0;
+}
+
+void Serializer::flush() {
+	if (!_buffer)
+		return;
+
+	if (_saveStream) {
+		_saveStream->write(_buffer, _bufferPos);
+	} else if (_bufferPos < _bufferEnd) {
+		// Give back the data which was read ahead
+		_loadStream->seek(_loadStream->pos() - (_bufferEnd - _bufferPos));
+	}
+
+	if (g_system && debugLevelSet(2))
+		debug(2, "Serializer: %s %u bytes in %u ms", isSaving() ? "Saved" : "Loaded", _bytesSynced, g_system->getMillis() - _startTime);
+
+	free(_buffer);
+	_buffer = nullptr;
+	_bufferSize = 0;
+	_bufferPos = 0;
+	_bufferEnd = 0;
+}
+
+void Serializer::writeDataSlow(const void *data, uint32 size) {
+	if (!_buffer) {
+		_saveStream->write(data, size);
+		return;
+	}
+
+	_saveStream->write(_buffer, _bufferPos);
+	_bufferPos = 0;
+
+	if (size >= _bufferSize) {
+		_saveStream->write(data, size);
+	} else {
+		memcpy(_buffer, data, size);
+		_bufferPos = size;
+	}
+}
+
+void Serializer::readDataSlow(void *data, uint32 size) {
+	byte *dst = (byte *)data;
+	uint32 done;
+
+	if (!_buffer) {
+		done = _loadStream->read(dst, size);
+	} else {
+		done = _bufferEnd - _bufferPos;
+		memcpy(dst, _buffer + _bufferPos, done);
+		_bufferPos = _bufferEnd = 0;
+
+		if (size - done >= _bufferSize) {
+			done += _loadStream->read(dst + done, size - done);
+		} else {
+			_bufferEnd = _loadStream->read(_buffer, _bufferSize);
+			const uint32 count = MIN(size - done, _bufferEnd);
+			memcpy(dst + done, _buffer, count);
+			_bufferPos = count;
+			done += count;
+		}
+	}
+
+	// Behave like the stream, which returns zero when reading past the end
+	if (done < size)
+		memset(dst + done, 0, size - done);
+}
+
+void Serializer::skipData(uint32 size) {
+	if (!_buffer) {
+		_loadStream->skip(size);
+		return;
+	}
+
+	const uint32 available = _bufferEnd - _bufferPos;
+	if (size <= available) {
+		_bufferPos += size;
+	} else {
+		_bufferPos = _bufferEnd = 0;
+		_loadStream->skip(size - available);
+	}
+}
+
+} // End of namespace Common
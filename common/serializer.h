@@ -22,8 +22,10 @@
 #ifndef COMMON_SERIALIZER_H
 #define COMMON_SERIALIZER_H
 
+#include "common/endian.h"
 #include "common/stream.h"
 #include "common/str.h"
+#include "common/util.h"
 
 namespace Common {
 
@@ -38,20 +40,46 @@ namespace Common {
 
 #define VER(x) Common::Serializer::Version(x)
 
-#define SYNC_AS(SUFFIX,TYPE,SIZE) \
+#define SYNC_AS(SUFFIX,TYPE,SIZE,ENDIAN) \
 	template<typename T> \
 	void syncAs ## SUFFIX(T &val, Version minVersion = 0, Version maxVersion = kLastVersion) { \
 		if (_version < minVersion || _version > maxVersion) \
 			return; \
-		if (_loadStream) \
-			val = static_cast<T>(_loadStream->read ## SUFFIX()); \
-		else { \
+		byte buf[SIZE]; \
+		if (_loadStream) { \
+			readData(buf, SIZE); \
+			val = static_cast<T>(READ_ ## ENDIAN(buf)); \
+		} else { \
 			TYPE tmp = val; \
-			_saveStream->write ## SUFFIX(tmp); \
+			WRITE_ ## ENDIAN(buf, tmp); \
+			writeData(buf, SIZE); \
 		} \
 		_bytesSynced += SIZE; \
 	}
 
+#define SYNC_ARRAY_AS(SUFFIX,TYPE,SIZE,ENDIAN) \
+	template<typename T> \
+	void syncArrayAs ## SUFFIX(T *arr, size_t entries, Version minVersion = 0, Version maxVersion = kLastVersion) { \
+		if (_version < minVersion || _version > maxVersion) \
+			return; \
+		byte buf[kArrayChunkSize]; \
+		for (size_t i = 0; i < entries; i += kArrayChunkSize / SIZE) { \
+			const size_t count = MIN<size_t>(entries - i, kArrayChunkSize / SIZE); \
+			if (_loadStream) { \
+				readData(buf, count * SIZE); \
+				for (size_t j = 0; j < count; j++) \
+					arr[i + j] = static_cast<T>(READ_ ## ENDIAN(buf + j * SIZE)); \
+			} else { \
+				for (size_t j = 0; j < count; j++) { \
+					TYPE tmp = arr[i + j]; \
+					WRITE_ ## ENDIAN(buf + j * SIZE, tmp); \
+				} \
+				writeData(buf, count * SIZE); \
+			} \
+		} \
+		_bytesSynced += entries * SIZE; \
+	}
+
 #define SYNC_PRIMITIVE(suffix) \
 	template <typename T> \
 	static inline void suffix(Serializer &s, T &value) { \
@@ -74,6 +102,11 @@ namespace Common {
  *       for when the array size changed between versions. Also, support for
  *       2D-arrays.
  *
+ * By default, every synced field is passed on to the stream. For large
+ * savestates, enableBuffering() collects the data in a buffer instead, which
+ * is passed on to the stream in large blocks. Arrays of integers or floats
+ * can be synced in one call with the syncArrayAs methods.
+ *
  * @todo Proper error handling!
  */
 class Serializer {
@@ -104,36 +137,167 @@ protected:
 
 	Version _version;
 
+	enum {
+		/** The default size of the buffer used by enableBuffering(). */
+		kDefaultBufferSize = 64 * 1024,
+		/** The number of bytes the syncArrayAs methods convert at once. */
+		kArrayChunkSize = 1024
+	};
+
+	/**
+	 * The buffered data. When saving, the data in [0, _bufferPos) has not
+	 * been written yet. When loading, the data in [_bufferPos, _bufferEnd)
+	 * has been read from the stream, but not synced yet.
+	 */
+	byte *_buffer;
+	uint32 _bufferSize;
+	uint32 _bufferPos;
+	uint32 _bufferEnd;
+
+	/** The time when buffering was enabled, used to report the duration. */
+	uint32 _startTime;
+
+	/** Write data to the buffer, or to the stream if it is not buffered. */
+	void writeData(const void *data, uint32 size) {
+		if (_buffer && _bufferPos + size <= _bufferSize) {
+			memcpy(_buffer + _bufferPos, data, size);
+			_bufferPos += size;
+		} else {
+			writeDataSlow(data, size);
+		}
+	}
+
+	/** Read data from the buffer, or from the stream if it is not buffered. */
+	void readData(void *data, uint32 size) {
+		if (_buffer && _bufferPos + size <= _bufferEnd) {
+			memcpy(data, _buffer + _bufferPos, size);
+			_bufferPos += size;
+		} else {
+			readDataSlow(data, size);
+		}
+	}
+
+	void writeDataSlow(const void *data, uint32 size);
+	void readDataSlow(void *data, uint32 size);
+	void skipData(uint32 size);
+
 public:
 	Serializer(SeekableReadStream *in, WriteStream *out)
-		: _loadStream(in), _saveStream(out), _bytesSynced(0), _version(0) {
+		: _loadStream(in), _saveStream(out), _bytesSynced(0), _version(0),
+		  _buffer(nullptr), _bufferSize(0), _bufferPos(0), _bufferEnd(0), _startTime(0) {
 		assert(in || out);
 	}
-	virtual ~Serializer() {}
+	/** Copying is only possible while buffering is disabled. */
+	Serializer(const Serializer &ser)
+		: _loadStream(ser._loadStream), _saveStream(ser._saveStream), _bytesSynced(ser._bytesSynced), _version(ser._version),
+		  _buffer(nullptr), _bufferSize(0), _bufferPos(0), _bufferEnd(0), _startTime(0) {
+		assert(!ser._buffer);
+	}
+	Serializer &operator=(const Serializer &ser) {
+		// The buffer belongs to a single serializer
+		assert(!_buffer && !ser._buffer);
+		_loadStream = ser._loadStream;
+		_saveStream = ser._saveStream;
+		_bytesSynced = ser._bytesSynced;
+		_version = ser._version;
+		return *this;
+	}
+	virtual ~Serializer();
 
 	inline bool isSaving() { return (_saveStream != 0); }
 	inline bool isLoading() { return (_loadStream != 0); }
 
-	SYNC_AS(Byte, byte, 1)
-	SYNC_AS(SByte, int8, 1)
+	/**
+	 * Collect the synced data in a buffer, which is passed on to the stream
+	 * in blocks of @p size bytes.
+	 *
+	 * While buffering is enabled, the stream must not be accessed directly:
+	 * when saving, it lags behind the synced data, and when loading, its
+	 * position and end-of-stream flag are ahead of them. flush() brings the
+	 * stream up to date, which is also done when the serializer is destroyed.
+	 */
+	void enableBuffering(uint32 size = kDefaultBufferSize);
+
+	/**
+	 * Pass the buffered data on to the stream and disable buffering.
+	 * When loading, the stream is moved back to the first byte which has
+	 * not been synced yet.
+	 */
+	void flush();
+
+	template<typename T>
+	void syncAsByte(T &val, Version minVersion = 0, Version maxVersion = kLastVersion) {
+		if (_version < minVersion || _version > maxVersion)
+			return;
+		byte tmp;
+		if (_loadStream) {
+			readData(&tmp, 1);
+			val = static_cast<T>(tmp);
+		} else {
+			tmp = val;
+			writeData(&tmp, 1);
+		}
+		_bytesSynced++;
+	}
+
+	template<typename T>
+	void syncAsSByte(T &val, Version minVersion = 0, Version maxVersion = kLastVersion) {
+		if (_version < minVersion || _version > maxVersion)
+			return;
+		int8 tmp;
+		if (_loadStream) {
+			readData(&tmp, 1);
+			val = static_cast<T>(tmp);
+		} else {
+			tmp = val;
+			writeData(&tmp, 1);
+		}
+		_bytesSynced++;
+	}
 
-	SYNC_AS(Uint16LE, uint16, 2)
-	SYNC_AS(Uint16BE, uint16, 2)
-	SYNC_AS(Sint16LE, int16, 2)
-	SYNC_AS(Sint16BE, int16, 2)
+	SYNC_AS(Uint16LE, uint16, 2, LE_UINT16)
+	SYNC_AS(Uint16BE, uint16, 2, BE_UINT16)
+	SYNC_AS(Sint16LE, int16, 2, LE_INT16)
+	SYNC_AS(Sint16BE, int16, 2, BE_INT16)
 
-	SYNC_AS(Uint32LE, uint32, 4)
-	SYNC_AS(Uint32BE, uint32, 4)
-	SYNC_AS(Sint32LE, int32, 4)
-	SYNC_AS(Sint32BE, int32, 4)
-	SYNC_AS(FloatLE, float, 4)
-	SYNC_AS(FloatBE, float, 4)
+	SYNC_AS(Uint32LE, uint32, 4, LE_UINT32)
+	SYNC_AS(Uint32BE, uint32, 4, BE_UINT32)
+	SYNC_AS(Sint32LE, int32, 4, LE_INT32)
+	SYNC_AS(Sint32BE, int32, 4, BE_INT32)
+	SYNC_AS(Uint64LE, uint64, 8, LE_UINT64)
+	SYNC_AS(Uint64BE, uint64, 8, BE_UINT64)
+	SYNC_AS(FloatLE, float, 4, LE_FLOAT32)
+	SYNC_AS(FloatBE, float, 4, BE_FLOAT32)
 
-	SYNC_AS(DoubleLE, double, 8)
-	SYNC_AS(DoubleBE, double, 8)
+	SYNC_AS(DoubleLE, double, 8, LE_FLOAT64)
+	SYNC_AS(DoubleBE, double, 8, BE_FLOAT64)
+
+	/**
+	 * @name Array sync methods
+	 * @brief Sync @p entries values of @p arr, like calling the corresponding
+	 *        syncAs method for each of them, but much faster.
+	 * @{
+	 */
+	SYNC_ARRAY_AS(Uint16LE, uint16, 2, LE_UINT16)
+	SYNC_ARRAY_AS(Uint16BE, uint16, 2, BE_UINT16)
+	SYNC_ARRAY_AS(Sint16LE, int16, 2, LE_INT16)
+	SYNC_ARRAY_AS(Sint16BE, int16, 2, BE_INT16)
+
+	SYNC_ARRAY_AS(Uint32LE, uint32, 4, LE_UINT32)
+	SYNC_ARRAY_AS(Uint32BE, uint32, 4, BE_UINT32)
+	SYNC_ARRAY_AS(Sint32LE, int32, 4, LE_INT32)
+	SYNC_ARRAY_AS(Sint32BE, int32, 4, BE_INT32)
+	SYNC_ARRAY_AS(FloatLE, float, 4, LE_FLOAT32)
+	SYNC_ARRAY_AS(FloatBE, float, 4, BE_FLOAT32)
+
+	SYNC_ARRAY_AS(DoubleLE, double, 8, LE_FLOAT64)
+	SYNC_ARRAY_AS(DoubleBE, double, 8, BE_FLOAT64)
+	/** @} */
 
 	/**
 	 * Returns true if an I/O failure occurred.
+	 * When saving with buffering enabled, errors only show up once the
+	 * buffered data is written.
 	 * This flag is never cleared automatically. In order to clear it,
 	 * client code has to call clearErr() explicitly.
 	 */
@@ -191,10 +355,11 @@ public:
 
 		_bytesSynced += size;
 		if (isLoading())
-			_loadStream->skip(size);
+			skipData(size);
 		else {
+			const byte zero = 0;
 			while (size--)
-				_saveStream->writeByte(0);
+				writeData(&zero, 1);
 		}
 	}
 
@@ -206,9 +371,9 @@ public:
 			return; // Ignore anything which is not supposed to be present in this save game version
 
 		if (isLoading())
-			_loadStream->read(buf, size);
+			readData(buf, size);
 		else
-			_saveStream->write(buf, size);
+			writeData(buf, size);
 		_bytesSynced += size;
 	}
 
@@ -230,11 +395,11 @@ public:
 
 		bool match;
 		if (isSaving()) {
-			_saveStream->write(magic, size);
+			writeData(magic, size);
 			match = true;
 		} else {
 			char buf[256];
-			_loadStream->read(buf, size);
+			readData(buf, size);
 			match = (0 == memcmp(buf, magic, size));
 		}
 		_bytesSynced += size;
@@ -252,14 +417,13 @@ public:
 		if (isLoading()) {
 			char c;
 			str.clear();
-			while ((c = _loadStream->readByte())) {
+			for (readData(&c, 1); c; readData(&c, 1)) {
 				str += c;
 				_bytesSynced++;
 			}
 			_bytesSynced++;
 		} else {
-			_saveStream->writeString(str);
-			_saveStream->writeByte(0);
+			writeData(str.c_str(), str.size() + 1);
 			_bytesSynced += str.size() + 1;
 		}
 	}
@@ -282,9 +446,10 @@ public:
 			str = U32String(sl, len);
 			delete[] sl;
 		} else {
-			for (uint i = 0; i < len; i++)
-				_saveStream->writeUint32LE(str[i]);
-			_bytesSynced += 4 * len;
+			for (uint i = 0; i < len; i++) {
+				uint32 c = str[i];
+				syncAsUint32LE(c);
+			}
 		}
 	}
 
@@ -301,6 +466,7 @@ public:
 
 #undef SYNC_PRIMITIVE
 #undef SYNC_AS
+#undef SYNC_ARRAY_AS
 
 
 // Mixin class / interface
@@ -23,6 +23,7 @@
 #include "engines/dialogs.h"
 #include "engines/util.h"
 #include "engines/metaengine.h"
+#include "engines/savewriter.h"
 
 #include "common/config-manager.h"
 #include "common/events.h"
@@ -147,6 +148,7 @@ Engine::Engine(OSystem *syst)
 		_pauseStartTime(0),
 		_saveSlotToLoad(-1),
 		_autoSaving(false),
+		_saveWriter(nullptr),
 		_engineStartTime(_system->getMillis()),
 		_mainMenuDialog(NULL),
 		_debugger(NULL),
@@ -196,6 +198,10 @@ Engine::Engine(OSystem *syst)
 }
 
 Engine::~Engine() {
+	// Make sure a pending autosave is not lost
+	delete _saveWriter;
+	_saveWriter = nullptr;
+
 	_mixer->stopAll();
 
 	// Flush any pending remaining events
@@ -592,6 +598,19 @@ void Engine::warnMissingExtractedCDAudio() {
 }
 
 void Engine::handleAutoSave() {
+	if (_saveWriter) {
+		SaveWriter::Result result;
+		while (_saveWriter->poll(result)) {
+			if (result.error.getCode() != Common::kNoError) {
+				warning("Writing autosave failed: %s", result.error.getDesc().c_str());
+				g_system->displayMessageOnOSD(_("Error occurred making autosave"));
+
+				// Try again in 5 minutes, as when the autosave could not be made
+				_lastAutosaveTime = _system->getMillis() + ((5 * 60 - _autosaveInterval) * 1000);
+			}
+		}
+	}
+
 #ifdef ENABLE_EVENTRECORDER
 	if (!g_eventRec.processAutosave())
 		return;
@@ -653,8 +672,10 @@ void Engine::saveAutosaveIfEnabled() {
 	const Common::String autoSaveName = Common::convertFromU32String(_("Autosave"));
 
 	// First check for an existing savegame in the slot, and if present, if it's an autosave
-	if (saveFlag)
+	if (saveFlag) {
+		flushPendingSaves();
 		saveFlag = warnBeforeOverwritingAutosave();
+	}
 
 	if (saveFlag && saveGameState(autoSaveSlot, autoSaveName, true).getCode() != Common::kNoError) {
 		// Couldn't autosave at the designated time
@@ -716,6 +737,7 @@ void Engine::openMainMenuDialog() {
 	}
 
 	setGameToLoadSlot(-1);
+	flushPendingSaves();
 
 	bool hasVKeyb = g_system->getFeatureState(OSystem::kFeatureVirtualKeyboard);
 	if (hasVKeyb)
@@ -869,6 +891,7 @@ void Engine::flipMute() {
 Common::Error Engine::loadGameState(int slot) {
 	// In case autosaves are on, do a save first before loading the new save
 	saveAutosaveIfEnabled();
+	flushPendingSaves();
 
 	Common::InSaveFile *saveFile = _saveFileMan->openForLoading(getSaveStateName(slot));
 
@@ -897,6 +920,27 @@ bool Engine::canLoadGameStateCurrently(Common::U32String *msg) {
 }
 
 Common::Error Engine::saveGameState(int slot, const Common::String &desc, bool isAutosave) {
+	if (isAutosave) {
+		// Serializing to memory is fast, compressing and writing the save
+		// is done in the background
+		Common::MemoryWriteStreamDynamic *data = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::Error result = saveGameStream(data, isAutosave);
+		if (result.getCode() != Common::kNoError) {
+			delete data;
+			return result;
+		}
+
+		getMetaEngine()->appendExtendedSaveToStream(data, getTotalPlayTime(), desc, isAutosave);
+
+		if (!_saveWriter)
+			_saveWriter = new SaveWriter(_saveFileMan);
+		_saveWriter->queue(getSaveStateName(slot), data);
+		return result;
+	}
+
+	// Keep the saves in order
+	flushPendingSaves();
+
 	Common::OutSaveFile *saveFile = _saveFileMan->openForSaving(getSaveStateName(slot));
 
 	if (!saveFile)
@@ -913,6 +957,17 @@ Common::Error Engine::saveGameState(int slot, const Common::String &desc, bool i
 	return result;
 }
 
+void Engine::flushPendingSaves() {
+	if (!_saveWriter)
+		return;
+
+	Common::Error error = _saveWriter->flush();
+	if (error.getCode() != Common::kNoError) {
+		warning("Writing autosave failed: %s", error.getDesc().c_str());
+		g_system->displayMessageOnOSD(_("Error occurred making autosave"));
+	}
+}
+
 Common::Error Engine::saveGameStream(Common::WriteStream *stream, bool isAutosave) {
 	// Default to returning an error when not implemented
 	return Common::kWritingFailed;
@@ -929,6 +984,8 @@ bool Engine::loadGameDialog() {
 		return false;
 	}
 
+	flushPendingSaves();
+
 	GUI::SaveLoadChooser *dialog = new GUI::SaveLoadChooser(_("Load game:"), _("Load"), false);
 
 	int slotNum;
@@ -958,6 +1015,8 @@ bool Engine::saveGameDialog() {
 		return false;
 	}
 
+	flushPendingSaves();
+
 	GUI::SaveLoadChooser *dialog = new GUI::SaveLoadChooser(_("Save game:"), _("Save"), true);
 	int slotNum;
 	{
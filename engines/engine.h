@@ -32,6 +32,7 @@
 class OSystem;
 class MetaEngineDetection;
 class MetaEngine;
+class SaveWriter;
 
 namespace Audio {
 class Mixer;
@@ -229,6 +230,11 @@ private:
 	 */
 	bool _autoSaving;
 
+	/**
+	 * Writes autosaves in the background. Created with the first autosave.
+	 */
+	SaveWriter *_saveWriter;
+
 	/**
 	 * Optional debugger for the engine.
 	 */
@@ -460,10 +466,23 @@ public:
 	 * @param desc        Description for the save state, entered by the user.
 	 * @param isAutosave  Expected to be true if an autosave is being created.
 	 *
+	 * The default implementation writes autosaves in the background. The
+	 * save is serialized with saveGameStream() right away, but compressing
+	 * and writing it is done later, so errors writing it are only reported
+	 * on the OSD.
+	 *
 	 * @return kNoError on success, otherwise an error code.
 	 */
 	virtual Common::Error saveGameState(int slot, const Common::String &desc, bool isAutosave = false);
 
+	/**
+	 * Finish writing saves which are still being written in the background.
+	 *
+	 * This is done before saves are loaded or listed by the global main
+	 * menu. Engines that read save files on their own should call it first.
+	 */
+	void flushPendingSaves();
+
 	/**
 	 * Save a game state.
 	 *
@@ -325,6 +325,8 @@ WARN_UNUSED_RESULT bool MetaEngine::readSavegameHeader(Common::InSaveFile *in, E
 	// Get the flag for whether it's an autosave
 	header->isAutosave = (header->version >= 4) ? in->readByte() : false;
 
+	header->thumbnailOffset = in->pos();
+
 	// Get the thumbnail
 	if (!Graphics::loadThumbnail(*in, header->thumbnail, skipThumbnail)) {
 		in->seek(oldPos, SEEK_SET); // Rewind the file
@@ -382,6 +384,9 @@ SaveStateList MetaEngine::listSaves(const char *target) const {
 		}
 	}
 
+	// Keep the metadata read from the saves for the next time
+	saveFileMan->flushSavefileMetadata();
+
 	// Sort saves based on slot number.
 	Common::sort(saveList.begin(), saveList.end(), SaveStateDescriptorSlotComparator());
 	return saveList;
@@ -446,22 +451,38 @@ SaveStateDescriptor MetaEngine::querySaveMetaInfos(const char *target, int slot)
 	if (!hasFeature(kSavesUseExtendedFormat))
 		return SaveStateDescriptor();
 
-	Common::ScopedPtr<Common::InSaveFile> f(g_system->getSavefileManager()->openForLoading(
-		getSavegameFile(slot, target)));
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	const Common::String filename = getSavegameFile(slot, target);
+
+	Common::SaveFileMetadata metadata;
+	if (!saveFileMan->getSavefileMetadata(target, filename, metadata)) {
+		Common::ScopedPtr<Common::InSaveFile> f(saveFileMan->openForLoading(filename));
+		if (!f)
+			return SaveStateDescriptor();
 
-	if (f) {
 		ExtendedSavegameHeader header;
-		if (!readSavegameHeader(f.get(), &header, false)) {
+		if (!readSavegameHeader(f.get(), &header, true))
 			return SaveStateDescriptor();
-		}
 
-		// Create the return descriptor
-		SaveStateDescriptor desc(this, slot, Common::U32String());
-		parseSavegameHeader(&header, &desc);
-		desc.setThumbnail(header.thumbnail);
-		desc.setAutosave(header.isAutosave);
-		return desc;
+		metadata.description = header.description;
+		metadata.saveDate = header.date;
+		metadata.saveTime = header.time;
+		metadata.playtime = header.playtime;
+		metadata.isAutosave = header.isAutosave;
+		metadata.thumbnailOffset = header.thumbnailOffset;
+		saveFileMan->setSavefileMetadata(target, filename, metadata);
 	}
 
-	return SaveStateDescriptor();
+	ExtendedSavegameHeader header;
+	header.description = metadata.description;
+	header.date = metadata.saveDate;
+	header.time = metadata.saveTime;
+	header.playtime = metadata.playtime;
+
+	// Create the return descriptor
+	SaveStateDescriptor desc(this, slot, Common::U32String());
+	parseSavegameHeader(&header, &desc);
+	desc.setThumbnailFromSave(filename, metadata.thumbnailOffset);
+	desc.setAutosave(metadata.isAutosave);
+	return desc;
 }
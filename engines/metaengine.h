@@ -114,6 +114,7 @@ struct ExtendedSavegameHeader {
 	uint32 playtime;              /*!< Total play time until this savegame. */
 	Graphics::Surface *thumbnail; /*!< Screen content shown as a thumbnail for this savegame. */
 	bool isAutosave;              /*!< Whether this savegame is an autosave. */
+	uint32 thumbnailOffset;       /*!< Position of the thumbnail in the savegame. */
 
 	ExtendedSavegameHeader() {
 		memset(id, 0, 6);
@@ -123,6 +124,7 @@ struct ExtendedSavegameHeader {
 		playtime = 0;
 		thumbnail = nullptr;
 		isAutosave = false;
+		thumbnailOffset = 0;
 	}
 };
 
@@ -340,6 +342,11 @@ public:
 	 * Depending on the MetaEngineFeatures set, this can include
 	 * thumbnails, save date and time, play time.
 	 *
+	 * The default implementation reads saves in the extended format. The
+	 * header of a save is only read when the save file manager has no
+	 * cached metadata for it, and the thumbnail is only loaded when it is
+	 * requested from the returned descriptor.
+	 *
 	 * @param target  Name of a config manager target.
 	 * @param slot    Slot number of the save state.
 	 */
@@ -23,7 +23,11 @@
 #include "engines/engine.h"
 #include "engines/metaengine.h"
 #include "graphics/surface.h"
+#include "graphics/thumbnail.h"
 #include "common/config-manager.h"
+#include "common/ptr.h"
+#include "common/savefile.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 
@@ -31,16 +35,16 @@ SaveStateDescriptor::SaveStateDescriptor()
 	// FIXME: default to 0 (first slot) or to -1 (invalid slot) ?
 	: _slot(-1), _description(), _isDeletable(true), _isWriteProtected(false),
 	  _isLocked(false), _saveDate(), _saveTime(), _playTime(), _playTimeMSecs(0),
-	_thumbnail(), _saveType(kSaveTypeUndetermined) {
+	_thumbnail(), _thumbnailOffset(0), _saveType(kSaveTypeUndetermined) {
 }
 
 SaveStateDescriptor::SaveStateDescriptor(const MetaEngine *metaEngine, int slot, const Common::U32String &d)
-	: _slot(slot), _description(d), _isLocked(false), _playTimeMSecs(0), _saveType(kSaveTypeUndetermined) {
+	: _slot(slot), _description(d), _isLocked(false), _playTimeMSecs(0), _thumbnailOffset(0), _saveType(kSaveTypeUndetermined) {
 	initSaveSlot(metaEngine);
 }
 
 SaveStateDescriptor::SaveStateDescriptor(const MetaEngine *metaEngine, int slot, const Common::String &d)
-	: _slot(slot), _description(Common::U32String(d)), _isLocked(false), _playTimeMSecs(0), _saveType(kSaveTypeUndetermined) {
+	: _slot(slot), _description(Common::U32String(d)), _isLocked(false), _playTimeMSecs(0), _thumbnailOffset(0), _saveType(kSaveTypeUndetermined) {
 	initSaveSlot(metaEngine);
 }
 
@@ -59,13 +63,34 @@ void SaveStateDescriptor::initSaveSlot(const MetaEngine *metaEngine) {
 	}
 }
 
+const Graphics::Surface *SaveStateDescriptor::getThumbnail() const {
+	if (!_thumbnail && !_thumbnailFile.empty()) {
+		Common::ScopedPtr<Common::InSaveFile> file(g_system->getSavefileManager()->openForLoading(_thumbnailFile));
+		Graphics::Surface *thumbnail = nullptr;
+		if (file && file->seek(_thumbnailOffset) && Graphics::loadThumbnail(*file, thumbnail) && thumbnail)
+			_thumbnail = Common::SharedPtr<Graphics::Surface>(thumbnail, Graphics::SurfaceDeleter());
+
+		// Only try once
+		_thumbnailFile.clear();
+	}
+
+	return _thumbnail.get();
+}
+
 void SaveStateDescriptor::setThumbnail(Graphics::Surface *t) {
+	_thumbnailFile.clear();
 	if (_thumbnail.get() == t)
 		return;
 
 	_thumbnail = Common::SharedPtr<Graphics::Surface>(t, Graphics::SurfaceDeleter());
 }
 
+void SaveStateDescriptor::setThumbnailFromSave(const Common::String &fileName, uint32 offset) {
+	_thumbnail.reset();
+	_thumbnailFile = fileName;
+	_thumbnailOffset = offset;
+}
+
 void SaveStateDescriptor::setSaveDate(int year, int month, int day) {
 	_saveDate = Common::String::format("%.4d-%.2d-%.2d", year, month, day);
 }
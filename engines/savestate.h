@@ -134,7 +134,7 @@ public:
 	 * should be either 160x100 or 160x120 pixels, depending on the aspect
 	 * ratio of the game. If another ratio is required, contact the core team.
 	 */
-	const Graphics::Surface *getThumbnail() const { return _thumbnail.get(); }
+	const Graphics::Surface *getThumbnail() const;
 
 	/**
 	 * Set a thumbnail graphics surface representing the savestate visually.
@@ -142,7 +142,16 @@ public:
 	 * Hence the caller must not delete the surface.
 	 */
 	void setThumbnail(Graphics::Surface *t);
-	void setThumbnail(Common::SharedPtr<Graphics::Surface> t) { _thumbnail = t; }
+	void setThumbnail(Common::SharedPtr<Graphics::Surface> t) { _thumbnail = t; _thumbnailFile.clear(); }
+
+	/**
+	 * Set the thumbnail to be loaded from a save file in the extended
+	 * format, when it is requested for the first time.
+	 *
+	 * @param fileName  Name of the save file.
+	 * @param offset    Position of the thumbnail in the save file.
+	 */
+	void setThumbnailFromSave(const Common::String &fileName, uint32 offset);
 
 	/**
 	 * Sets the date the save state was created.
@@ -276,7 +285,13 @@ private:
 	/**
 	 * The thumbnail of the save state.
 	 */
-	Common::SharedPtr<Graphics::Surface> _thumbnail;
+	mutable Common::SharedPtr<Graphics::Surface> _thumbnail;
+
+	/**
+	 * The save file to load the thumbnail from, see setThumbnailFromSave().
+	 */
+	mutable Common::String _thumbnailFile;
+	uint32 _thumbnailOffset;
 
 	/**
 	 * Save file type
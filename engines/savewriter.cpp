@@ -0,0 +1,243 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engines/savewriter.h"
+
+#include "common/compression/deflate.h"
+#include "common/memstream.h"
+#include "common/savefile.h"
+#include "common/system.h"
+#include "common/timer.h"
+
+SaveWriter::SaveWriter(Common::SaveFileManager *saveFileMan) : _saveFileMan(saveFileMan) {
+	g_system->getTimerManager()->installTimerProc(&timerProc, 10000, this, "SaveWriter");
+}
+
+SaveWriter::~SaveWriter() {
+	Common::Error error = flush();
+	if (error.getCode() != Common::kNoError)
+		warning("SaveWriter: %s", error.getDesc().c_str());
+
+	g_system->getTimerManager()->removeTimerProc(&timerProc);
+}
+
+void SaveWriter::queue(const Common::String &fileName, Common::MemoryWriteStreamDynamic *data, bool compress) {
+	Job *job = new Job();
+	job->fileName = fileName;
+	job->failed = false;
+	job->input = data;
+	job->output = nullptr;
+	job->compressor = nullptr;
+	job->compressed = nullptr;
+	job->file = nullptr;
+	job->data = data->getData();
+	job->size = data->size();
+	job->pos = 0;
+
+	if (compress) {
+		// The compressor takes ownership of the output stream. The data
+		// is kept alive, so that it can be written after the compressor
+		// has been deleted.
+		job->output = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		job->compressor = Common::wrapCompressedWriteStream(job->output);
+		job->state = kStateCompressing;
+	} else {
+		job->state = kStateCompressed;
+	}
+
+	Common::StackLock lock(_mutex);
+	_jobs.push_back(job);
+}
+
+bool SaveWriter::isBusy() const {
+	Common::StackLock lock(_mutex);
+	return !_jobs.empty();
+}
+
+bool SaveWriter::poll(Result &result) {
+	Job *job;
+	State state;
+	{
+		Common::StackLock lock(_mutex);
+		if (_jobs.empty())
+			return false;
+		job = _jobs.front();
+		state = job->state;
+	}
+
+	if (state == kStateCompressed)
+		state = openFile(job, getTempName(job), kStateWriting);
+	else if (state == kStateWriting || state == kStateReplacing)
+		state = write(job);
+
+	if (state != kStateDone)
+		return false;
+
+	result.fileName = job->fileName;
+	if (job->failed)
+		result.error = Common::Error(Common::kWritingFailed, job->fileName);
+	else
+		result.error = Common::Error(Common::kNoError);
+
+	{
+		Common::StackLock lock(_mutex);
+		_jobs.pop_front();
+	}
+	deleteJob(job);
+	return true;
+}
+
+Common::Error SaveWriter::flush() {
+	Common::Error error(Common::kNoError);
+
+	while (isBusy()) {
+		step();
+
+		Result result;
+		if (poll(result) && error.getCode() == Common::kNoError)
+			error = result.error;
+	}
+
+	return error;
+}
+
+void SaveWriter::timerProc(void *refCon) {
+	static_cast<SaveWriter *>(refCon)->step();
+}
+
+void SaveWriter::step() {
+	Common::StackLock stepLock(_stepMutex);
+
+	Job *job;
+	State state;
+	{
+		Common::StackLock lock(_mutex);
+		if (_jobs.empty())
+			return;
+		job = _jobs.front();
+		state = job->state;
+	}
+
+	if (state == kStateCompressing)
+		compress(job);
+}
+
+void SaveWriter::compress(Job *job) {
+	const uint32 chunk = MIN<uint32>(kStepSize, job->size - job->pos);
+	job->compressor->write(job->data + job->pos, chunk);
+	job->pos += chunk;
+
+	bool failed = job->compressor->err();
+	const bool finished = failed || job->pos == job->size;
+	if (finished) {
+		if (!failed) {
+			job->compressor->finalize();
+			failed = job->compressor->err();
+		}
+
+		job->compressed = job->output->getData();
+		job->data = job->compressed;
+		job->size = job->output->size();
+		job->pos = 0;
+
+		delete job->compressor;
+		job->compressor = nullptr;
+		job->output = nullptr;
+	}
+
+	Common::StackLock lock(_mutex);
+	if (failed) {
+		job->failed = true;
+		job->state = kStateDone;
+	} else if (finished) {
+		job->state = kStateCompressed;
+	}
+}
+
+SaveWriter::State SaveWriter::write(Job *job) {
+	const uint32 chunk = MIN<uint32>(kStepSize, job->size - job->pos);
+	job->file->write(job->data + job->pos, chunk);
+	job->pos += chunk;
+
+	bool failed = job->file->err();
+	const bool finished = failed || job->pos == job->size;
+	if (!finished)
+		return job->state;
+
+	if (!failed) {
+		job->file->finalize();
+		failed = job->file->err();
+	}
+
+	delete job->file;
+	job->file = nullptr;
+
+	return finishFile(job, failed);
+}
+
+SaveWriter::State SaveWriter::finishFile(Job *job, bool failed) {
+	const Common::String tempName = getTempName(job);
+
+	if (job->state == kStateWriting && !failed) {
+		// Only replace the existing save once the new one is complete
+		if (_saveFileMan->moveSavefile(tempName, job->fileName)) {
+			Common::StackLock lock(_mutex);
+			job->state = kStateDone;
+			return kStateDone;
+		}
+
+		// The data is still there, so write it again instead of copying
+		// the temporary file, which would decompress and compress it
+		job->pos = 0;
+		return openFile(job, job->fileName, kStateReplacing);
+	}
+
+	_saveFileMan->removeSavefile(tempName);
+
+	Common::StackLock lock(_mutex);
+	job->failed = failed;
+	job->state = kStateDone;
+	return kStateDone;
+}
+
+SaveWriter::State SaveWriter::openFile(Job *job, const Common::String &fileName, State state) {
+	// The data has already been compressed, if requested
+	job->file = _saveFileMan->openForSaving(fileName, false);
+	if (!job->file)
+		return finishFile(job, true);
+
+	Common::StackLock lock(_mutex);
+	job->state = state;
+	return state;
+}
+
+Common::String SaveWriter::getTempName(const Job *job) {
+	// Hidden files are not synced to the cloud
+	return "." + job->fileName + ".tmp";
+}
+
+void SaveWriter::deleteJob(Job *job) {
+	delete job->file;
+	delete job->compressor;
+	free(job->compressed);
+	delete job->input;
+	delete job;
+}
@@ -0,0 +1,174 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ENGINES_SAVEWRITER_H
+#define ENGINES_SAVEWRITER_H
+
+#include "common/error.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/str.h"
+
+namespace Common {
+class MemoryWriteStreamDynamic;
+class OutSaveFile;
+class SaveFileManager;
+class WriteStream;
+}
+
+/**
+ * @defgroup engines_savewriter Background save writer
+ * @ingroup engines
+ *
+ * @brief Writes save files without stalling the engine.
+ * @{
+ */
+
+/**
+ * Compresses save files in a timer callback and writes them in steps.
+ *
+ * The engine serializes its state into memory, which is fast, and passes
+ * the data to queue(). The data is compressed in small steps from a timer
+ * callback. Once the compressed data is complete, poll() writes it to a
+ * hidden temporary save file, again in small steps. Only after that file
+ * has been finalized successfully, it is moved over the existing save. So
+ * an existing save stays untouched if the new one cannot be written.
+ *
+ * If the save file manager can't move files, the data is written to the
+ * save file itself in small steps as well, and the temporary file is
+ * removed afterwards.
+ *
+ * The save file manager is only used from the thread calling the methods
+ * of the writer, usually the engine thread. poll() has to be called
+ * regularly to write the save files and to collect the results.
+ *
+ * Saves are written in the order they were queued. flush() writes all
+ * pending saves immediately, which has to be done before reading save
+ * files, and is done when the writer is destroyed.
+ */
+class SaveWriter {
+public:
+	/**
+	 * The outcome of a save written in the background.
+	 */
+	struct Result {
+		Common::String fileName;
+		Common::Error error;
+	};
+
+	SaveWriter(Common::SaveFileManager *saveFileMan);
+	~SaveWriter();
+
+	/**
+	 * Queue a save to be written in the background.
+	 *
+	 * @param fileName  The name of the save file.
+	 * @param data      The serialized save. The writer takes ownership
+	 *                  of it.
+	 * @param compress  Whether the save should be compressed.
+	 */
+	void queue(const Common::String &fileName, Common::MemoryWriteStreamDynamic *data, bool compress = true);
+
+	/**
+	 * Check whether there are saves which have not been written yet.
+	 */
+	bool isBusy() const;
+
+	/**
+	 * Write the next step of the pending saves and collect the result of
+	 * a finished one.
+	 *
+	 * @param result  Set to the result of a finished save.
+	 * @return True if a save finished, false otherwise.
+	 */
+	bool poll(Result &result);
+
+	/**
+	 * Write all pending saves immediately.
+	 *
+	 * @return The first error which occurred, or kNoError.
+	 */
+	Common::Error flush();
+
+private:
+	enum State {
+		kStateCompressing,
+		kStateCompressed,
+		kStateWriting,
+		kStateReplacing,
+		kStateDone
+	};
+
+	enum {
+		/**
+		 * The amount of data compressed in one timer callback or written
+		 * in one call to poll(). This keeps the timer thread responsive
+		 * for other callbacks, like music drivers, and avoids stalling
+		 * the engine.
+		 */
+		kStepSize = 128 * 1024
+	};
+
+	struct Job {
+		Common::String fileName;
+		State state;
+		bool failed;
+
+		Common::MemoryWriteStreamDynamic *input;
+		Common::MemoryWriteStreamDynamic *output;
+		Common::WriteStream *compressor;
+		byte *compressed;
+		Common::OutSaveFile *file;
+
+		/** The data to compress or write, and how much of it is done. */
+		const byte *data;
+		uint32 size;
+		uint32 pos;
+	};
+
+	static void timerProc(void *refCon);
+	void step();
+	void compress(Job *job);
+	State write(Job *job);
+	State finishFile(Job *job, bool failed);
+	State openFile(Job *job, const Common::String &fileName, State state);
+	void deleteJob(Job *job);
+
+	/** The name of the save file a job writes to before replacing the save. */
+	static Common::String getTempName(const Job *job);
+
+	Common::SaveFileManager *_saveFileMan;
+
+	/**
+	 * The pending saves. The list and the states of the jobs are guarded
+	 * by _mutex. A job in kStateCompressing belongs to step(), the others
+	 * belong to the thread using the writer.
+	 */
+	Common::List<Job *> _jobs;
+	mutable Common::Mutex _mutex;
+
+	/** Makes sure only one thread executes step(). */
+	Common::Mutex _stepMutex;
+};
+
+/** @} */
+
+#endif
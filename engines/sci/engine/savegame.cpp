@@ -1258,12 +1258,17 @@ bool gamestate_save(EngineState *s, Common::WriteStream *fh, const Common::Strin
 	}
 
 	set_savegame_metadata(ser, fh, savename, ver);
+
+	// The game state consists of lots of small fields, so don't pass them
+	// to the (compressing) stream one by one
+	ser.enableBuffering();
 	s->saveLoadWithSerializer(ser);		// FIXME: Error handling?
 	if (g_sci->_gfxPorts)
 		g_sci->_gfxPorts->saveLoadWithSerializer(ser);
 	Vocabulary *voc = g_sci->getVocabulary();
 	if (voc)
 		voc->saveLoadWithSerializer(ser);
+	ser.flush();
 
 	// TODO: SSCI (at least JonesCD, presumably more) also stores the Menu state
 
@@ -1497,6 +1502,7 @@ void gamestate_restore(EngineState *s, Common::SeekableReadStream *fh) {
 	}
 
 	s->reset(true);
+	ser.enableBuffering();
 	s->saveLoadWithSerializer(ser);	// FIXME: Error handling?
 
 	// Now copy all current state information
@@ -28,6 +28,7 @@
 #include "common/endian.h"
 
 #include "audio/mixer.h"
+#include "audio/rendercache.h"
 
 #include "scumm/imuse/imuse.h"
 #include "scumm/imuse/imuse_internal.h"
@@ -292,6 +293,50 @@ MidiDriver *IMuseInternal::getBestMidiDriver(int sound) {
 	return driver;
 }
 
+void IMuseInternal::startRenderCacheSong(int sound) {
+	if (!Audio::RenderCache::isEnabled())
+		return;
+
+	MidiDriver *driver;
+	uint32 hash;
+	{
+		Common::StackLock lock(_mutex);
+
+		// Only a song started while nothing else plays sounds the same
+		// every time. Songs started on top of others are simply part of
+		// the song which is being cached already.
+		const Player *player = _players;
+		for (int i = ARRAYSIZE(_players); i; i--, player++) {
+			if (player->isActive())
+				return;
+		}
+
+		if (!findStartOfSound(sound))
+			return;
+
+		driver = getBestMidiDriver(sound);
+		if (!driver)
+			return;
+
+		const ResourceManager::Resource &res = g_scumm->_res->_types[rtSound][sound];
+		hash = Audio::RenderCache::hashSongData(res._address, res._size);
+	}
+
+	// This opens the cache files, so it must not be done while holding
+	// the mixer lock
+	driver->property(MidiDriver::PROP_RENDER_CACHE_SONG, hash ? hash : 1);
+}
+
+void IMuseInternal::stopRenderCacheSong() {
+	if (!Audio::RenderCache::isEnabled())
+		return;
+
+	if (_midi_adlib)
+		_midi_adlib->property(MidiDriver::PROP_RENDER_CACHE_SONG, 0);
+	if (_midi_native)
+		_midi_native->property(MidiDriver::PROP_RENDER_CACHE_SONG, 0);
+}
+
 Player *IMuseInternal::allocate_player(byte priority) {
 	Player *player = _players, *best = nullptr;
 	int i;
@@ -522,6 +567,8 @@ void IMuseInternal::setMusicVolume(int vol) {
 }
 
 void IMuseInternal::startSound(int sound) {
+	startRenderCacheSong(sound);
+
 	Common::StackLock lock(_mutex);
 	startSound_internal(sound);
 }
@@ -532,8 +579,13 @@ void IMuseInternal::stopSound(int sound) {
 }
 
 void IMuseInternal::stopAllSounds() {
-	Common::StackLock lock(_mutex);
-	stopAllSounds_internal();
+	{
+		Common::StackLock lock(_mutex);
+		stopAllSounds_internal();
+	}
+
+	// There is nothing left to cache
+	stopRenderCacheSong();
 }
 
 int IMuseInternal::getSoundStatus(int sound) const {
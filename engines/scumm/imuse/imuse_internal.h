@@ -508,6 +508,8 @@ protected:
 	void sequencer_timers(MidiDriver *midi);
 
 	MidiDriver *getBestMidiDriver(int sound);
+	void startRenderCacheSong(int sound);
+	void stopRenderCacheSong();
 	Player *allocate_player(byte priority);
 	Part *allocate_part(byte pri, MidiDriver *midi);
 
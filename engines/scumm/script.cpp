@@ -20,6 +20,7 @@
  */
 
 #include "common/config-manager.h"
+#include "common/debug-channels.h"
 #include "common/util.h"
 #include "common/system.h"
 
@@ -470,11 +471,13 @@ void ScummEngine::executeScript() {
 		_opcode = fetchScriptByte();
 		if (_game.version > 2) // V0-V2 games didn't use the didexec flag
 			vm.slot[_currentScript].didexec = true;
-		debugC(DEBUG_OPCODES, "Script %d, offset 0x%x: [%X] %s()",
-				vm.slot[_currentScript].number,
-				(uint)(_scriptPointer - _scriptOrgPointer),
-				_opcode,
-				getOpcodeDesc(_opcode));
+		// Avoid looking up the opcode description unless it is printed
+		if (DebugMan.isDebugChannelEnabled(DEBUG_OPCODES) || gDebugLevel >= 9)
+			debugC(DEBUG_OPCODES, "Script %d, offset 0x%x: [%X] %s()",
+					vm.slot[_currentScript].number,
+					(uint)(_scriptPointer - _scriptOrgPointer),
+					_opcode,
+					getOpcodeDesc(_opcode));
 		if (_hexdumpScripts == true) {
 			for (c = -1; c < 15; c++) {
 				debugN(" %02x", *(_scriptPointer + c));
@@ -552,14 +555,14 @@ int ScummEngine::readVar(uint var) {
 		}
 
 		if (VAR_SUBTITLES != 0xFF && var == VAR_SUBTITLES) {
-			return ConfMan.getBool("subtitles");
+			return _subtitlesSetting.get();
 		}
 		if (VAR_NOSUBTITLES != 0xFF && var == VAR_NOSUBTITLES) {
-			return !ConfMan.getBool("subtitles");
+			return !_subtitlesSetting.get();
 		}
 
 #if defined(USE_ENET) && defined(USE_LIBCURL)
-		if (ConfMan.getBool("enable_competitive_mods")) {
+		if (_competitiveModsSetting.get()) {
 			// HACK: If we're reading var586, competitive mods enabled, playing online,
 			// successfully fetched custom teams, and we're not in one of the three scripts
 			// that cause bugs if 263 is returned here, return 263.
@@ -585,7 +588,7 @@ int ScummEngine::readVar(uint var) {
 			assertRange(0, var, _numRoomVariables - 1, "room variable (reading)");
 
 #if defined(USE_ENET) && defined(USE_LIBCURL)
-			if (ConfMan.getBool("enable_competitive_mods")) {
+			if (_competitiveModsSetting.get()) {
 				// Mod for Backyard Baseball 2001 online competitive play: don't give powerups for double plays
 				// Return true for this variable, which dictates whether powerups are disabled, but only in this script
 				// that detects double plays (among other things)
@@ -638,7 +641,7 @@ int ScummEngine::readVar(uint var) {
 #if defined(USE_ENET) && defined(USE_LIBCURL)
 		// Mod for Backyard Baseball 2001 online competitive play: change impact of
 		// batter's power stat on hit power
-		if (ConfMan.getBool("enable_competitive_mods")) {
+		if (_competitiveModsSetting.get()) {
 			if (_game.id == GID_BASEBALL2001 &&
 				_currentRoom == 4 && vm.slot[_currentScript].number == 2090  // The script that calculates hit power
 				&& readVar(399) == 1  // Check that we're playing online
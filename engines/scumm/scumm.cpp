@@ -128,7 +128,11 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 	  _game(dr.game),
 	  _filenamePattern(dr.fp),
 	  _language(dr.language),
-	  _rnd("scumm")
+	  _rnd("scumm"),
+	  _subtitlesSetting("subtitles")
+#if defined(USE_ENET) && defined(USE_LIBCURL)
+	  , _competitiveModsSetting("enable_competitive_mods")
+#endif
 {
 
 #ifdef USE_RGB_COLOR
@@ -24,6 +24,7 @@
 
 #include "engines/engine.h"
 
+#include "common/config-manager.h"
 #include "common/endian.h"
 #include "common/events.h"
 #include "common/file.h"
@@ -841,6 +842,12 @@ protected:
 	int32 *_scummVars = nullptr;
 	byte *_bitVars = nullptr;
 
+	/** Settings which are read whenever a script reads a variable */
+	Common::ConfigManager::Handle<bool> _subtitlesSetting;
+#if defined(USE_ENET) && defined(USE_LIBCURL)
+	Common::ConfigManager::Handle<bool> _competitiveModsSetting;
+#endif
+
 	/* Global resource tables */
 	int _numVariables = 0;
 	int _numBitVariables = 0;
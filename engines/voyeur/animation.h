@@ -120,8 +120,8 @@ private:
 		const byte *getPalette() const override { _dirtyPalette = false; return _header._palette; }
 		int getPaletteCount() const { return _header._colorCount; }
 		bool hasDirtyPalette() const override { return _dirtyPalette; }
-		const Common::List<Common::Rect> *getDirtyRects() const { return &_dirtyRects; }
-		void clearDirtyRects() { _dirtyRects.clear(); }
+		const Common::List<Common::Rect> *getDirtyRects() const override { return &_dirtyRects; }
+		void clearDirtyRects() override { _dirtyRects.clear(); }
 		void copyDirtyRectsToBuffer(uint8 *dst, uint pitch);
 
 		Common::Rational getFrameRate() const override { return _header.getFrameRate(); }
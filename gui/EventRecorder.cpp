@@ -33,6 +33,8 @@ DECLARE_SINGLETON(GUI::EventRecorder);
 #include "backends/mixer/mixer.h"
 #include "common/config-manager.h"
 #include "common/md5.h"
+#include "common/crc.h"
+#include "common/algorithm.h"
 #include "gui/gui-manager.h"
 #include "gui/widget.h"
 #include "gui/onscreendialog.h"
@@ -42,6 +44,7 @@ DECLARE_SINGLETON(GUI::EventRecorder);
 #include "graphics/thumbnail.h"
 #include "graphics/surface.h"
 #include "graphics/scaler.h"
+#include "graphics/paletteman.h"
 
 namespace GUI {
 
@@ -49,6 +52,16 @@ namespace GUI {
 const int kMaxRecordsNames = 0x64;
 const int kDefaultScreenshotPeriod = 60000;
 
+static uint64 getRealMicros() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	const uint64 counter = SDL_GetPerformanceCounter();
+	const uint64 frequency = SDL_GetPerformanceFrequency();
+	return counter / frequency * 1000000 + counter % frequency * 1000000 / frequency;
+#else
+	return (uint64)SDL_GetTicks() * 1000;
+#endif
+}
+
 EventRecorder::EventRecorder() {
 	_timerManager = nullptr;
 	_recordMode = kPassthrough;
@@ -78,6 +91,11 @@ EventRecorder::EventRecorder() {
 	_screenshotPeriod = 0;
 	_playbackFile = nullptr;
 	_recordFile = nullptr;
+	_timedemo = false;
+	_timedemoStart = 0;
+	_frameStart = 0;
+	_checkedFrames = 0;
+	_mismatchedFrames = 0;
 }
 
 EventRecorder::~EventRecorder() {
@@ -88,6 +106,9 @@ void EventRecorder::deinit() {
 	if (!_initialized) {
 		return;
 	}
+	if (_timedemo) {
+		reportTimedemo();
+	}
 	setFileHeader();
 	_needRedraw = false;
 	_initialized = false;
@@ -161,7 +182,7 @@ void EventRecorder::processTimeAndDate(TimeDate &td, bool skipRecord) {
 			_recordFile->writeEvent(timeDateEvent);
 		}
 
-		_nextEvent = _playbackFile->getNextEvent();
+		_nextEvent = readNextEvent();
 	}
 	if (_recordMode == kRecorderPlaybackPause)
 		td = _lastTimeDate;
@@ -218,7 +239,7 @@ void EventRecorder::processMillis(uint32 &millis, bool skipRecord) {
 			_recordFile->writeEvent(timerEvent);
 		}
 		updateSubsystems();
-		_nextEvent = _playbackFile->getNextEvent();
+		_nextEvent = readNextEvent();
 		_timerManager->handler();
 		_controlPanel->setReplayedTime(_fakeTimer);
 		_processingMillis = false;
@@ -232,7 +253,7 @@ void EventRecorder::processMillis(uint32 &millis, bool skipRecord) {
 }
 
 bool EventRecorder::processDelayMillis() {
-	return _fastPlayback;
+	return _fastPlayback || _timedemo;
 }
 
 bool EventRecorder::processAutosave() {
@@ -250,17 +271,28 @@ void EventRecorder::processScreenUpdate() {
 		updateSubsystems();
 		screenUpdateEvent.recordedtype = Common::kRecorderEventTypeScreenUpdate;
 		screenUpdateEvent.time = _fakeTimer;
+		screenUpdateEvent.screenChecksum = computeScreenChecksum();
 		_recordFile->writeEvent(screenUpdateEvent);
 		takeScreenshot();
 		_timerManager->handler();
 		break;
 	case kRecorderUpdate: // fallthrough
 	case kRecorderPlayback:
+		if (_timedemo) {
+			const uint64 now = getRealMicros();
+			if (_timedemoStart == 0) {
+				// The first frame includes loading the game, so it is not timed
+				_timedemoStart = now;
+			} else {
+				_frameTimes.push_back((uint32)(now - _frameStart));
+			}
+			_frameStart = now;
+		}
 		// if the next event isn't a screen update, fast forward until we find one.
 		if (_nextEvent.recordedtype != Common::kRecorderEventTypeScreenUpdate) {
 			int numSkipped = 0;
 			while (true) {
-				_nextEvent = _playbackFile->getNextEvent();
+				_nextEvent = readNextEvent();
 				numSkipped += 1;
 				if (_nextEvent.recordedtype == Common::kRecorderEventTypeScreenUpdate) {
 					warning("Skipped %d events to get to the next screen update at %d", numSkipped, _nextEvent.time);
@@ -271,11 +303,18 @@ void EventRecorder::processScreenUpdate() {
 		_processingMillis = true;
 		_fakeTimer = _nextEvent.time;
 		updateSubsystems();
-		_nextEvent = _playbackFile->getNextEvent();
+		if (_timedemo) {
+			// Checking the screen is not part of the frame time
+			const uint64 checkStart = getRealMicros();
+			checkScreenChecksum(_nextEvent.screenChecksum);
+			_frameStart += getRealMicros() - checkStart;
+		}
+		_nextEvent = readNextEvent();
 		if (_recordMode == kRecorderUpdate) {
 			// write event to the updated file and update screenshot if necessary
 			screenUpdateEvent.recordedtype = Common::kRecorderEventTypeScreenUpdate;
 			screenUpdateEvent.time = _fakeTimer;
+			screenUpdateEvent.screenChecksum = computeScreenChecksum();
 			_recordFile->writeEvent(screenUpdateEvent);
 			takeScreenshot();
 		}
@@ -308,7 +347,7 @@ bool EventRecorder::pollEvent(Common::Event &ev) {
 	}
 
 	ev = _nextEvent;
-	_nextEvent = _playbackFile->getNextEvent();
+	_nextEvent = readNextEvent();
 	switch (ev.type) {
 	case Common::EVENT_MOUSEMOVE:
 	case Common::EVENT_LBUTTONDOWN:
@@ -380,7 +419,7 @@ Common::String EventRecorder::generateRecordFileName(const Common::String &targe
 }
 
 
-void EventRecorder::init(const Common::String &recordFileName, RecordMode mode) {
+void EventRecorder::init(const Common::String &recordFileName, RecordMode mode, bool timedemo) {
 	_fakeMixerManager = new NullMixerManager();
 	_fakeMixerManager->init();
 	_fakeMixerManager->suspendAudio();
@@ -389,6 +428,11 @@ void EventRecorder::init(const Common::String &recordFileName, RecordMode mode)
 	_lastScreenshotTime = 0;
 	_recordMode = mode;
 	_needcontinueGame = false;
+	_timedemo = timedemo && (mode == kRecorderPlayback);
+	_timedemoStart = 0;
+	_frameTimes.clear();
+	_checkedFrames = 0;
+	_mismatchedFrames = 0;
 	if (ConfMan.hasKey("disable_display")) {
 		DebugMan.enableDebugChannel("EventRec");
 		gDebugLevel = 1;
@@ -415,7 +459,7 @@ void EventRecorder::init(const Common::String &recordFileName, RecordMode mode)
 	}
 	if ((_recordMode == kRecorderPlayback) || (_recordMode == kRecorderUpdate)) {
 		applyPlaybackSettings();
-		_nextEvent = _playbackFile->getNextEvent();
+		_nextEvent = readNextEvent();
 	}
 	if ((_recordMode == kRecorderRecord) || (_recordMode == kRecorderUpdate)) {
 		getConfig();
@@ -661,6 +705,80 @@ void EventRecorder::takeScreenshot() {
 	}
 }
 
+uint32 EventRecorder::computeScreenChecksum() {
+	Common::CRC32 crc;
+	uint32 remainder = crc.getInitRemainder();
+
+	Graphics::Surface *screen = g_system->lockScreen();
+	if (!screen) {
+		return 0;
+	}
+	const bool clut8 = screen->format.isCLUT8();
+	const uint rowSize = screen->w * screen->format.bytesPerPixel;
+	for (int y = 0; y < screen->h; y++) {
+		const byte *row = (const byte *)screen->getBasePtr(0, y);
+		for (uint x = 0; x < rowSize; x++) {
+			remainder = crc.processByte(row[x], remainder);
+		}
+	}
+	g_system->unlockScreen();
+
+	if (clut8) {
+		byte palette[256 * 3];
+		g_system->getPaletteManager()->grabPalette(palette, 0, 256);
+		for (uint i = 0; i < sizeof(palette); i++) {
+			remainder = crc.processByte(palette[i], remainder);
+		}
+	}
+	return crc.finalize(remainder);
+}
+
+void EventRecorder::checkScreenChecksum(uint32 recordedChecksum) {
+	if (!_playbackFile->hasScreenChecksums()) {
+		return;
+	}
+	_checkedFrames++;
+	if (computeScreenChecksum() != recordedChecksum) {
+		if (_mismatchedFrames == 0) {
+			warning("timedemo:action=\"Screen checksum mismatch\" frame=%d time=%d", _checkedFrames, _fakeTimer);
+		}
+		debugC(1, kDebugLevelEventRec, "timedemo:action=\"Screen checksum mismatch\" frame=%d time=%d", _checkedFrames, _fakeTimer);
+		_mismatchedFrames++;
+	}
+}
+
+Common::RecorderEvent EventRecorder::readNextEvent() {
+	// The playback file quits when it runs out of events, so this is the
+	// last chance to report the timings
+	if (_timedemo && !_playbackFile->hasNextEvent()) {
+		reportTimedemo();
+	}
+	return _playbackFile->getNextEvent();
+}
+
+void EventRecorder::reportTimedemo() {
+	_timedemo = false;
+	if (_frameTimes.empty()) {
+		debug("timedemo:frames=0");
+		return;
+	}
+
+	const uint64 total = _frameStart - _timedemoStart;
+	const uint frames = _frameTimes.size();
+	Common::sort(_frameTimes.begin(), _frameTimes.end());
+
+	debug("timedemo:frames=%d time=%.3fs fps=%.2f", frames, total / 1000000.0, total ? frames * 1000000.0 / total : 0.0);
+	debug("timedemo:frametime p50=%.3fms p90=%.3fms p99=%.3fms max=%.3fms",
+		_frameTimes[(frames - 1) * 50 / 100] / 1000.0, _frameTimes[(frames - 1) * 90 / 100] / 1000.0,
+		_frameTimes[(frames - 1) * 99 / 100] / 1000.0, _frameTimes[frames - 1] / 1000.0);
+	if (_playbackFile->hasScreenChecksums()) {
+		debug("timedemo:checksums checked=%d mismatched=%d", _checkedFrames, _mismatchedFrames);
+	} else {
+		debug("timedemo:checksums=unavailable reason=\"Recording has no screen checksums, update it using --record-mode=update\"");
+	}
+	_frameTimes.clear();
+}
+
 bool EventRecorder::grabScreenAndComputeMD5(Graphics::Surface &screen, uint8 md5[16]) {
 	if (!createScreenShot(screen)) {
 		warning("Can't save screenshot");
@@ -77,7 +77,17 @@ public:
 		kRecorderUpdate = 4			/**< kRecorderUpdate, playback existing recording and update all hashes */
 	};
 
-	void init(const Common::String &recordFileName, RecordMode mode);
+	/**
+	 * Start recording or playing back.
+	 *
+	 * @param recordFileName  The name of the recording.
+	 * @param mode            The operation mode.
+	 * @param timedemo        Replay the recording as fast as possible, check the
+	 *                        screen checksums of each frame and report the frame
+	 *                        timings when playback ends. Only used with
+	 *                        kRecorderPlayback.
+	 */
+	void init(const Common::String &recordFileName, RecordMode mode, bool timedemo = false);
 	void deinit();
 	bool processDelayMillis();
 	uint32 getRandomSeed(const Common::String &name);
@@ -244,11 +254,23 @@ private:
 	void checkRecordedMD5();
 	void deleteTemporarySave();
 	void updateFakeTimer(uint32 millis);
+	Common::RecorderEvent readNextEvent();
+	uint32 computeScreenChecksum();
+	void checkScreenChecksum(uint32 recordedChecksum);
+	void reportTimedemo();
 	volatile RecordMode _recordMode;
 	Common::String _recordFileName;
 	bool _fastPlayback;
 	bool _needRedraw;
 	bool _processingMillis;
+
+	bool _timedemo;
+	uint64 _timedemoStart;
+	uint64 _frameStart;
+	/** The real duration of each replayed frame in microseconds */
+	Common::Array<uint32> _frameTimes;
+	uint _checkedFrames;
+	uint _mismatchedFrames;
 };
 
 } // End of namespace GUI
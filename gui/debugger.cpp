@@ -25,6 +25,8 @@
 #include "common/file.h"
 #include "common/debug.h"
 #include "common/debug-channels.h"
+#include "common/memorytracker.h"
+#include "common/profiler.h"
 #include "common/system.h"
 
 #ifndef DISABLE_MD5
@@ -81,6 +83,12 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+#ifdef USE_PROFILER
+	registerCmd("profile",			WRAP_METHOD(Debugger, cmdProfile));
+#endif
+#ifdef USE_MEMORY_TRACKER
+	registerCmd("memory",			WRAP_METHOD(Debugger, cmdMemory));
+#endif
 }
 
 Debugger::~Debugger() {
@@ -857,6 +865,55 @@ bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+#ifdef USE_PROFILER
+bool Debugger::cmdProfile(int argc, const char **argv) {
+	if (argc < 2) {
+		debugPrintf("profile [start | stop | clear | dump [<filename>]]\n");
+		debugPrintf("Recording is %s\n", Common::Profiler::isEnabled() ? "enabled" : "disabled");
+	} else if (!scumm_stricmp(argv[1], "start")) {
+		Common::Profiler::setEnabled(true);
+		debugPrintf("Started recording\n");
+	} else if (!scumm_stricmp(argv[1], "stop")) {
+		Common::Profiler::setEnabled(false);
+		debugPrintf("Stopped recording\n");
+	} else if (!scumm_stricmp(argv[1], "clear")) {
+		Common::Profiler::clear();
+		debugPrintf("Cleared the recorded events\n");
+	} else if (!scumm_stricmp(argv[1], "dump")) {
+		Common::Path fileName(argc > 2 ? argv[2] : "scummvm-trace.json", Common::Path::kNativeSeparator);
+		int count = Common::Profiler::dumpTrace(fileName);
+		if (count < 0)
+			debugPrintf("Failed to write '%s'\n", fileName.toString(Common::Path::kNativeSeparator).c_str());
+		else
+			debugPrintf("Wrote %d events to '%s'\n", count, fileName.toString(Common::Path::kNativeSeparator).c_str());
+	} else {
+		debugPrintf("Unknown subcommand '%s'\n", argv[1]);
+	}
+	return true;
+}
+#endif
+
+#ifdef USE_MEMORY_TRACKER
+bool Debugger::cmdMemory(int argc, const char **argv) {
+	if (argc > 1 && !scumm_stricmp(argv[1], "reset")) {
+		Common::MemoryTag::resetAllPeaks();
+		debugPrintf("Reset the peaks\n");
+		return true;
+	} else if (argc > 1) {
+		debugPrintf("memory [reset]\n");
+		return true;
+	}
+
+	const Common::Array<Common::MemoryTag::Stats> stats = Common::MemoryTag::getAllStats();
+	debugPrintf("%-24s %10s %12s %12s %12s\n", "Tag", "Live", "Allocations", "KB", "Peak KB");
+	for (uint i = 0; i < stats.size(); i++) {
+		debugPrintf("%-24s %10u %12u %12u %12u\n", stats[i].name, stats[i].count, stats[i].totalCount,
+			(uint)(stats[i].bytes / 1024), (uint)(stats[i].peakBytes / 1024));
+	}
+	return true;
+}
+#endif
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
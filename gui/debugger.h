@@ -275,6 +275,12 @@ protected:
 	bool cmdDebugFlagsList(int argc, const char **argv);
 	bool cmdDebugFlagEnable(int argc, const char **argv);
 	bool cmdDebugFlagDisable(int argc, const char **argv);
+#ifdef USE_PROFILER
+	bool cmdProfile(int argc, const char **argv);
+#endif
+#ifdef USE_MEMORY_TRACKER
+	bool cmdMemory(int argc, const char **argv);
+#endif
 	bool cmdClearLog(int argc, const char **argv);
 	bool cmdExecFile(int argc, const char **argv);
 
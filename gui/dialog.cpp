@@ -370,7 +370,7 @@ void Dialog::handleTickle() {
 	if (_focusedWidget && _focusedWidget->getFlags() & WIDGET_WANT_TICKLE)
 		_focusedWidget->handleTickle();
 
-	if (_tickleWidget && _tickleWidget->getFlags() & WIDGET_WANT_TICKLE)
+	if (_tickleWidget && _tickleWidget != _focusedWidget && _tickleWidget->getFlags() & WIDGET_WANT_TICKLE)
 		_tickleWidget->handleTickle();
 }
 
@@ -412,6 +412,8 @@ void Dialog::removeWidget(Widget *del) {
 		_focusedWidget = nullptr;
 	if (del == _dragWidget || del->containsWidget(_dragWidget))
 		_dragWidget = nullptr;
+	if (del == _tickleWidget || del->containsWidget(_tickleWidget))
+		_tickleWidget = nullptr;
 
 	GuiObject::removeWidget(del);
 }
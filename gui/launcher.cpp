@@ -1654,6 +1654,8 @@ void LauncherGrid::build() {
 
 	// Add list with game titles
 	_grid = new GridWidget(this, "LauncherGrid.IconArea");
+	// The grid loads its thumbnails in the background, even without focus
+	setTickleWidget(_grid);
 	// Populate the list
 	updateListing();
 
@@ -20,12 +20,16 @@
  */
 
 #include "common/system.h"
+#include "common/config-manager.h"
 #include "common/file.h"
+#include "common/fs.h"
 #include "common/language.h"
 #include "common/platform.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
 
+#include "graphics/thumbnail.h"
+
 #include "gui/gui-manager.h"
 #include "gui/widgets/grid.h"
 
@@ -346,31 +350,44 @@ void GridItemTray::handleMouseMoved(int x, int y, int button) {
 
 #pragma mark -
 
+#ifdef USE_PNG
+// Decode a PNG icon. The render dimensions are only a hint, large images are
+// decoded at a reduced size that is still at least that big.
+Graphics::ManagedSurface *decodePNGIcon(Common::SeekableReadStream &stream, const Common::String &name, int renderWidth, int renderHeight) {
+	Image::PNGDecoder decoder;
+	decoder.setScaleHint(renderWidth, renderHeight);
+	if (!decoder.loadStream(stream)) {
+		warning("Error decoding PNG");
+		return nullptr;
+	}
+
+	const Graphics::Surface *srcSurface = decoder.getSurface();
+	if (!srcSurface) {
+		warning("Failed to load surface : %s", name.c_str());
+		return nullptr;
+	}
+
+	if (srcSurface->format.bytesPerPixel == 1)
+		return nullptr;
+
+	return new Graphics::ManagedSurface(srcSurface);
+}
+#endif
+
 // Load an image file by String name, provide additional render dimensions for SVG images.
-// TODO: Add BMP support, and add scaling of non-vector images.
+// For PNG images the render dimensions allow decoding large images at a reduced size,
+// the result still needs to be scaled.
+// TODO: Add BMP support.
 Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int renderWidth = 0, int renderHeight = 0) {
 	Common::Path path(name);
 	Graphics::ManagedSurface *surf = nullptr;
 	if (name.hasSuffix(".png")) {
 #ifdef USE_PNG
-		const Graphics::Surface *srcSurface = nullptr;
-		Image::PNGDecoder decoder;
 		g_gui.lockIconsSet();
 		if (g_gui.getIconsSet().hasFile(path)) {
 			Common::SeekableReadStream *stream = g_gui.getIconsSet().createReadStreamForMember(path);
-			if (!decoder.loadStream(*stream)) {
-				g_gui.unlockIconsSet();
-				warning("Error decoding PNG");
-				return surf;
-			}
-
-			srcSurface = decoder.getSurface();
+			surf = decodePNGIcon(*stream, name, renderWidth, renderHeight);
 			delete stream;
-			if (!srcSurface) {
-				warning("Failed to load surface : %s", name.c_str());
-			} else if (srcSurface->format.bytesPerPixel != 1) {
-				surf = new Graphics::ManagedSurface(srcSurface);
-			}
 		} else {
 			debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
 		}
@@ -392,6 +409,183 @@ Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int re
 	return surf;
 }
 
+// Game thumbnails are cached on disk at the size they are displayed at, so
+// that opening the grid doesn't decode every full size icon again. Each entry
+// stores the path of the icon and the modification time of the file it was
+// read from, which is the icon pack or the icon itself, to notice when the
+// icons have been updated. Nothing is cached when that time is unknown.
+
+// The cache is kept next to the config file, like the directory listings,
+// instead of in the directory of the icon packs
+Common::FSNode getThumbnailCacheDir() {
+	Common::Path configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+	if (configFile.empty())
+		return Common::FSNode();
+
+	return Common::FSNode(configFile.getParent().appendComponent("thumbnails"));
+}
+
+Common::String getThumbnailCacheName(const Common::String &name, int width, int height) {
+	return Common::String::format("%08x-%dx%d.thmb", Common::hashit(name.c_str()), width, height);
+}
+
+// Find the file a member of a search set is read from, if it is in a directory
+Common::FSNode findMemberFile(const Common::SearchSet &set, const Common::Path &path) {
+	Common::Archive *archive = nullptr;
+	if (!set.getMember(path, &archive))
+		return Common::FSNode();
+
+	const Common::SearchSet *subSet = dynamic_cast<const Common::SearchSet *>(archive);
+	if (subSet)
+		return findMemberFile(*subSet, path);
+
+	const Common::FSDirectory *dir = dynamic_cast<const Common::FSDirectory *>(archive);
+	if (dir)
+		return Common::FSNode(dir->getFSNode().getPath().join(path));
+
+	return Common::FSNode();
+}
+
+// Find the files icon packs may have been loaded from, see generateZipSet()
+void findIconPackFiles(Common::FSList &files) {
+	files.clear();
+
+	const Common::Path iconsPath = ConfMan.getPath("iconspath");
+	if (!iconsPath.empty())
+		Common::FSNode(iconsPath).getChildren(files, Common::FSNode::kListFilesOnly);
+
+	if (ConfMan.hasKey("themepath"))
+		files.push_back(Common::FSNode(ConfMan.getPath("themepath").join("gui-icons.dat")));
+
+	files.push_back(findMemberFile(SearchMan, "gui-icons.dat"));
+}
+
+// Return the modification time of the file an icon is read from, or 0 if it
+// is unknown. The icons set has to be locked.
+int64 getIconSourceTime(const Common::Path &path, const Common::FSList &iconPackFiles) {
+	const Common::SearchSet &iconsSet = g_gui.getIconsSet();
+
+	Common::Archive *pack = nullptr;
+	if (!iconsSet.getMember(path, &pack))
+		return 0;
+
+	if (dynamic_cast<Common::FSDirectory *>(pack))
+		return findMemberFile(iconsSet, path).getModificationTime();
+
+	// Packs are named after their file, and the first file with the name
+	// is the one which was loaded
+	for (Common::FSList::const_iterator file = iconPackFiles.begin(); file != iconPackFiles.end(); ++file) {
+		if (file->exists() && iconsSet.getArchive(file->getName()) == pack)
+			return file->getModificationTime();
+	}
+
+	return 0;
+}
+
+const Graphics::ManagedSurface *loadCachedThumbnail(const Common::String &name, const Common::String &cacheName, int64 sourceTime) {
+	Common::FSNode dir = getThumbnailCacheDir();
+	if (!dir.isDirectory())
+		return nullptr;
+
+	Common::FSNode node = dir.getChild(cacheName);
+	if (!node.exists())
+		return nullptr;
+
+	Common::SeekableReadStream *in = node.createReadStream();
+	if (!in)
+		return nullptr;
+
+	Graphics::Surface *thumb = nullptr;
+	bool valid = (in->readSint64BE() == sourceTime);
+	if (valid) {
+		// Different icons can end up with the same hash
+		const uint32 nameSize = in->readUint32BE();
+		valid = (nameSize == name.size()) && (in->readString(0, nameSize) == name) && Graphics::loadThumbnail(*in, thumb);
+	}
+	delete in;
+
+	if (!valid)
+		return nullptr;
+
+	return new Graphics::ManagedSurface(thumb);
+}
+
+void saveCachedThumbnail(const Common::String &name, const Common::String &cacheName, int64 sourceTime, const Graphics::ManagedSurface &thumb) {
+	Common::FSNode dir = getThumbnailCacheDir();
+	if (!dir.exists() && !dir.createDirectory())
+		return;
+	if (!dir.isDirectory())
+		return;
+
+	Common::SeekableWriteStream *out = dir.getChild(cacheName).createWriteStream();
+	if (!out)
+		return;
+
+	out->writeSint64BE(sourceTime);
+	out->writeUint32BE(name.size());
+	out->writeString(name);
+	Graphics::saveThumbnail(*out, thumb.rawSurface());
+	out->finalize();
+	if (out->err())
+		warning("GridWidget: Failed to write thumbnail cache '%s'", cacheName.c_str());
+
+	delete out;
+}
+
+// Load a game thumbnail scaled to fit the given size, from the cache if possible.
+const Graphics::ManagedSurface *loadThumbnailFromFile(const Common::String &name, int width, int height, const Common::FSList &iconPackFiles) {
+	if (!name.hasSuffix(".png") || width <= 0 || height <= 0) {
+		Graphics::ManagedSurface *gfx = loadSurfaceFromFile(name, width, height);
+		if (!gfx)
+			return nullptr;
+
+		const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, width, height, true);
+		if (gfx != scGfx) {
+			gfx->free();
+			delete gfx;
+		}
+		return scGfx;
+	}
+
+	const Graphics::ManagedSurface *surf = nullptr;
+
+#ifdef USE_PNG
+	g_gui.lockIconsSet();
+	Common::SeekableReadStream *stream = g_gui.getIconsSet().createReadStreamForMember(Common::Path(name));
+	if (stream) {
+		const int64 sourceTime = getIconSourceTime(Common::Path(name), iconPackFiles);
+		const Common::String cacheName = getThumbnailCacheName(name, width, height);
+
+		if (sourceTime)
+			surf = loadCachedThumbnail(name, cacheName, sourceTime);
+		if (!surf) {
+			Graphics::ManagedSurface *gfx = decodePNGIcon(*stream, name, width, height);
+			if (gfx) {
+				surf = scaleGfx(gfx, width, height, true);
+				if (gfx != surf) {
+					gfx->free();
+					delete gfx;
+				}
+
+				if (sourceTime)
+					saveCachedThumbnail(name, cacheName, sourceTime, *surf);
+			}
+		}
+
+		delete stream;
+	} else {
+		debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
+	}
+	g_gui.unlockIconsSet();
+#else
+	error("No PNG support compiled");
+#endif
+
+	return surf;
+}
+
 #pragma mark -
 
 GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
@@ -439,6 +633,8 @@ GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 
 	_selectedEntry = nullptr;
 	_isGridInvalid = true;
+
+	setFlags(WIDGET_WANT_TICKLE);
 }
 
 GridWidget::~GridWidget() {
@@ -465,7 +661,8 @@ void GridWidget::unloadSurfaces(Common::HashMap<T, const Graphics::ManagedSurfac
 const Graphics::ManagedSurface *GridWidget::filenameToSurface(const Common::String &name) {
 	if (name.empty())
 		return nullptr;
-	return _loadedSurfaces[name];
+	// Thumbnails which are still queued for loading have no entry yet
+	return _loadedSurfaces.getValOrDefault(name);
 }
 
 const Graphics::ManagedSurface *GridWidget::languageToSurface(Common::Language languageCode) {
@@ -491,6 +688,7 @@ const Graphics::ManagedSurface *GridWidget::disabledThumbnail() {
 }
 
 void GridWidget::setEntryList(Common::Array<GridItemInfo> *list) {
+	_pendingThumbnails.clear();
 	_dataEntryList.clear();
 	_headerEntryList.clear();
 	_sortedEntryList.clear();
@@ -686,42 +884,62 @@ void GridWidget::setGroupHeaderFormat(const Common::U32String &prefix, const Com
 }
 
 void GridWidget::reloadThumbnails() {
-	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
-	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+	// Only queue the visible thumbnails here. They are loaded a few at a time
+	// from handleTickle(), so that scrolling never waits for image decoding.
+	_pendingThumbnails.clear();
 	for (Common::Array<GridItemInfo *>::iterator iter = _visibleEntryList.begin(); iter != _visibleEntryList.end(); ++iter) {
 		GridItemInfo *entry = *iter;
 		if (entry->thumbPath.empty())
 			continue;
 
-		if (!_loadedSurfaces.contains(entry->thumbPath)) {
-			_loadedSurfaces[entry->thumbPath] = nullptr;
-			Common::String path = Common::String::format("icons/%s-%s.png", entry->engineid.c_str(), entry->gameid.c_str());
-			Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
-			if (!surf) {
-				path = Common::String::format("icons/%s.png", entry->engineid.c_str());
-				if (!_loadedSurfaces.contains(path)) {
-					surf = loadSurfaceFromFile(path);
-				} else {
-					const Graphics::ManagedSurface *scSurf = _loadedSurfaces[path];
-					_loadedSurfaces[entry->thumbPath] = new Graphics::ManagedSurface(*scSurf);
-				}
-			}
+		if (!_loadedSurfaces.contains(entry->thumbPath))
+			_pendingThumbnails.push(entry);
+	}
 
-			if (surf) {
-				const Graphics::ManagedSurface *scSurf(scaleGfx(surf, thumbnailWidth, thumbnailHeight, true));
-				_loadedSurfaces[entry->thumbPath] = scSurf;
+	if (!_pendingThumbnails.empty())
+		findIconPackFiles(_iconPackFiles);
+}
 
-				if (path != entry->thumbPath) {
-					_loadedSurfaces[path] = new Graphics::ManagedSurface(*scSurf);
-				}
+void GridWidget::loadThumbnail(GridItemInfo *entry) {
+	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
+	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
 
-				if (surf != scSurf) {
-					surf->free();
-					delete surf;
-				}
-			}
+	_loadedSurfaces[entry->thumbPath] = nullptr;
+	Common::String path = Common::String::format("icons/%s-%s.png", entry->engineid.c_str(), entry->gameid.c_str());
+	const Graphics::ManagedSurface *surf = loadThumbnailFromFile(path, thumbnailWidth, thumbnailHeight, _iconPackFiles);
+	if (!surf) {
+		path = Common::String::format("icons/%s.png", entry->engineid.c_str());
+		if (!_loadedSurfaces.contains(path)) {
+			surf = loadThumbnailFromFile(path, thumbnailWidth, thumbnailHeight, _iconPackFiles);
+		} else {
+			const Graphics::ManagedSurface *scSurf = _loadedSurfaces[path];
+			_loadedSurfaces[entry->thumbPath] = new Graphics::ManagedSurface(*scSurf);
 		}
 	}
+
+	if (surf) {
+		_loadedSurfaces[entry->thumbPath] = surf;
+
+		if (path != entry->thumbPath) {
+			_loadedSurfaces[path] = new Graphics::ManagedSurface(*surf);
+		}
+	}
+}
+
+void GridWidget::handleTickle() {
+	if (_pendingThumbnails.empty())
+		return;
+
+	// Load thumbnails until the time budget for this tick is used up
+	const uint32 start = g_system->getMillis();
+	do {
+		GridItemInfo *entry = _pendingThumbnails.pop();
+		if (!_loadedSurfaces.contains(entry->thumbPath))
+			loadThumbnail(entry);
+	} while (!_pendingThumbnails.empty() && g_system->getMillis() - start < kThumbnailLoadBudget);
+
+	assignEntriesToItems();
+	markAsDirty();
 }
 
 void GridWidget::loadFlagIcons() {
@@ -734,7 +952,7 @@ void GridWidget::loadFlagIcons() {
 			continue;
 		} // if no .svg flag is available, search for a .png
 		path = Common::String::format("icons/flags/%s.png", l->code);
-		gfx = loadSurfaceFromFile(path);
+		gfx = loadSurfaceFromFile(path, _flagIconWidth, _flagIconHeight);
 		if (gfx) {
 			const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _flagIconWidth, _flagIconHeight, true);
 			_languageIcons[l->id] = scGfx;
@@ -752,7 +970,7 @@ void GridWidget::loadPlatformIcons() {
 	const Common::PlatformDescription *l = Common::g_platforms;
 	for (; l->code; ++l) {
 		Common::String path = Common::String::format("icons/platforms/%s.png", l->code);
-		Graphics::ManagedSurface *gfx = loadSurfaceFromFile(path);
+		Graphics::ManagedSurface *gfx = loadSurfaceFromFile(path, _platformIconWidth, _platformIconHeight);
 		if (gfx) {
 			const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _platformIconWidth, _platformIconHeight, true);
 			_platformIcons[l->id] = scGfx;
@@ -772,7 +990,7 @@ void GridWidget::loadExtraIcons() {  // for now only the demo icon is available
 		_extraIcons[0] = gfx;
 		return;
 	} // if no .svg file is available, search for a .png
-	gfx = loadSurfaceFromFile("icons/extra/demo.png");
+	gfx = loadSurfaceFromFile("icons/extra/demo.png", _extraIconWidth, _extraIconHeight);
 	if (gfx) {
 		const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _extraIconWidth, _extraIconHeight, true);
 		_extraIcons[0] = scGfx;
@@ -24,6 +24,8 @@
 
 #include "gui/dialog.h"
 #include "gui/widgets/scrollbar.h"
+#include "common/fs.h"
+#include "common/queue.h"
 #include "common/str.h"
 
 #include "image/bmp.h"
@@ -46,6 +48,10 @@ enum {
 	kItemSizeCmd = 'SIZE'
 };
 
+enum {
+	kThumbnailLoadBudget = 10 ///< Milliseconds per tick spent loading thumbnails
+};
+
 /* GridItemInfo */
 struct GridItemInfo {
 	bool		isHeader, validEntry;
@@ -105,6 +111,10 @@ protected:
 	Graphics::ManagedSurface *_disabledIconOverlay;
 	// Images are mapped by filename -> surface.
 	Common::HashMap<Common::String, const Graphics::ManagedSurface *> _loadedSurfaces;
+	// Visible entries whose thumbnails still have to be loaded
+	Common::Queue<GridItemInfo *> _pendingThumbnails;
+	// Files icon packs may have been loaded from, to validate cached thumbnails
+	Common::FSList _iconPackFiles;
 
 	Common::Array<GridItemInfo>			_dataEntryList;
 	Common::Array<GridItemInfo>			_headerEntryList;
@@ -195,6 +205,7 @@ public:
 	void saveClosedGroups(const Common::U32String &groupName);
 
 	void reloadThumbnails();
+	void loadThumbnail(GridItemInfo *entry);
 	void loadFlagIcons();
 	void loadPlatformIcons();
 	void loadExtraIcons();
@@ -216,6 +227,7 @@ public:
 
 	void handleMouseWheel(int x, int y, int direction) override;
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
+	void handleTickle() override;
 	void reflowLayout() override;
 
 	bool wantsFocus() override { return true; }
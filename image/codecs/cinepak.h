@@ -46,6 +46,7 @@ struct CinepakStrip {
 	Common::Rect rect;
 	CinepakCodebook v1_codebook[256], v4_codebook[256];
 	uint32 v1_dither[256 * 4 * 4], v4_dither[256 * 4 * 4];
+	uint32 v1_rgb[256 * 4], v4_rgb[256 * 4]; // Codebook colors in the output format
 };
 
 struct CinepakFrame {
@@ -98,6 +99,7 @@ private:
 	void loadCodebook(Common::SeekableReadStream &stream, uint16 strip, byte codebookType, byte chunkID, uint32 chunkSize);
 	void decodeVectors8(Common::SeekableReadStream &stream, uint16 strip, byte chunkID, uint32 chunkSize);
 	void decodeVectors24(Common::SeekableReadStream &stream, uint16 strip, byte chunkID, uint32 chunkSize);
+	void convertCodebookRGB(uint16 strip, byte codebookType, uint16 codebookIndex);
 
 	byte findNearestRGB(int index) const;
 	void ditherVectors(Common::SeekableReadStream &stream, uint16 strip, byte chunkID, uint32 chunkSize);
@@ -22,6 +22,8 @@
 #ifndef IMAGE_CODECS_CODEC_H
 #define IMAGE_CODECS_CODEC_H
 
+#include "common/rect.h"
+
 #include "graphics/surface.h"
 #include "graphics/pixelformat.h"
 
@@ -91,6 +93,15 @@ public:
 	 */
 	virtual bool setOutputPixelFormat(const Graphics::PixelFormat &format) { return false; }
 
+	/**
+	 * Get the area of the surface changed by the last decodeFrame() call,
+	 * for codecs which only update parts of the previous frame.
+	 *
+	 * @param rect Set to the changed area, which may be empty
+	 * @return true if the codec knows the changed area, false otherwise
+	 */
+	virtual bool getDirtyRect(Common::Rect &rect) const { return false; }
+
 	/**
 	 * Can this codec's frames contain a palette?
 	 */
@@ -25,52 +25,15 @@
  * written, produced, and directed by Alan Smithee
  */
 
+#include "common/system.h"
+
 #include "image/codecs/indeo/indeo_dsp.h"
+#include "image/codecs/indeo/indeo_dsp_intern.h"
 
 namespace Image {
 namespace Indeo {
 
-/**
- * butterfly operation for the inverse Haar transform
- */
-#define IVI_HAAR_BFLY(s1, s2, o1, o2, t) \
-	t  = ((s1) - (s2)) >> 1;\
-	o1 = ((s1) + (s2)) >> 1;\
-	o2 = (t);\
-
-/**
- * inverse 8-point Haar transform
- */
-#define INV_HAAR8(s1, s5, s3, s7, s2, s4, s6, s8,\
-				  d1, d2, d3, d4, d5, d6, d7, d8,\
-				  t0, t1, t2, t3, t4, t5, t6, t7, t8) {\
-	t1 = (s1) << 1; t5 = (s5) << 1;\
-	IVI_HAAR_BFLY(t1, t5, t1, t5, t0); IVI_HAAR_BFLY(t1, s3, t1, t3, t0);\
-	IVI_HAAR_BFLY(t5, s7, t5, t7, t0); IVI_HAAR_BFLY(t1, s2, t1, t2, t0);\
-	IVI_HAAR_BFLY(t3, s4, t3, t4, t0); IVI_HAAR_BFLY(t5, s6, t5, t6, t0);\
-	IVI_HAAR_BFLY(t7, s8, t7, t8, t0);\
-	d1 = COMPENSATE(t1);\
-	d2 = COMPENSATE(t2);\
-	d3 = COMPENSATE(t3);\
-	d4 = COMPENSATE(t4);\
-	d5 = COMPENSATE(t5);\
-	d6 = COMPENSATE(t6);\
-	d7 = COMPENSATE(t7);\
-	d8 = COMPENSATE(t8); }
-
-/**
- * inverse 4-point Haar transform
- */
-#define INV_HAAR4(s1, s3, s5, s7, d1, d2, d3, d4, t0, t1, t2, t3, t4) {\
-	IVI_HAAR_BFLY(s1, s3, t0, t1, t4);\
-	IVI_HAAR_BFLY(t0, s5, t2, t3, t4);\
-	d1 = COMPENSATE(t2);\
-	d2 = COMPENSATE(t3);\
-	IVI_HAAR_BFLY(t1, s7, t2, t3, t4);\
-	d3 = COMPENSATE(t2);\
-	d4 = COMPENSATE(t3); }
-
-void IndeoDSP::ffIviInverseHaar8x8(const int32 *in, int16 *out, uint32 pitch,
+static void inverseHaar8x8Generic(const int32 *in, int16 *out, uint32 pitch,
 							 const uint8 *flags) {
 	int32 tmp[64];
 	int t0, t1, t2, t3, t4, t5, t6, t7, t8;
@@ -270,57 +233,7 @@ void IndeoDSP::ffIviDcHaar2d(const int32 *in, int16 *out, uint32 pitch,
 	}
 }
 
-//* butterfly operation for the inverse slant transform
-#define IVI_SLANT_BFLY(s1, s2, o1, o2, t) \
-	t  = (s1) - (s2);\
-	o1 = (s1) + (s2);\
-	o2 = (t);\
-
-//* This is a reflection a,b = 1/2, 5/4 for the inverse slant transform
-#define IVI_IREFLECT(s1, s2, o1, o2, t) \
-	t  = (((s1) + (s2)*2 + 2) >> 2) + (s1);\
-	o2 = (((s1)*2 - (s2) + 2) >> 2) - (s2);\
-	o1 = (t);\
-
-//* This is a reflection a,b = 1/2, 7/8 for the inverse slant transform
-#define IVI_SLANT_PART4(s1, s2, o1, o2, t) \
-	t  = (s2) + (((s1)*4  - (s2) + 4) >> 3);\
-	o2 = (s1) + ((-(s1) - (s2)*4 + 4) >> 3);\
-	o1 = (t);\
-
-//* inverse slant8 transform
-#define IVI_INV_SLANT8(s1, s4, s8, s5, s2, s6, s3, s7,\
-					   d1, d2, d3, d4, d5, d6, d7, d8,\
-					   t0, t1, t2, t3, t4, t5, t6, t7, t8) {\
-	IVI_SLANT_PART4(s4, s5, t4, t5, t0);\
-\
-	IVI_SLANT_BFLY(s1, t5, t1, t5, t0); IVI_SLANT_BFLY(s2, s6, t2, t6, t0);\
-	IVI_SLANT_BFLY(s7, s3, t7, t3, t0); IVI_SLANT_BFLY(t4, s8, t4, t8, t0);\
-\
-	IVI_SLANT_BFLY(t1, t2, t1, t2, t0); IVI_IREFLECT  (t4, t3, t4, t3, t0);\
-	IVI_SLANT_BFLY(t5, t6, t5, t6, t0); IVI_IREFLECT  (t8, t7, t8, t7, t0);\
-	IVI_SLANT_BFLY(t1, t4, t1, t4, t0); IVI_SLANT_BFLY(t2, t3, t2, t3, t0);\
-	IVI_SLANT_BFLY(t5, t8, t5, t8, t0); IVI_SLANT_BFLY(t6, t7, t6, t7, t0);\
-	d1 = COMPENSATE(t1);\
-	d2 = COMPENSATE(t2);\
-	d3 = COMPENSATE(t3);\
-	d4 = COMPENSATE(t4);\
-	d5 = COMPENSATE(t5);\
-	d6 = COMPENSATE(t6);\
-	d7 = COMPENSATE(t7);\
-	d8 = COMPENSATE(t8);}
-
-//* inverse slant4 transform
-#define IVI_INV_SLANT4(s1, s4, s2, s3, d1, d2, d3, d4, t0, t1, t2, t3, t4) {\
-	IVI_SLANT_BFLY(s1, s2, t1, t2, t0); IVI_IREFLECT  (s4, s3, t4, t3, t0);\
-\
-	IVI_SLANT_BFLY(t1, t4, t1, t4, t0); IVI_SLANT_BFLY(t2, t3, t2, t3, t0);\
-	d1 = COMPENSATE(t1);\
-	d2 = COMPENSATE(t2);\
-	d3 = COMPENSATE(t3);\
-	d4 = COMPENSATE(t4);}
-
-void IndeoDSP::ffIviInverseSlant8x8(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+static void inverseSlant8x8Generic(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
 	int32 tmp[64];
 	int t0, t1, t2, t3, t4, t5, t6, t7, t8;
 
@@ -570,7 +483,7 @@ static void iviMc ## size ##x## size ## suffix(int16 *buf, \
 void IndeoDSP::ffIviMc ## size ##x## size ## suffix(int16 *buf, const int16 *refBuf, \
 											 uint32 pitch, int mcType) \
 { \
-	iviMc ## size ##x## size ## suffix(buf, pitch, refBuf, pitch, mcType); \
+	getKernels().mc ## size ##x## size ## suffix(buf, pitch, refBuf, pitch, mcType); \
 }
 
 #define IVI_MC_AVG_TEMPLATE(size, suffix, OP) \
@@ -582,8 +495,9 @@ void IndeoDSP::ffIviMcAvg ## size ##x## size ## suffix(int16 *buf, \
 { \
 	int16 tmp[size * size]; \
 \
-	iviMc ## size ##x## size ## NoDelta(tmp, size, refBuf, pitch, mcType); \
-	iviMc ## size ##x## size ## Delta(tmp, size, refBuf2, pitch, mcType2); \
+	const Kernels &mcKernels = getKernels(); \
+	mcKernels.mc ## size ##x## size ## NoDelta(tmp, size, refBuf, pitch, mcType); \
+	mcKernels.mc ## size ##x## size ## Delta(tmp, size, refBuf2, pitch, mcType2); \
 	for (int i = 0; i < size; i++, buf += pitch) { \
 		for (int j = 0; j < size; j++) {\
 			OP(buf[j], tmp[i * size + j] >> 1); \
@@ -603,5 +517,41 @@ IVI_MC_AVG_TEMPLATE(8, Delta,   OP_ADD)
 IVI_MC_AVG_TEMPLATE(4, NoDelta, OP_PUT)
 IVI_MC_AVG_TEMPLATE(4, Delta,   OP_ADD)
 
+void IndeoDSP::ffIviInverseHaar8x8(const int32 *in, int16 *out, uint32 pitch,
+							 const uint8 *flags) {
+	getKernels().inverseHaar8x8(in, out, pitch, flags);
+}
+
+void IndeoDSP::ffIviInverseSlant8x8(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+	getKernels().inverseSlant8x8(in, out, pitch, flags);
+}
+
+const IndeoDSP::Kernels IndeoDSP::kernelsGeneric = {
+	inverseHaar8x8Generic,
+	inverseSlant8x8Generic,
+	iviMc8x8NoDelta,
+	iviMc8x8Delta,
+	iviMc4x4NoDelta,
+	iviMc4x4Delta
+};
+
+// Initialize this to nullptr at the start
+const IndeoDSP::Kernels *IndeoDSP::kernels = nullptr;
+
+const IndeoDSP::Kernels &IndeoDSP::getKernels() {
+	// If no kernels have been selected yet, detect and select
+	if (!kernels) {
+		kernels = &kernelsGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) kernels = &kernelsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) kernels = &kernelsSSE2;
+#endif
+	}
+
+	return *kernels;
+}
+
 } // End of namespace Indeo
 } // End of namespace Image
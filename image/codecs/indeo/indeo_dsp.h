@@ -327,6 +327,43 @@ public:
 	 *  @param[in]      mcType2		Interpolation type for forward reference
 	 */
 	static void ffIviMcAvg4x4NoDelta(int16 *buf, const int16 *refBuf, const int16 *refBuf2, uint32 pitch, int mcType, int mcType2);
+
+	/**
+	 *  block motion compensation kernel with separate destination and reference pitches
+	 *
+	 *  @param[in,out]  buf			Pointer to the block in the destination buffer
+	 *  @param[in]      dpitch		Pitch for moving to the next y line of the destination
+	 *  @param[in]      refBuf		Pointer to the corresponding block in the reference frame
+	 *  @param[in]      pitch		Pitch for moving to the next y line of the reference frame
+	 *  @param[in]      mcType		Interpolation type
+	 */
+	typedef void (*MCKernel)(int16 *buf, uint32 dpitch, const int16 *refBuf, uint32 pitch, int mcType);
+
+	/**
+	 *  DSP kernels with SIMD implementations. The public functions above
+	 *  go through the set matching the CPU, which is selected on first use.
+	 */
+	struct Kernels {
+		InvTransformPtr *inverseHaar8x8;
+		InvTransformPtr *inverseSlant8x8;
+		MCKernel mc8x8NoDelta;
+		MCKernel mc8x8Delta;
+		MCKernel mc4x4NoDelta;
+		MCKernel mc4x4Delta;
+	};
+
+	static const Kernels kernelsGeneric;
+#ifdef SCUMMVM_SSE2
+	static const Kernels kernelsSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	static const Kernels kernelsNEON;
+#endif
+
+	static const Kernels *kernels;
+
+private:
+	static const Kernels &getKernels();
 };
 
 } // End of namespace Indeo
@@ -0,0 +1,259 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/* VLC code
+ *
+ * Original copyright note:
+ * DSP functions (inverse transforms, motion compensation, wavelet recompositions)
+ * for Indeo Video Interactive codecs.
+ */
+
+#ifndef IMAGE_CODECS_INDEO_INDEO_DSP_INTERN_H
+#define IMAGE_CODECS_INDEO_INDEO_DSP_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Image {
+namespace Indeo {
+
+// The butterfly macros below are shared between the scalar transforms and
+// the SIMD ones, which instantiate them on vectors of four int32 so that
+// both produce bit-identical output.
+
+/**
+ * butterfly operation for the inverse Haar transform
+ */
+#define IVI_HAAR_BFLY(s1, s2, o1, o2, t) \
+	t  = ((s1) - (s2)) >> 1;\
+	o1 = ((s1) + (s2)) >> 1;\
+	o2 = (t);\
+
+/**
+ * inverse 8-point Haar transform
+ */
+#define INV_HAAR8(s1, s5, s3, s7, s2, s4, s6, s8,\
+				  d1, d2, d3, d4, d5, d6, d7, d8,\
+				  t0, t1, t2, t3, t4, t5, t6, t7, t8) {\
+	t1 = (s1) << 1; t5 = (s5) << 1;\
+	IVI_HAAR_BFLY(t1, t5, t1, t5, t0); IVI_HAAR_BFLY(t1, s3, t1, t3, t0);\
+	IVI_HAAR_BFLY(t5, s7, t5, t7, t0); IVI_HAAR_BFLY(t1, s2, t1, t2, t0);\
+	IVI_HAAR_BFLY(t3, s4, t3, t4, t0); IVI_HAAR_BFLY(t5, s6, t5, t6, t0);\
+	IVI_HAAR_BFLY(t7, s8, t7, t8, t0);\
+	d1 = COMPENSATE(t1);\
+	d2 = COMPENSATE(t2);\
+	d3 = COMPENSATE(t3);\
+	d4 = COMPENSATE(t4);\
+	d5 = COMPENSATE(t5);\
+	d6 = COMPENSATE(t6);\
+	d7 = COMPENSATE(t7);\
+	d8 = COMPENSATE(t8); }
+
+/**
+ * inverse 4-point Haar transform
+ */
+#define INV_HAAR4(s1, s3, s5, s7, d1, d2, d3, d4, t0, t1, t2, t3, t4) {\
+	IVI_HAAR_BFLY(s1, s3, t0, t1, t4);\
+	IVI_HAAR_BFLY(t0, s5, t2, t3, t4);\
+	d1 = COMPENSATE(t2);\
+	d2 = COMPENSATE(t3);\
+	IVI_HAAR_BFLY(t1, s7, t2, t3, t4);\
+	d3 = COMPENSATE(t2);\
+	d4 = COMPENSATE(t3); }
+
+//* butterfly operation for the inverse slant transform
+#define IVI_SLANT_BFLY(s1, s2, o1, o2, t) \
+	t  = (s1) - (s2);\
+	o1 = (s1) + (s2);\
+	o2 = (t);\
+
+//* This is a reflection a,b = 1/2, 5/4 for the inverse slant transform
+#define IVI_IREFLECT(s1, s2, o1, o2, t) \
+	t  = (((s1) + (s2)*2 + 2) >> 2) + (s1);\
+	o2 = (((s1)*2 - (s2) + 2) >> 2) - (s2);\
+	o1 = (t);\
+
+//* This is a reflection a,b = 1/2, 7/8 for the inverse slant transform
+#define IVI_SLANT_PART4(s1, s2, o1, o2, t) \
+	t  = (s2) + (((s1)*4  - (s2) + 4) >> 3);\
+	o2 = (s1) + ((-(s1) - (s2)*4 + 4) >> 3);\
+	o1 = (t);\
+
+//* inverse slant8 transform
+#define IVI_INV_SLANT8(s1, s4, s8, s5, s2, s6, s3, s7,\
+					   d1, d2, d3, d4, d5, d6, d7, d8,\
+					   t0, t1, t2, t3, t4, t5, t6, t7, t8) {\
+	IVI_SLANT_PART4(s4, s5, t4, t5, t0);\
+\
+	IVI_SLANT_BFLY(s1, t5, t1, t5, t0); IVI_SLANT_BFLY(s2, s6, t2, t6, t0);\
+	IVI_SLANT_BFLY(s7, s3, t7, t3, t0); IVI_SLANT_BFLY(t4, s8, t4, t8, t0);\
+\
+	IVI_SLANT_BFLY(t1, t2, t1, t2, t0); IVI_IREFLECT  (t4, t3, t4, t3, t0);\
+	IVI_SLANT_BFLY(t5, t6, t5, t6, t0); IVI_IREFLECT  (t8, t7, t8, t7, t0);\
+	IVI_SLANT_BFLY(t1, t4, t1, t4, t0); IVI_SLANT_BFLY(t2, t3, t2, t3, t0);\
+	IVI_SLANT_BFLY(t5, t8, t5, t8, t0); IVI_SLANT_BFLY(t6, t7, t6, t7, t0);\
+	d1 = COMPENSATE(t1);\
+	d2 = COMPENSATE(t2);\
+	d3 = COMPENSATE(t3);\
+	d4 = COMPENSATE(t4);\
+	d5 = COMPENSATE(t5);\
+	d6 = COMPENSATE(t6);\
+	d7 = COMPENSATE(t7);\
+	d8 = COMPENSATE(t8);}
+
+//* inverse slant4 transform
+#define IVI_INV_SLANT4(s1, s4, s2, s3, d1, d2, d3, d4, t0, t1, t2, t3, t4) {\
+	IVI_SLANT_BFLY(s1, s2, t1, t2, t0); IVI_IREFLECT  (s4, s3, t4, t3, t0);\
+\
+	IVI_SLANT_BFLY(t1, t4, t1, t4, t0); IVI_SLANT_BFLY(t2, t3, t2, t3, t0);\
+	d1 = COMPENSATE(t1);\
+	d2 = COMPENSATE(t2);\
+	d3 = COMPENSATE(t3);\
+	d4 = COMPENSATE(t4);}
+
+/**
+ * Transpose an 8x8 matrix held as eight rows of two vectors of four
+ * elements each, lo holding columns 0-3 and hi holding columns 4-7.
+ */
+template<class V>
+static inline void transposeBlock8x8(V *lo, V *hi) {
+	V::transpose(lo[0], lo[1], lo[2], lo[3]);
+	V::transpose(hi[0], hi[1], hi[2], hi[3]);
+	V::transpose(lo[4], lo[5], lo[6], lo[7]);
+	V::transpose(hi[4], hi[5], hi[6], hi[7]);
+
+	for (int i = 0; i < 4; i++) {
+		V t = hi[i];
+		hi[i] = lo[i + 4];
+		lo[i + 4] = t;
+	}
+}
+
+/**
+ * Two-dimensional inverse Haar 8x8 transform on vectors of four int32.
+ * The column pass processes four columns per vector, then the block is
+ * transposed so that the row pass processes four rows per vector.
+ */
+template<class V>
+static void inverseHaar8x8SIMD(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+	V srcLo[8], srcHi[8], dstLo[8], dstHi[8];
+	V t0, t1, t2, t3, t4, t5, t6, t7, t8;
+
+	for (int i = 0; i < 8; i++) {
+		srcLo[i] = V::load(in + i * 8);
+		srcHi[i] = V::load(in + i * 8 + 4);
+	}
+
+	// apply the InvHaar8 to all columns, with the pre-scaling of the
+	// first four columns
+	for (int i = 0; i < 4; i++)
+		srcLo[i] = srcLo[i] << 1;
+
+#define COMPENSATE(x) (x)
+	INV_HAAR8(srcLo[0], srcLo[1], srcLo[2], srcLo[3],
+			  srcLo[4], srcLo[5], srcLo[6], srcLo[7],
+			  dstLo[0], dstLo[1], dstLo[2], dstLo[3],
+			  dstLo[4], dstLo[5], dstLo[6], dstLo[7],
+			  t0, t1, t2, t3, t4, t5, t6, t7, t8);
+	INV_HAAR8(srcHi[0], srcHi[1], srcHi[2], srcHi[3],
+			  srcHi[4], srcHi[5], srcHi[6], srcHi[7],
+			  dstHi[0], dstHi[1], dstHi[2], dstHi[3],
+			  dstHi[4], dstHi[5], dstHi[6], dstHi[7],
+			  t0, t1, t2, t3, t4, t5, t6, t7, t8);
+
+	// empty columns are forced to zero
+	const V maskLo = V::flagMask(flags);
+	const V maskHi = V::flagMask(flags + 4);
+	for (int i = 0; i < 8; i++) {
+		dstLo[i] = dstLo[i] & maskLo;
+		dstHi[i] = dstHi[i] & maskHi;
+	}
+
+	// apply the InvHaar8 to all rows
+	transposeBlock8x8(dstLo, dstHi);
+
+	INV_HAAR8(dstLo[0], dstLo[1], dstLo[2], dstLo[3],
+			  dstLo[4], dstLo[5], dstLo[6], dstLo[7],
+			  srcLo[0], srcLo[1], srcLo[2], srcLo[3],
+			  srcLo[4], srcLo[5], srcLo[6], srcLo[7],
+			  t0, t1, t2, t3, t4, t5, t6, t7, t8);
+	INV_HAAR8(dstHi[0], dstHi[1], dstHi[2], dstHi[3],
+			  dstHi[4], dstHi[5], dstHi[6], dstHi[7],
+			  srcHi[0], srcHi[1], srcHi[2], srcHi[3],
+			  srcHi[4], srcHi[5], srcHi[6], srcHi[7],
+			  t0, t1, t2, t3, t4, t5, t6, t7, t8);
+#undef  COMPENSATE
+
+	transposeBlock8x8(srcLo, srcHi);
+
+	for (int i = 0; i < 8; i++, out += pitch)
+		V::store16(out, srcLo[i], srcHi[i]);
+}
+
+/**
+ * Two-dimensional inverse slant 8x8 transform on vectors of four int32.
+ */
+template<class V>
+static void inverseSlant8x8SIMD(const int32 *in, int16 *out, uint32 pitch, const uint8 *flags) {
+	V srcLo[8], srcHi[8], dstLo[8], dstHi[8];
+	V t0, t1, t2, t3, t4, t5, t6, t7, t8;
+
+	for (int i = 0; i < 8; i++) {
+		srcLo[i] = V::load(in + i * 8);
+		srcHi[i] = V::load(in + i * 8 + 4);
+	}
+
+#define COMPENSATE(x) (x)
+	IVI_INV_SLANT8(srcLo[0], srcLo[1], srcLo[2], srcLo[3], srcLo[4], srcLo[5], srcLo[6], srcLo[7],
+				   dstLo[0], dstLo[1], dstLo[2], dstLo[3], dstLo[4], dstLo[5], dstLo[6], dstLo[7],
+				   t0, t1, t2, t3, t4, t5, t6, t7, t8);
+	IVI_INV_SLANT8(srcHi[0], srcHi[1], srcHi[2], srcHi[3], srcHi[4], srcHi[5], srcHi[6], srcHi[7],
+				   dstHi[0], dstHi[1], dstHi[2], dstHi[3], dstHi[4], dstHi[5], dstHi[6], dstHi[7],
+				   t0, t1, t2, t3, t4, t5, t6, t7, t8);
+#undef COMPENSATE
+
+	const V maskLo = V::flagMask(flags);
+	const V maskHi = V::flagMask(flags + 4);
+	for (int i = 0; i < 8; i++) {
+		dstLo[i] = dstLo[i] & maskLo;
+		dstHi[i] = dstHi[i] & maskHi;
+	}
+
+	transposeBlock8x8(dstLo, dstHi);
+
+#define COMPENSATE(x) (((x) + 1)>>1)
+	IVI_INV_SLANT8(dstLo[0], dstLo[1], dstLo[2], dstLo[3], dstLo[4], dstLo[5], dstLo[6], dstLo[7],
+				   srcLo[0], srcLo[1], srcLo[2], srcLo[3], srcLo[4], srcLo[5], srcLo[6], srcLo[7],
+				   t0, t1, t2, t3, t4, t5, t6, t7, t8);
+	IVI_INV_SLANT8(dstHi[0], dstHi[1], dstHi[2], dstHi[3], dstHi[4], dstHi[5], dstHi[6], dstHi[7],
+				   srcHi[0], srcHi[1], srcHi[2], srcHi[3], srcHi[4], srcHi[5], srcHi[6], srcHi[7],
+				   t0, t1, t2, t3, t4, t5, t6, t7, t8);
+#undef COMPENSATE
+
+	transposeBlock8x8(srcLo, srcHi);
+
+	for (int i = 0; i < 8; i++, out += pitch)
+		V::store16(out, srcLo[i], srcHi[i]);
+}
+
+} // End of namespace Indeo
+} // End of namespace Image
+
+#endif
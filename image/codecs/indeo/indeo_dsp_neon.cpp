@@ -0,0 +1,157 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "image/codecs/indeo/indeo_dsp.h"
+#include "image/codecs/indeo/indeo_dsp_intern.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Image {
+namespace Indeo {
+
+/**
+ * Four int32 lanes, with the operators needed by the transform macros.
+ */
+struct Vec4NEON {
+	int32x4_t v;
+
+	Vec4NEON() : v(vdupq_n_s32(0)) {}
+	Vec4NEON(int32x4_t x) : v(x) {}
+
+	static Vec4NEON load(const int32 *src) {
+		return vld1q_s32(src);
+	}
+
+	static Vec4NEON flagMask(const uint8 *flags) {
+		const int32 mask[4] = {
+			flags[0] ? -1 : 0, flags[1] ? -1 : 0, flags[2] ? -1 : 0, flags[3] ? -1 : 0
+		};
+		return vld1q_s32(mask);
+	}
+
+	static void transpose(Vec4NEON &a, Vec4NEON &b, Vec4NEON &c, Vec4NEON &d) {
+		int32x4x2_t ab = vtrnq_s32(a.v, b.v);
+		int32x4x2_t cd = vtrnq_s32(c.v, d.v);
+		a.v = vcombine_s32(vget_low_s32(ab.val[0]), vget_low_s32(cd.val[0]));
+		b.v = vcombine_s32(vget_low_s32(ab.val[1]), vget_low_s32(cd.val[1]));
+		c.v = vcombine_s32(vget_high_s32(ab.val[0]), vget_high_s32(cd.val[0]));
+		d.v = vcombine_s32(vget_high_s32(ab.val[1]), vget_high_s32(cd.val[1]));
+	}
+
+	static void store16(int16 *dst, const Vec4NEON &lo, const Vec4NEON &hi) {
+		// vmovn truncates like the scalar int -> int16 conversion
+		vst1q_s16(dst, vcombine_s16(vmovn_s32(lo.v), vmovn_s32(hi.v)));
+	}
+};
+
+static inline Vec4NEON operator+(const Vec4NEON &a, const Vec4NEON &b) { return vaddq_s32(a.v, b.v); }
+static inline Vec4NEON operator-(const Vec4NEON &a, const Vec4NEON &b) { return vsubq_s32(a.v, b.v); }
+static inline Vec4NEON operator+(const Vec4NEON &a, int b) { return vaddq_s32(a.v, vdupq_n_s32(b)); }
+static inline Vec4NEON operator-(const Vec4NEON &a) { return vnegq_s32(a.v); }
+static inline Vec4NEON operator&(const Vec4NEON &a, const Vec4NEON &b) { return vandq_s32(a.v, b.v); }
+static inline Vec4NEON operator<<(const Vec4NEON &a, int b) { return vshlq_s32(a.v, vdupq_n_s32(b)); }
+static inline Vec4NEON operator>>(const Vec4NEON &a, int b) { return vshlq_s32(a.v, vdupq_n_s32(-b)); }
+static inline Vec4NEON operator*(const Vec4NEON &a, int b) { return vmulq_n_s32(a.v, b); }
+
+template<int size>
+static inline int16x8_t loadRow(const int16 *src) {
+	return size == 8 ? vld1q_s16(src) : vcombine_s16(vld1_s16(src), vdup_n_s16(0));
+}
+
+template<int size>
+static inline void storeRow(int16 *dst, int16x8_t row) {
+	if (size == 8)
+		vst1q_s16(dst, row);
+	else
+		vst1_s16(dst, vget_low_s16(row));
+}
+
+// (a + b + c + d) >> 2, computed on 32 bits
+static inline int16x8_t average4(int16x8_t a, int16x8_t b, int16x8_t c, int16x8_t d) {
+	int32x4_t lo = vaddq_s32(vaddl_s16(vget_low_s16(a), vget_low_s16(b)), vaddl_s16(vget_low_s16(c), vget_low_s16(d)));
+	int32x4_t hi = vaddq_s32(vaddl_s16(vget_high_s16(a), vget_high_s16(b)), vaddl_s16(vget_high_s16(c), vget_high_s16(d)));
+	return vcombine_s16(vshrn_n_s32(lo, 2), vshrn_n_s32(hi, 2));
+}
+
+template<int size, bool delta>
+static inline void outputRow(int16 *dst, int16x8_t row) {
+	if (delta)
+		row = vaddq_s16(loadRow<size>(dst), row);
+	storeRow<size>(dst, row);
+}
+
+template<int size, bool delta>
+static void mcNEON(int16 *buf, uint32 dpitch, const int16 *refBuf, uint32 pitch, int mcType) {
+	const int16 *wptr = refBuf + pitch;
+
+	switch (mcType) {
+	case 0: // fullpel (no interpolation)
+		for (int i = 0; i < size; i++, buf += dpitch, refBuf += pitch)
+			outputRow<size, delta>(buf, loadRow<size>(refBuf));
+		break;
+	case 1: // horizontal halfpel interpolation
+		for (int i = 0; i < size; i++, buf += dpitch, refBuf += pitch)
+			outputRow<size, delta>(buf, vhaddq_s16(loadRow<size>(refBuf), loadRow<size>(refBuf + 1)));
+		break;
+	case 2: // vertical halfpel interpolation
+		for (int i = 0; i < size; i++, buf += dpitch, wptr += pitch, refBuf += pitch)
+			outputRow<size, delta>(buf, vhaddq_s16(loadRow<size>(refBuf), loadRow<size>(wptr)));
+		break;
+	case 3: // vertical and horizontal halfpel interpolation
+		for (int i = 0; i < size; i++, buf += dpitch, wptr += pitch, refBuf += pitch)
+			outputRow<size, delta>(buf, average4(loadRow<size>(refBuf), loadRow<size>(refBuf + 1),
+			                                     loadRow<size>(wptr), loadRow<size>(wptr + 1)));
+		break;
+	default:
+		break;
+	}
+}
+
+const IndeoDSP::Kernels IndeoDSP::kernelsNEON = {
+	inverseHaar8x8SIMD<Vec4NEON>,
+	inverseSlant8x8SIMD<Vec4NEON>,
+	mcNEON<8, false>,
+	mcNEON<8, true>,
+	mcNEON<4, false>,
+	mcNEON<4, true>
+};
+
+} // End of namespace Indeo
+} // End of namespace Image
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,167 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "image/codecs/indeo/indeo_dsp.h"
+#include "image/codecs/indeo/indeo_dsp_intern.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Image {
+namespace Indeo {
+
+/**
+ * Four int32 lanes, with the operators needed by the transform macros.
+ */
+struct Vec4SSE2 {
+	__m128i v;
+
+	Vec4SSE2() : v(_mm_setzero_si128()) {}
+	Vec4SSE2(__m128i x) : v(x) {}
+
+	static Vec4SSE2 load(const int32 *src) {
+		return _mm_loadu_si128((const __m128i *)src);
+	}
+
+	static Vec4SSE2 flagMask(const uint8 *flags) {
+		__m128i f = _mm_setr_epi32(flags[0], flags[1], flags[2], flags[3]);
+		return _mm_andnot_si128(_mm_cmpeq_epi32(f, _mm_setzero_si128()), _mm_set1_epi32(-1));
+	}
+
+	static void transpose(Vec4SSE2 &a, Vec4SSE2 &b, Vec4SSE2 &c, Vec4SSE2 &d) {
+		__m128i t0 = _mm_unpacklo_epi32(a.v, b.v);
+		__m128i t1 = _mm_unpacklo_epi32(c.v, d.v);
+		__m128i t2 = _mm_unpackhi_epi32(a.v, b.v);
+		__m128i t3 = _mm_unpackhi_epi32(c.v, d.v);
+		a.v = _mm_unpacklo_epi64(t0, t1);
+		b.v = _mm_unpackhi_epi64(t0, t1);
+		c.v = _mm_unpacklo_epi64(t2, t3);
+		d.v = _mm_unpackhi_epi64(t2, t3);
+	}
+
+	static void store16(int16 *dst, const Vec4SSE2 &lo, const Vec4SSE2 &hi) {
+		// Truncate like the scalar int -> int16 conversion, rather than saturating
+		__m128i l = _mm_srai_epi32(_mm_slli_epi32(lo.v, 16), 16);
+		__m128i h = _mm_srai_epi32(_mm_slli_epi32(hi.v, 16), 16);
+		_mm_storeu_si128((__m128i *)dst, _mm_packs_epi32(l, h));
+	}
+};
+
+static inline Vec4SSE2 operator+(const Vec4SSE2 &a, const Vec4SSE2 &b) { return _mm_add_epi32(a.v, b.v); }
+static inline Vec4SSE2 operator-(const Vec4SSE2 &a, const Vec4SSE2 &b) { return _mm_sub_epi32(a.v, b.v); }
+static inline Vec4SSE2 operator+(const Vec4SSE2 &a, int b) { return _mm_add_epi32(a.v, _mm_set1_epi32(b)); }
+static inline Vec4SSE2 operator-(const Vec4SSE2 &a) { return _mm_sub_epi32(_mm_setzero_si128(), a.v); }
+static inline Vec4SSE2 operator&(const Vec4SSE2 &a, const Vec4SSE2 &b) { return _mm_and_si128(a.v, b.v); }
+static inline Vec4SSE2 operator<<(const Vec4SSE2 &a, int b) { return _mm_sll_epi32(a.v, _mm_cvtsi32_si128(b)); }
+static inline Vec4SSE2 operator>>(const Vec4SSE2 &a, int b) { return _mm_sra_epi32(a.v, _mm_cvtsi32_si128(b)); }
+static inline Vec4SSE2 operator*(const Vec4SSE2 &a, int b) {
+	// The transforms only scale by powers of two
+	assert(b == 2 || b == 4);
+	return a << (b == 2 ? 1 : 2);
+}
+
+template<int size>
+static inline __m128i loadRow(const int16 *src) {
+	return size == 8 ? _mm_loadu_si128((const __m128i *)src) : _mm_loadl_epi64((const __m128i *)src);
+}
+
+template<int size>
+static inline void storeRow(int16 *dst, __m128i row) {
+	if (size == 8)
+		_mm_storeu_si128((__m128i *)dst, row);
+	else
+		_mm_storel_epi64((__m128i *)dst, row);
+}
+
+// (a + b) >> 1 without overflowing 16 bits
+static inline __m128i average2(__m128i a, __m128i b) {
+	__m128i odd = _mm_and_si128(_mm_and_si128(a, b), _mm_set1_epi16(1));
+	return _mm_add_epi16(_mm_add_epi16(_mm_srai_epi16(a, 1), _mm_srai_epi16(b, 1)), odd);
+}
+
+// (a + b + c + d) >> 2, computed on 32 bits
+static inline __m128i average4(__m128i a, __m128i b, __m128i c, __m128i d) {
+	__m128i lo = _mm_add_epi32(_mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(a, a), 16), _mm_srai_epi32(_mm_unpacklo_epi16(b, b), 16)),
+	                           _mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(c, c), 16), _mm_srai_epi32(_mm_unpacklo_epi16(d, d), 16)));
+	__m128i hi = _mm_add_epi32(_mm_add_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(a, a), 16), _mm_srai_epi32(_mm_unpackhi_epi16(b, b), 16)),
+	                           _mm_add_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(c, c), 16), _mm_srai_epi32(_mm_unpackhi_epi16(d, d), 16)));
+	return _mm_packs_epi32(_mm_srai_epi32(lo, 2), _mm_srai_epi32(hi, 2));
+}
+
+template<int size, bool delta>
+static inline void outputRow(int16 *dst, __m128i row) {
+	if (delta)
+		row = _mm_add_epi16(loadRow<size>(dst), row);
+	storeRow<size>(dst, row);
+}
+
+template<int size, bool delta>
+static void mcSSE2(int16 *buf, uint32 dpitch, const int16 *refBuf, uint32 pitch, int mcType) {
+	const int16 *wptr = refBuf + pitch;
+
+	switch (mcType) {
+	case 0: // fullpel (no interpolation)
+		for (int i = 0; i < size; i++, buf += dpitch, refBuf += pitch)
+			outputRow<size, delta>(buf, loadRow<size>(refBuf));
+		break;
+	case 1: // horizontal halfpel interpolation
+		for (int i = 0; i < size; i++, buf += dpitch, refBuf += pitch)
+			outputRow<size, delta>(buf, average2(loadRow<size>(refBuf), loadRow<size>(refBuf + 1)));
+		break;
+	case 2: // vertical halfpel interpolation
+		for (int i = 0; i < size; i++, buf += dpitch, wptr += pitch, refBuf += pitch)
+			outputRow<size, delta>(buf, average2(loadRow<size>(refBuf), loadRow<size>(wptr)));
+		break;
+	case 3: // vertical and horizontal halfpel interpolation
+		for (int i = 0; i < size; i++, buf += dpitch, wptr += pitch, refBuf += pitch)
+			outputRow<size, delta>(buf, average4(loadRow<size>(refBuf), loadRow<size>(refBuf + 1),
+			                                     loadRow<size>(wptr), loadRow<size>(wptr + 1)));
+		break;
+	default:
+		break;
+	}
+}
+
+const IndeoDSP::Kernels IndeoDSP::kernelsSSE2 = {
+	inverseHaar8x8SIMD<Vec4SSE2>,
+	inverseSlant8x8SIMD<Vec4SSE2>,
+	mcSSE2<8, false>,
+	mcSSE2<8, true>,
+	mcSSE2<4, false>,
+	mcSSE2<4, true>
+};
+
+} // End of namespace Indeo
+} // End of namespace Image
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -42,6 +42,10 @@ QTRLEDecoder::QTRLEDecoder(uint16 width, uint16 height, byte bitsPerPixel) : Cod
 	_dirtyPalette = false;
 	_colorMap = 0;
 
+	// 24bpp and 32bpp are decoded straight into the output format
+	if (bitsPerPixel == 24 || bitsPerPixel == 32)
+		_pixelFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24);
+
 	// We need to ensure the width is a multiple of 4
 	_paddedWidth = width;
 	uint16 wMod = width % 4;
@@ -262,9 +266,11 @@ void QTRLEDecoder::decode16(Common::SeekableReadStream &stream, uint32 rowPtr, u
 	}
 }
 
+template<typename PixelInt>
 void QTRLEDecoder::decode24(Common::SeekableReadStream &stream, uint32 rowPtr, uint32 linesToChange) {
 	uint32 pixelPtr = 0;
-	uint32 *rgb = (uint32 *)_surface->getPixels();
+	PixelInt *rgb = (PixelInt *)_surface->getPixels();
+	const Graphics::PixelFormat &format = _surface->format;
 
 	while (linesToChange--) {
 		CHECK_STREAM_PTR(2);
@@ -284,7 +290,7 @@ void QTRLEDecoder::decode24(Common::SeekableReadStream &stream, uint32 rowPtr, u
 				byte r = stream.readByte();
 				byte g = stream.readByte();
 				byte b = stream.readByte();
-				uint32 color = _surface->format.RGBToColor(r, g, b);
+				PixelInt color = format.RGBToColor(r, g, b);
 
 				CHECK_PIXEL_PTR(rleCode);
 
@@ -299,7 +305,7 @@ void QTRLEDecoder::decode24(Common::SeekableReadStream &stream, uint32 rowPtr, u
 					byte r = stream.readByte();
 					byte g = stream.readByte();
 					byte b = stream.readByte();
-					rgb[pixelPtr++] = _surface->format.RGBToColor(r, g, b);
+					rgb[pixelPtr++] = format.RGBToColor(r, g, b);
 				}
 			}
 		}
@@ -373,9 +379,11 @@ void QTRLEDecoder::dither24(Common::SeekableReadStream &stream, uint32 rowPtr, u
 	}
 }
 
+template<typename PixelInt>
 void QTRLEDecoder::decode32(Common::SeekableReadStream &stream, uint32 rowPtr, uint32 linesToChange) {
 	uint32 pixelPtr = 0;
-	uint32 *rgb = (uint32 *)_surface->getPixels();
+	PixelInt *rgb = (PixelInt *)_surface->getPixels();
+	const Graphics::PixelFormat &format = _surface->format;
 
 	while (linesToChange--) {
 		CHECK_STREAM_PTR(2);
@@ -396,7 +404,7 @@ void QTRLEDecoder::decode32(Common::SeekableReadStream &stream, uint32 rowPtr, u
 				byte r = stream.readByte();
 				byte g = stream.readByte();
 				byte b = stream.readByte();
-				uint32 color = _surface->format.ARGBToColor(a, r, g, b);
+				PixelInt color = format.ARGBToColor(a, r, g, b);
 
 				CHECK_PIXEL_PTR(rleCode);
 
@@ -412,7 +420,7 @@ void QTRLEDecoder::decode32(Common::SeekableReadStream &stream, uint32 rowPtr, u
 					byte r = stream.readByte();
 					byte g = stream.readByte();
 					byte b = stream.readByte();
-					rgb[pixelPtr++] = _surface->format.ARGBToColor(a, r, g, b);
+					rgb[pixelPtr++] = format.ARGBToColor(a, r, g, b);
 				}
 			}
 		}
@@ -428,6 +436,8 @@ const Graphics::Surface *QTRLEDecoder::decodeFrame(Common::SeekableReadStream &s
 	uint16 startLine = 0;
 	uint16 height = _height;
 
+	_dirtyRect = Common::Rect();
+
 	// check if this frame is even supposed to change
 	if (stream.size() < 8)
 		return _surface;
@@ -451,6 +461,8 @@ const Graphics::Surface *QTRLEDecoder::decodeFrame(Common::SeekableReadStream &s
 
 	uint32 rowPtr = _paddedWidth * startLine;
 
+	_dirtyRect = Common::Rect(0, MIN(startLine, _height), _width, MIN<uint32>(startLine + height, _height));
+
 	switch (_bitsPerPixel) {
 	case 1:
 	case 33:
@@ -474,11 +486,16 @@ const Graphics::Surface *QTRLEDecoder::decodeFrame(Common::SeekableReadStream &s
 	case 24:
 		if (_ditherPalette)
 			dither24(stream, rowPtr, height);
+		else if (_surface->format.bytesPerPixel == 2)
+			decode24<uint16>(stream, rowPtr, height);
 		else
-			decode24(stream, rowPtr, height);
+			decode24<uint32>(stream, rowPtr, height);
 		break;
 	case 32:
-		decode32(stream, rowPtr, height);
+		if (_surface->format.bytesPerPixel == 2)
+			decode32<uint16>(stream, rowPtr, height);
+		else
+			decode32<uint32>(stream, rowPtr, height);
 		break;
 	default:
 		error("Unsupported QTRLE bits per pixel %d", _bitsPerPixel);
@@ -505,7 +522,7 @@ Graphics::PixelFormat QTRLEDecoder::getPixelFormat() const {
 		return Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0);
 	case 24:
 	case 32:
-		return Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		return _pixelFormat;
 	default:
 		error("Unsupported QTRLE bits per pixel %d", _bitsPerPixel);
 	}
@@ -513,6 +530,22 @@ Graphics::PixelFormat QTRLEDecoder::getPixelFormat() const {
 	return Graphics::PixelFormat();
 }
 
+bool QTRLEDecoder::setOutputPixelFormat(const Graphics::PixelFormat &format) {
+	// Only the truecolor depths are converted while decoding
+	if (_bitsPerPixel != 24 && _bitsPerPixel != 32)
+		return false;
+
+	if (format.bytesPerPixel != 2 && format.bytesPerPixel != 4)
+		return false;
+
+	// The frame surface is already allocated in the old format
+	if (_surface)
+		return format == _pixelFormat;
+
+	_pixelFormat = format;
+	return true;
+}
+
 bool QTRLEDecoder::canDither(DitherType type) const {
 	// Only 24-bit dithering is implemented at the moment
 	return type == kDitherTypeQT && _bitsPerPixel == 24;
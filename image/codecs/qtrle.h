@@ -39,12 +39,14 @@ public:
 
 	const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream) override;
 	Graphics::PixelFormat getPixelFormat() const override;
+	bool setOutputPixelFormat(const Graphics::PixelFormat &format) override;
 
 	bool containsPalette() const override { return _ditherPalette != 0; }
 	const byte *getPalette() override { _dirtyPalette = false; return _ditherPalette; }
 	bool hasDirtyPalette() const override { return _dirtyPalette; }
 	bool canDither(DitherType type) const override;
 	void setDither(DitherType type, const byte *palette) override;
+	bool getDirtyRect(Common::Rect &rect) const override { rect = _dirtyRect; return true; }
 
 private:
 	byte _bitsPerPixel;
@@ -54,6 +56,8 @@ private:
 	byte *_ditherPalette;
 	bool _dirtyPalette;
 	byte *_colorMap;
+	Graphics::PixelFormat _pixelFormat;
+	Common::Rect _dirtyRect;
 
 	void createSurface();
 
@@ -61,8 +65,10 @@ private:
 	void decode2_4(Common::SeekableReadStream &stream, uint32 rowPtr, uint32 linesToChange, byte bpp);
 	void decode8(Common::SeekableReadStream &stream, uint32 rowPtr, uint32 linesToChange);
 	void decode16(Common::SeekableReadStream &stream, uint32 rowPtr, uint32 linesToChange);
+	template<typename PixelInt>
 	void decode24(Common::SeekableReadStream &stream, uint32 rowPtr, uint32 linesToChange);
 	void dither24(Common::SeekableReadStream &stream, uint32 rowPtr, uint32 linesToChange);
+	template<typename PixelInt>
 	void decode32(Common::SeekableReadStream &stream, uint32 rowPtr, uint32 linesToChange);
 };
 
@@ -31,7 +31,7 @@
 namespace Image {
 
 RPZADecoder::RPZADecoder(uint16 width, uint16 height) : Codec() {
-	_format = Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0);
+	_format = getNativePixelFormat();
 	_ditherPalette = 0;
 	_dirtyPalette = false;
 	_colorMap = 0;
@@ -62,8 +62,18 @@ RPZADecoder::~RPZADecoder() {
 	if (totalBlocks < 0) \
 		error("rpza block counter just went negative (this should not happen)") \
 
+/**
+ * Block writer for the native RGB555 output.
+ */
+template<typename PixelInt>
 struct BlockDecoderRaw {
-	static inline void drawFillBlock(uint16 *blockPtr, uint16 pitch, uint16 color, const byte *colorMap) {
+	typedef PixelInt Color;
+
+	static inline Color convertColor(uint16 color, const Graphics::PixelFormat &format) {
+		return color;
+	}
+
+	static inline void drawFillBlock(PixelInt *blockPtr, uint16 pitch, Color color, const byte *colorMap) {
 		blockPtr[0] = color;
 		blockPtr[1] = color;
 		blockPtr[2] = color;
@@ -85,7 +95,7 @@ struct BlockDecoderRaw {
 		blockPtr[3] = color;
 	}
 
-	static inline void drawRawBlock(uint16 *blockPtr, uint16 pitch, const uint16 (&colors)[16], const byte *colorMap) {
+	static inline void drawRawBlock(PixelInt *blockPtr, uint16 pitch, const Color (&colors)[16], const byte *colorMap) {
 		blockPtr[0] = colors[0];
 		blockPtr[1] = colors[1];
 		blockPtr[2] = colors[2];
@@ -107,7 +117,7 @@ struct BlockDecoderRaw {
 		blockPtr[3] = colors[15];
 	}
 
-	static inline void drawBlendBlock(uint16 *blockPtr, uint16 pitch, const uint16 (&colors)[4], const byte (&indexes)[4], const byte *colorMap) {
+	static inline void drawBlendBlock(PixelInt *blockPtr, uint16 pitch, const Color (&colors)[4], const byte (&indexes)[4], const byte *colorMap) {
 		blockPtr[0] = colors[(indexes[0] >> 6) & 0x03];
 		blockPtr[1] = colors[(indexes[0] >> 4) & 0x03];
 		blockPtr[2] = colors[(indexes[0] >> 2) & 0x03];
@@ -130,7 +140,27 @@ struct BlockDecoderRaw {
 	}
 };
 
+/**
+ * Block writer for any other truecolor output format. Colors are converted
+ * once per opcode, so fill and blend runs cost no more than the native path.
+ */
+template<typename PixelInt>
+struct BlockDecoderConvert : public BlockDecoderRaw<PixelInt> {
+	static inline PixelInt convertColor(uint16 color, const Graphics::PixelFormat &format) {
+		byte r = (color >> 10) & 0x1F;
+		byte g = (color >> 5) & 0x1F;
+		byte b = color & 0x1F;
+		return format.RGBToColor((r << 3) | (r >> 2), (g << 3) | (g >> 2), (b << 3) | (b >> 2));
+	}
+};
+
 struct BlockDecoderDither {
+	typedef uint16 Color;
+
+	static inline Color convertColor(uint16 color, const Graphics::PixelFormat &format) {
+		return color;
+	}
+
 	static inline void drawFillBlock(byte *blockPtr, uint16 pitch, uint16 color, const byte *colorMap) {
 		const byte *mapOffset = colorMap + (color >> 1);
 		byte pixel1 = mapOffset[0x0000];
@@ -205,7 +235,9 @@ struct BlockDecoderDither {
 };
 
 template<typename PixelInt, typename BlockDecoder>
-static inline void decodeFrameTmpl(Common::SeekableReadStream &stream, PixelInt *ptr, uint16 pitch, uint16 blockWidth, uint16 blockHeight, const byte *colorMap) {
+static inline void decodeFrameTmpl(Common::SeekableReadStream &stream, PixelInt *ptr, uint16 pitch, uint16 blockWidth, uint16 blockHeight, const byte *colorMap, const Graphics::PixelFormat &format) {
+	typedef typename BlockDecoder::Color Color;
+
 	uint16 colorA = 0, colorB = 0;
 	uint16 color4[4];
 
@@ -257,14 +289,17 @@ static inline void decodeFrameTmpl(Common::SeekableReadStream &stream, PixelInt
 				ADVANCE_BLOCK();
 			}
 			break;
-		case 0xa0: // Fill blocks with one color
+		case 0xa0: { // Fill blocks with one color
 			colorA = stream.readUint16BE();
 
+			const Color fillColor = BlockDecoder::convertColor(colorA, format);
+
 			while (numBlocks--) {
-				BlockDecoder::drawFillBlock(blockPtr, pitch, colorA, colorMap);
+				BlockDecoder::drawFillBlock(blockPtr, pitch, fillColor, colorMap);
 				ADVANCE_BLOCK();
 			}
 			break;
+		}
 
 		// Fill blocks with 4 colors
 		case 0xc0:
@@ -297,22 +332,26 @@ static inline void decodeFrameTmpl(Common::SeekableReadStream &stream, PixelInt
 			color4[1] |= ((11 * ta + 21 * tb) >> 5);
 			color4[2] |= ((21 * ta + 11 * tb) >> 5);
 
+			Color blendColors[4];
+			for (int i = 0; i < 4; i++)
+				blendColors[i] = BlockDecoder::convertColor(color4[i], format);
+
 			while (numBlocks--) {
 				byte indexes[4];
 				stream.read(indexes, 4);
 
-				BlockDecoder::drawBlendBlock(blockPtr, pitch, color4, indexes, colorMap);
+				BlockDecoder::drawBlendBlock(blockPtr, pitch, blendColors, indexes, colorMap);
 				ADVANCE_BLOCK();
 			}
 			break;
 
 		// Fill block with 16 colors
 		case 0x00: {
-			uint16 colors[16];
-			colors[0] = colorA;
+			Color colors[16];
+			colors[0] = BlockDecoder::convertColor(colorA, format);
 
 			for (int i = 0; i < 15; i++)
-				colors[i + 1] = stream.readUint16BE();
+				colors[i + 1] = BlockDecoder::convertColor(stream.readUint16BE(), format);
 
 			BlockDecoder::drawRawBlock(blockPtr, pitch, colors, colorMap);
 			ADVANCE_BLOCK();
@@ -338,14 +377,32 @@ const Graphics::Surface *RPZADecoder::decodeFrame(Common::SeekableReadStream &st
 		_surface->h = _height;
 	}
 
+	const Graphics::PixelFormat &format = _surface->format;
+
 	if (_colorMap)
-		decodeFrameTmpl<byte, BlockDecoderDither>(stream, (byte *)_surface->getPixels(), _surface->pitch, _blockWidth, _blockHeight, _colorMap);
+		decodeFrameTmpl<byte, BlockDecoderDither>(stream, (byte *)_surface->getPixels(), _surface->pitch, _blockWidth, _blockHeight, _colorMap, format);
+	else if (format == getNativePixelFormat())
+		decodeFrameTmpl<uint16, BlockDecoderRaw<uint16> >(stream, (uint16 *)_surface->getPixels(), _surface->pitch / 2, _blockWidth, _blockHeight, _colorMap, format);
+	else if (format.bytesPerPixel == 2)
+		decodeFrameTmpl<uint16, BlockDecoderConvert<uint16> >(stream, (uint16 *)_surface->getPixels(), _surface->pitch / 2, _blockWidth, _blockHeight, _colorMap, format);
 	else
-		decodeFrameTmpl<uint16, BlockDecoderRaw>(stream, (uint16 *)_surface->getPixels(), _surface->pitch / 2, _blockWidth, _blockHeight, _colorMap);
+		decodeFrameTmpl<uint32, BlockDecoderConvert<uint32> >(stream, (uint32 *)_surface->getPixels(), _surface->pitch / 4, _blockWidth, _blockHeight, _colorMap, format);
 
 	return _surface;
 }
 
+bool RPZADecoder::setOutputPixelFormat(const Graphics::PixelFormat &format) {
+	if (_colorMap || (format.bytesPerPixel != 2 && format.bytesPerPixel != 4))
+		return false;
+
+	// The frame surface is already allocated in the old format
+	if (_surface)
+		return format == _format;
+
+	_format = format;
+	return true;
+}
+
 bool RPZADecoder::canDither(DitherType type) const {
 	return type == kDitherTypeQT;
 }
@@ -39,6 +39,7 @@ public:
 
 	const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream) override;
 	Graphics::PixelFormat getPixelFormat() const override { return _format; }
+	bool setOutputPixelFormat(const Graphics::PixelFormat &format) override;
 
 	bool containsPalette() const override { return _ditherPalette != 0; }
 	const byte *getPalette() override { _dirtyPalette = false; return _ditherPalette; }
@@ -47,6 +48,8 @@ public:
 	void setDither(DitherType type, const byte *palette) override;
 
 private:
+	static Graphics::PixelFormat getNativePixelFormat() { return Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0); }
+
 	Graphics::PixelFormat _format;
 	Graphics::Surface *_surface;
 	byte *_ditherPalette;
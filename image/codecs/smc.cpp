@@ -84,6 +84,10 @@ const Graphics::Surface *SMCDecoder::decodeFrame(Common::SeekableReadStream &str
 
 	uint32 pixelSize = _surface->w * _surface->h;
 
+	// Assume everything changed, in case decoding bails out early
+	_dirtyRect = Common::Rect(_surface->w, _surface->h);
+	int32 dirtyTop = -1, dirtyBottom = -1;
+
 	// traverse through the blocks
 	while (totalBlocks != 0) {
 		// sanity checks
@@ -102,6 +106,11 @@ const Graphics::Surface *SMCDecoder::decodeFrame(Common::SeekableReadStream &str
 
 		byte opcode = stream.readByte();
 
+		// Everything but skips writes blocks, starting at the current one
+		const bool skipOpcode = (opcode & 0xE0) == 0x00;
+		if (!skipOpcode && dirtyTop < 0)
+			dirtyTop = rowPtr / _surface->w;
+
 		switch (opcode & 0xF0) {
 		// skip n blocks
 		case 0x00:
@@ -409,8 +418,16 @@ const Graphics::Surface *SMCDecoder::decodeFrame(Common::SeekableReadStream &str
 		default:
 			break;
 		}
+
+		if (!skipOpcode)
+			dirtyBottom = rowPtr / _surface->w + (pixelPtr != 0 ? 4 : 0);
 	}
 
+	if (dirtyTop < 0)
+		_dirtyRect = Common::Rect();
+	else
+		_dirtyRect = Common::Rect(0, dirtyTop, _surface->w, MIN<int32>(MAX(dirtyBottom, dirtyTop + 4), _surface->h));
+
 	return _surface;
 }
 
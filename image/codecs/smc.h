@@ -45,9 +45,11 @@ public:
 
 	const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream) override;
 	Graphics::PixelFormat getPixelFormat() const override { return Graphics::PixelFormat::createFormatCLUT8(); }
+	bool getDirtyRect(Common::Rect &rect) const override { rect = _dirtyRect; return true; }
 
 private:
 	Graphics::Surface *_surface;
+	Common::Rect _dirtyRect;
 
 	// SMC color tables
 	byte _colorPairs[COLORS_PER_TABLE * CPAIR];
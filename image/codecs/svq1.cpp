@@ -616,6 +616,29 @@ void SVQ1Decoder::putPixels16XY2C(byte *block, const byte *pixels, int lineSize,
 	putPixels8XY2C(block + 8, pixels + 8, lineSize, h);
 }
 
+const SVQ1Decoder::MCKernels SVQ1Decoder::mcKernelsGeneric = {
+	{ putPixels8C, putPixels8X2C, putPixels8Y2C, putPixels8XY2C },
+	{ putPixels16C, putPixels16X2C, putPixels16Y2C, putPixels16XY2C }
+};
+
+// Initialize this to nullptr at the start
+const SVQ1Decoder::MCKernels *SVQ1Decoder::mcKernels = nullptr;
+
+const SVQ1Decoder::MCKernels &SVQ1Decoder::getMCKernels() {
+	// If no kernels have been selected yet, detect and select
+	if (!mcKernels) {
+		mcKernels = &mcKernelsGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) mcKernels = &mcKernelsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) mcKernels = &mcKernelsSSE2;
+#endif
+	}
+
+	return *mcKernels;
+}
+
 bool SVQ1Decoder::svq1MotionInterBlock(Common::BitStream32BEMSB *ss, byte *current, byte *previous, int pitch,
 		Common::Point *motion, int x, int y) {
 
@@ -649,22 +672,7 @@ bool SVQ1Decoder::svq1MotionInterBlock(Common::BitStream32BEMSB *ss, byte *curre
 	// Halfpel motion compensation with rounding (a + b + 1) >> 1.
 	// 4 motion compensation functions for the 4 halfpel positions
 	// for 16x16 blocks
-	switch(((mv.y & 1) << 1) + (mv.x & 1)) {
-	case 0:
-		putPixels16C(dst, src, pitch, 16);
-		break;
-	case 1:
-		putPixels16X2C(dst, src, pitch, 16);
-		break;
-	case 2:
-		putPixels16Y2C(dst, src, pitch, 16);
-		break;
-	case 3:
-		putPixels16XY2C(dst, src, pitch, 16);
-		break;
-	default:
-		break;
-	}
+	getMCKernels().put16[((mv.y & 1) << 1) + (mv.x & 1)](dst, src, pitch, 16);
 
 	return true;
 }
@@ -731,22 +739,7 @@ bool SVQ1Decoder::svq1MotionInter4vBlock(Common::BitStream32BEMSB *ss, byte *cur
 		// Halfpel motion compensation with rounding (a + b + 1) >> 1.
 		// 4 motion compensation functions for the 4 halfpel positions
 		// for 8x8 blocks
-		switch(((mvy & 1) << 1) + (mvx & 1)) {
-		case 0:
-			putPixels8C(dst, src, pitch, 8);
-			break;
-		case 1:
-			putPixels8X2C(dst, src, pitch, 8);
-			break;
-		case 2:
-			putPixels8Y2C(dst, src, pitch, 8);
-			break;
-		case 3:
-			putPixels8XY2C(dst, src, pitch, 8);
-			break;
-		default:
-			break;
-		}
+		getMCKernels().put8[((mvy & 1) << 1) + (mvx & 1)](dst, src, pitch, 8);
 
 		// select next block
 		if (i & 1)
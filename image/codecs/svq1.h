@@ -47,6 +47,28 @@ public:
 	Graphics::PixelFormat getPixelFormat() const override { return _pixelFormat; }
 	bool setOutputPixelFormat(const Graphics::PixelFormat &format) override { _pixelFormat = format; return true; }
 
+	typedef void (*PutPixelsFunc)(byte *block, const byte *pixels, int lineSize, int h);
+
+	/**
+	 * Halfpel motion compensation kernels, indexed by the halfpel position
+	 * (bit 0 set for horizontal interpolation, bit 1 for vertical). The set
+	 * matching the CPU is selected on first use.
+	 */
+	struct MCKernels {
+		PutPixelsFunc put8[4];
+		PutPixelsFunc put16[4];
+	};
+
+	static const MCKernels mcKernelsGeneric;
+#ifdef SCUMMVM_SSE2
+	static const MCKernels mcKernelsSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	static const MCKernels mcKernelsNEON;
+#endif
+
+	static const MCKernels *mcKernels;
+
 private:
 	Graphics::PixelFormat _pixelFormat;
 	Graphics::Surface *_surface;
@@ -75,15 +97,17 @@ private:
 	bool svq1DecodeDeltaBlock(Common::BitStream32BEMSB *ss, byte *current, byte *previous, int pitch,
 			Common::Point *motion, int x, int y);
 
-	void putPixels8C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels8L2(byte *dst, const byte *src1, const byte *src2, int dstStride, int srcStride1, int srcStride2, int h);
-	void putPixels8X2C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels8Y2C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels8XY2C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels16C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels16X2C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels16Y2C(byte *block, const byte *pixels, int lineSize, int h);
-	void putPixels16XY2C(byte *block, const byte *pixels, int lineSize, int h);
+	static void putPixels8C(byte *block, const byte *pixels, int lineSize, int h);
+	static void putPixels8L2(byte *dst, const byte *src1, const byte *src2, int dstStride, int srcStride1, int srcStride2, int h);
+	static void putPixels8X2C(byte *block, const byte *pixels, int lineSize, int h);
+	static void putPixels8Y2C(byte *block, const byte *pixels, int lineSize, int h);
+	static void putPixels8XY2C(byte *block, const byte *pixels, int lineSize, int h);
+	static void putPixels16C(byte *block, const byte *pixels, int lineSize, int h);
+	static void putPixels16X2C(byte *block, const byte *pixels, int lineSize, int h);
+	static void putPixels16Y2C(byte *block, const byte *pixels, int lineSize, int h);
+	static void putPixels16XY2C(byte *block, const byte *pixels, int lineSize, int h);
+
+	static const MCKernels &getMCKernels();
 };
 
 } // End of namespace Image
@@ -0,0 +1,108 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "image/codecs/svq1.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Image {
+
+template<int width>
+static inline uint8x16_t loadPixels(const byte *src) {
+	return width == 16 ? vld1q_u8(src) : vcombine_u8(vld1_u8(src), vdup_n_u8(0));
+}
+
+template<int width>
+static inline void storePixels(byte *dst, uint8x16_t pixels) {
+	if (width == 16)
+		vst1q_u8(dst, pixels);
+	else
+		vst1_u8(dst, vget_low_u8(pixels));
+}
+
+template<int width>
+static void putPixelsNEON(byte *block, const byte *pixels, int lineSize, int h) {
+	for (int i = 0; i < h; i++, block += lineSize, pixels += lineSize)
+		storePixels<width>(block, loadPixels<width>(pixels));
+}
+
+// vrhadd rounds up, like the scalar (a + b + 1) >> 1
+template<int width>
+static void putPixelsX2NEON(byte *block, const byte *pixels, int lineSize, int h) {
+	for (int i = 0; i < h; i++, block += lineSize, pixels += lineSize)
+		storePixels<width>(block, vrhaddq_u8(loadPixels<width>(pixels), loadPixels<width>(pixels + 1)));
+}
+
+template<int width>
+static void putPixelsY2NEON(byte *block, const byte *pixels, int lineSize, int h) {
+	for (int i = 0; i < h; i++, block += lineSize, pixels += lineSize)
+		storePixels<width>(block, vrhaddq_u8(loadPixels<width>(pixels), loadPixels<width>(pixels + lineSize)));
+}
+
+// (a + b + c + d + 2) >> 2, with the horizontal sums of each line computed once
+template<int width>
+static void putPixelsXY2NEON(byte *block, const byte *pixels, int lineSize, int h) {
+	uint8x16_t a = loadPixels<width>(pixels);
+	uint8x16_t b = loadPixels<width>(pixels + 1);
+	uint16x8_t sumLo0 = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+	uint16x8_t sumHi0 = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+
+	for (int i = 0; i < h; i++, block += lineSize) {
+		pixels += lineSize;
+		a = loadPixels<width>(pixels);
+		b = loadPixels<width>(pixels + 1);
+		uint16x8_t sumLo1 = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+		uint16x8_t sumHi1 = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+
+		uint8x8_t lo = vrshrn_n_u16(vaddq_u16(sumLo0, sumLo1), 2);
+		uint8x8_t hi = vrshrn_n_u16(vaddq_u16(sumHi0, sumHi1), 2);
+		storePixels<width>(block, vcombine_u8(lo, hi));
+
+		sumLo0 = sumLo1;
+		sumHi0 = sumHi1;
+	}
+}
+
+const SVQ1Decoder::MCKernels SVQ1Decoder::mcKernelsNEON = {
+	{ putPixelsNEON<8>, putPixelsX2NEON<8>, putPixelsY2NEON<8>, putPixelsXY2NEON<8> },
+	{ putPixelsNEON<16>, putPixelsX2NEON<16>, putPixelsY2NEON<16>, putPixelsXY2NEON<16> }
+};
+
+} // End of namespace Image
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "image/codecs/svq1.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Image {
+
+template<int width>
+static inline __m128i loadPixels(const byte *src) {
+	return width == 16 ? _mm_loadu_si128((const __m128i *)src) : _mm_loadl_epi64((const __m128i *)src);
+}
+
+template<int width>
+static inline void storePixels(byte *dst, __m128i pixels) {
+	if (width == 16)
+		_mm_storeu_si128((__m128i *)dst, pixels);
+	else
+		_mm_storel_epi64((__m128i *)dst, pixels);
+}
+
+template<int width>
+static void putPixelsSSE2(byte *block, const byte *pixels, int lineSize, int h) {
+	for (int i = 0; i < h; i++, block += lineSize, pixels += lineSize)
+		storePixels<width>(block, loadPixels<width>(pixels));
+}
+
+// pavgb rounds up, like the scalar (a + b + 1) >> 1
+template<int width>
+static void putPixelsX2SSE2(byte *block, const byte *pixels, int lineSize, int h) {
+	for (int i = 0; i < h; i++, block += lineSize, pixels += lineSize)
+		storePixels<width>(block, _mm_avg_epu8(loadPixels<width>(pixels), loadPixels<width>(pixels + 1)));
+}
+
+template<int width>
+static void putPixelsY2SSE2(byte *block, const byte *pixels, int lineSize, int h) {
+	for (int i = 0; i < h; i++, block += lineSize, pixels += lineSize)
+		storePixels<width>(block, _mm_avg_epu8(loadPixels<width>(pixels), loadPixels<width>(pixels + lineSize)));
+}
+
+// (a + b + c + d + 2) >> 2, with the horizontal sums of each line computed once
+template<int width>
+static void putPixelsXY2SSE2(byte *block, const byte *pixels, int lineSize, int h) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16(2);
+
+	__m128i a = loadPixels<width>(pixels);
+	__m128i b = loadPixels<width>(pixels + 1);
+	__m128i sumLo0 = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+	__m128i sumHi0 = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+	for (int i = 0; i < h; i++, block += lineSize) {
+		pixels += lineSize;
+		a = loadPixels<width>(pixels);
+		b = loadPixels<width>(pixels + 1);
+		__m128i sumLo1 = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+		__m128i sumHi1 = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+		__m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(sumLo0, sumLo1), two), 2);
+		__m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(sumHi0, sumHi1), two), 2);
+		storePixels<width>(block, _mm_packus_epi16(lo, hi));
+
+		sumLo0 = sumLo1;
+		sumHi0 = sumHi1;
+	}
+}
+
+const SVQ1Decoder::MCKernels SVQ1Decoder::mcKernelsSSE2 = {
+	{ putPixelsSSE2<8>, putPixelsX2SSE2<8>, putPixelsY2SSE2<8>, putPixelsXY2SSE2<8> },
+	{ putPixelsSSE2<16>, putPixelsX2SSE2<16>, putPixelsY2SSE2<16>, putPixelsXY2SSE2<16> }
+};
+
+} // End of namespace Image
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
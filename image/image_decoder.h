@@ -113,6 +113,21 @@ public:
 	virtual bool hasTransparentColor() const { return false; }
 	/** Return the transparent color. */
 	virtual uint32 getTransparentColor() const { return 0; }
+
+	/**
+	 * Hint that the image is only needed at about the given size.
+	 *
+	 * Decoders which can cheaply produce a smaller image (for example by
+	 * JPEG DCT scaling or by dropping PNG rows and columns) may then decode
+	 * to a reduced size that is still at least as large as the hint in both
+	 * dimensions. The resulting surface is not scaled to the exact size, so
+	 * callers still need to scale it themselves. Decoders which cannot do
+	 * this ignore the hint.
+	 *
+	 * Must be called before loadStream(). Passing 0 for either dimension
+	 * requests the full size, which is the default.
+	 */
+	virtual void setScaleHint(uint16 width, uint16 height) {}
 };
 /** @} */
 } // End of namespace Image
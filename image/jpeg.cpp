@@ -47,7 +47,9 @@ namespace Image {
 JPEGDecoder::JPEGDecoder() :
 		_surface(),
 		_colorSpace(kColorSpaceRGB),
-		_requestedPixelFormat(getByteOrderRgbPixelFormat()) {
+		_requestedPixelFormat(getByteOrderRgbPixelFormat()),
+		_scaleHintWidth(0),
+		_scaleHintHeight(0) {
 }
 
 JPEGDecoder::~JPEGDecoder() {
@@ -279,6 +281,17 @@ bool JPEGDecoder::loadStream(Common::SeekableReadStream &stream) {
 		cinfo.out_color_space = JCS_CMYK;
 	}
 
+	// Let libjpeg scale down in the DCT when only a smaller image is
+	// wanted. This is much cheaper than decoding the full image.
+	if (_scaleHintWidth != 0 && _scaleHintHeight != 0) {
+		uint scaleDenom = 1;
+		while (scaleDenom < 8 && cinfo.image_width / (scaleDenom * 2) >= _scaleHintWidth && cinfo.image_height / (scaleDenom * 2) >= _scaleHintHeight)
+			scaleDenom *= 2;
+
+		cinfo.scale_num = 1;
+		cinfo.scale_denom = scaleDenom;
+	}
+
 	// Actually start decompressing the image
 	jpeg_start_decompress(&cinfo);
 
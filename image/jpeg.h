@@ -55,6 +55,7 @@ public:
 	void destroy() override;
 	bool loadStream(Common::SeekableReadStream &str) override;
 	const Graphics::Surface *getSurface() const override;
+	void setScaleHint(uint16 width, uint16 height) override { _scaleHintWidth = width; _scaleHintHeight = height; }
 
 	// Codec API
 	const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream) override;
@@ -100,6 +101,7 @@ private:
 	Graphics::Surface _surface;
 	ColorSpace _colorSpace;
 	Graphics::PixelFormat _requestedPixelFormat;
+	uint16 _scaleHintWidth, _scaleHintHeight;
 
 	Graphics::PixelFormat getByteOrderRgbPixelFormat() const;
 };
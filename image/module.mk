@@ -45,5 +45,16 @@ MODULE_OBJS += \
 	codecs/mpeg.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	codecs/svq1_neon.o \
+	codecs/indeo/indeo_dsp_neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	codecs/svq1_sse2.o \
+	codecs/indeo/indeo_dsp_sse2.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
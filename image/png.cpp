@@ -46,7 +46,9 @@ PNGDecoder::PNGDecoder() :
 		_skipSignature(false),
 		_keepTransparencyPaletted(false),
 		_hasTransparentColor(false),
-		_transparentColor(0) {
+		_transparentColor(0),
+		_scaleHintWidth(0),
+		_scaleHintHeight(0) {
 }
 
 PNGDecoder::~PNGDecoder() {
@@ -160,6 +162,18 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	width = w;
 	height = h;
 
+	// When only a smaller image is wanted, keep every scale-th row and column.
+	// This needs the rows to arrive in order, so interlaced images are always
+	// decoded at full size.
+	int scale = 1;
+	if (interlaceType == PNG_INTERLACE_NONE && _scaleHintWidth != 0 && _scaleHintHeight != 0) {
+		while (scale < 8 && width / (scale * 2) >= _scaleHintWidth && height / (scale * 2) >= _scaleHintHeight)
+			scale *= 2;
+	}
+
+	const int outputWidth = (width + scale - 1) / scale;
+	const int outputHeight = (height + scale - 1) / scale;
+
 	// Allocate memory for the final image data.
 	// To keep memory framentation low this happens before allocating memory for temporary image data.
 	_outputSurface = new Graphics::Surface();
@@ -202,7 +216,7 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 			}
 		}
 
-		_outputSurface->create(width, height,
+		_outputSurface->create(outputWidth, outputHeight,
 			hasRgbaPalette ? getByteOrderRgbaPixelFormat(true) : Graphics::PixelFormat::createFormatCLUT8());
 		png_set_packing(pngPtr);
 
@@ -227,7 +241,7 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 			png_set_expand(pngPtr);
 		}
 
-		_outputSurface->create(width, height, getByteOrderRgbaPixelFormat(isAlpha));
+		_outputSurface->create(outputWidth, outputHeight, getByteOrderRgbaPixelFormat(isAlpha));
 		if (!_outputSurface->getPixels()) {
 			error("Could not allocate memory for output image.");
 		}
@@ -258,18 +272,43 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 
 		for (int yp = 0; yp < height; ++yp) {
 			png_read_row(pngPtr, rowPtr, nullptr);
-			uint32 *destRowP = (uint32 *)_outputSurface->getBasePtr(0, yp);
+			if (yp % scale != 0)
+				continue;
+
+			uint32 *destRowP = (uint32 *)_outputSurface->getBasePtr(0, yp / scale);
 
-			for (int xp = 0; xp < width; ++xp)
-				destRowP[xp] = rgbaPalette[rowPtr[xp]];
+			for (int xp = 0; xp < outputWidth; ++xp)
+				destRowP[xp] = rgbaPalette[rowPtr[xp * scale]];
 		}
 
 		delete[] rowPtr;
-	} else  if (interlaceType == PNG_INTERLACE_NONE) {
+	} else if (interlaceType == PNG_INTERLACE_NONE && scale == 1) {
 		// PNGs without interlacing can simply be read row by row.
 		for (int i = 0; i < height; i++) {
 			png_read_row(pngPtr, (png_bytep)_outputSurface->getBasePtr(0, i), NULL);
 		}
+	} else if (interlaceType == PNG_INTERLACE_NONE) {
+		// Decimated PNGs are read row by row into a scratch buffer, from
+		// which every scale-th pixel of every scale-th row is kept.
+		const uint bpp = _outputSurface->format.bytesPerPixel;
+		png_bytep rowPtr = new byte[png_get_rowbytes(pngPtr, infoPtr)];
+
+		for (int yp = 0; yp < height; ++yp) {
+			png_read_row(pngPtr, rowPtr, nullptr);
+			if (yp % scale != 0)
+				continue;
+
+			byte *dst = (byte *)_outputSurface->getBasePtr(0, yp / scale);
+			const byte *src = rowPtr;
+
+			for (int xp = 0; xp < outputWidth; ++xp) {
+				memcpy(dst, src, bpp);
+				dst += bpp;
+				src += bpp * scale;
+			}
+		}
+
+		delete[] rowPtr;
 	} else {
 		// PNGs with interlacing require us to allocate an auxiliary
 		// buffer with pointers to all row starts.
@@ -67,6 +67,7 @@ public:
 	uint32 getTransparentColor() const override { return _transparentColor; }
 	void setSkipSignature(bool skip) { _skipSignature = skip; }
 	void setKeepTransparencyPaletted(bool keep) { _keepTransparencyPaletted = keep; }
+	void setScaleHint(uint16 width, uint16 height) override { _scaleHintWidth = width; _scaleHintHeight = height; }
 private:
 	Graphics::PixelFormat getByteOrderRgbaPixelFormat(bool isAlpha) const;
 
@@ -81,6 +82,9 @@ private:
 	bool _hasTransparentColor;
 	uint32 _transparentColor;
 
+	// Requested minimum size for decimated decoding, 0 for the full size
+	uint16 _scaleHintWidth, _scaleHintHeight;
+
 	Graphics::Surface *_outputSurface;
 };
 
@@ -0,0 +1,388 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/adpcm.h"
+#include "audio/decoders/adpcm_intern.h"
+#include "common/debug.h"
+#include "common/memstream.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+// The per-sample decoders which were used before the block-based ones,
+// to check that the output is still the same and to compare the speed.
+namespace OldADPCM {
+
+class Oki_ADPCMStream : public Audio::Oki_ADPCMStream {
+public:
+	Oki_ADPCMStream(Common::SeekableReadStream *stream, uint32 size, int rate, int channels, uint32 blockAlign)
+		: Audio::Oki_ADPCMStream(stream, DisposeAfterUse::YES, size, rate, channels, blockAlign) { _decodedSampleCount = 0; }
+
+	bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		int samples;
+		byte data;
+
+		for (samples = 0; samples < numSamples && !endOfData(); samples++) {
+			if (_decodedSampleCount == 0) {
+				data = _stream->readByte();
+				_decodedSamples[0] = decodeOKI((data >> 4) & 0x0f);
+				_decodedSamples[1] = decodeOKI((data >> 0) & 0x0f);
+				_decodedSampleCount = 2;
+			}
+
+			buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
+			_decodedSampleCount--;
+		}
+
+		return samples;
+	}
+
+private:
+	uint8 _decodedSampleCount;
+	int16 _decodedSamples[2];
+};
+
+class DVI_ADPCMStream : public Audio::Ima_ADPCMStream {
+public:
+	DVI_ADPCMStream(Common::SeekableReadStream *stream, uint32 size, int rate, int channels, uint32 blockAlign)
+		: Audio::Ima_ADPCMStream(stream, DisposeAfterUse::YES, size, rate, channels, blockAlign) { _decodedSampleCount = 0; }
+
+	bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		int samples;
+		byte data;
+
+		for (samples = 0; samples < numSamples && !endOfData(); samples++) {
+			if (_decodedSampleCount == 0) {
+				data = _stream->readByte();
+				_decodedSamples[0] = decodeIMA((data >> 4) & 0x0f, 0);
+				_decodedSamples[1] = decodeIMA((data >> 0) & 0x0f, _channels == 2 ? 1 : 0);
+				_decodedSampleCount = 2;
+			}
+
+			buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
+			_decodedSampleCount--;
+		}
+
+		return samples;
+	}
+
+private:
+	uint8 _decodedSampleCount;
+	int16 _decodedSamples[2];
+};
+
+class MSIma_ADPCMStream : public Audio::Ima_ADPCMStream {
+public:
+	MSIma_ADPCMStream(Common::SeekableReadStream *stream, uint32 size, int rate, int channels, uint32 blockAlign)
+		: Audio::Ima_ADPCMStream(stream, DisposeAfterUse::YES, size, rate, channels, blockAlign) {
+		_samplesLeft[0] = 0;
+		_samplesLeft[1] = 0;
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		int samples = 0;
+
+		while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
+			if (_blockPos[0] == _blockAlign) {
+				for (int i = 0; i < _channels; i++) {
+					_status.ima_ch[i].last = _stream->readSint16LE();
+					_status.ima_ch[i].stepIndex = _stream->readSint16LE();
+				}
+
+				_blockPos[0] = _channels * 4;
+			}
+
+			for (int i = 0; i < _channels; i++) {
+				for (int j = 0; j < 4; j++) {
+					byte data = _stream->readByte();
+					_blockPos[0]++;
+					_buffer[i][j * 2] = decodeIMA(data & 0x0f, i);
+					_buffer[i][j * 2 + 1] = decodeIMA((data >> 4) & 0x0f, i);
+					_samplesLeft[i] += 2;
+				}
+			}
+
+			while (samples < numSamples && _samplesLeft[0] != 0) {
+				for (int i = 0; i < _channels; i++) {
+					buffer[samples + i] = _buffer[i][8 - _samplesLeft[i]];
+					_samplesLeft[i]--;
+				}
+
+				samples += _channels;
+			}
+		}
+
+		return samples;
+	}
+
+private:
+	int16 _buffer[2][8];
+	int _samplesLeft[2];
+};
+
+class MS_ADPCMStream : public Audio::MS_ADPCMStream {
+public:
+	MS_ADPCMStream(Common::SeekableReadStream *stream, uint32 size, int rate, int channels, uint32 blockAlign)
+		: Audio::MS_ADPCMStream(stream, DisposeAfterUse::YES, size, rate, channels, blockAlign) {
+		_decodedSampleCount = 0;
+		_decodedSampleIndex = 0;
+	}
+
+	bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		static const int adaptCoeff1[] = { 256, 512, 0, 192, 240, 460, 392 };
+		static const int adaptCoeff2[] = { 0, -256, 0, 64, 0, -208, -232 };
+		int samples;
+		byte data;
+		int i;
+
+		for (samples = 0; samples < numSamples && !endOfData(); samples++) {
+			if (_decodedSampleCount == 0) {
+				if (_blockPos[0] == _blockAlign) {
+					for (i = 0; i < _channels; i++) {
+						_status.ch[i].predictor = CLIP(_stream->readByte(), (byte)0, (byte)6);
+						_status.ch[i].coeff1 = adaptCoeff1[_status.ch[i].predictor];
+						_status.ch[i].coeff2 = adaptCoeff2[_status.ch[i].predictor];
+					}
+
+					for (i = 0; i < _channels; i++)
+						_status.ch[i].delta = _stream->readSint16LE();
+
+					for (i = 0; i < _channels; i++)
+						_status.ch[i].sample1 = _stream->readSint16LE();
+
+					for (i = 0; i < _channels; i++)
+						_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample2 = _stream->readSint16LE();
+
+					for (i = 0; i < _channels; i++)
+						_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample1;
+
+					_blockPos[0] = _channels * 7;
+				} else {
+					data = _stream->readByte();
+					_blockPos[0]++;
+					_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[0], (data >> 4) & 0x0f);
+					_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[_channels - 1], data & 0x0f);
+				}
+				_decodedSampleIndex = 0;
+			}
+
+			buffer[samples] = _decodedSamples[_decodedSampleIndex++];
+			_decodedSampleCount--;
+		}
+
+		return samples;
+	}
+
+private:
+	uint8 _decodedSampleCount;
+	uint8 _decodedSampleIndex;
+	int16 _decodedSamples[4];
+};
+
+class Apple_ADPCMStream : public Audio::Ima_ADPCMStream {
+public:
+	Apple_ADPCMStream(Common::SeekableReadStream *stream, uint32 size, int rate, int channels, uint32 blockAlign)
+		: Audio::Ima_ADPCMStream(stream, DisposeAfterUse::YES, size, rate, channels, blockAlign) {
+		_chunkPos[0] = 0;
+		_chunkPos[1] = 0;
+		_streamPos[0] = 0;
+		_streamPos[1] = _blockAlign;
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		int samples[2] = { 0, 0};
+		int chanSamples = numSamples / _channels;
+
+		for (int i = 0; i < _channels; i++) {
+			_stream->seek(_streamPos[i]);
+
+			while ((samples[i] < chanSamples) &&
+			       !((_stream->eos() || (_stream->pos() >= _endpos)) && (_chunkPos[i] == 0))) {
+
+				if (_blockPos[i] == _blockAlign) {
+					uint16 temp = _stream->readUint16BE();
+					_status.ima_ch[i].last      = (int16) (temp & 0xFF80);
+					_status.ima_ch[i].stepIndex =          temp & 0x007F;
+					_status.ima_ch[i].stepIndex = CLIP<int32>(_status.ima_ch[i].stepIndex, 0, 88);
+					_blockPos[i] = 2;
+				}
+
+				if (_chunkPos[i] == 0) {
+					byte data = _stream->readByte();
+					_buffer[i][0] = decodeIMA(data &  0x0F, i);
+					_buffer[i][1] = decodeIMA(data >>    4, i);
+				}
+
+				buffer[_channels * samples[i] + i] = _buffer[i][_chunkPos[i]];
+
+				if (++_chunkPos[i] > 1) {
+					_chunkPos[i] = 0;
+					_blockPos[i]++;
+				}
+
+				samples[i]++;
+
+				if (_channels == 2)
+					if (_blockPos[i] == _blockAlign)
+						_stream->skip(MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
+
+				_streamPos[i] = _stream->pos();
+			}
+		}
+
+		return samples[0] + samples[1];
+	}
+
+private:
+	int32 _streamPos[2];
+	int16 _buffer[2][2];
+	uint8 _chunkPos[2];
+};
+
+} // End of namespace OldADPCM
+
+class ADPCMTestSuite : public CxxTest::TestSuite {
+	enum {
+		kBlockAlign = 1024,
+		kBlockCount = 64
+	};
+
+	uint32 _seed;
+
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) & 0xFF;
+	}
+
+	// Random ADPCM data with valid block headers
+	byte *createData(Audio::ADPCMType type, int channels, uint32 &size) {
+		size = kBlockAlign * kBlockCount;
+		byte *data = (byte *)malloc(size);
+		for (uint32 i = 0; i < size; i++)
+			data[i] = nextRandom();
+
+		for (uint32 block = 0; block < size; block += kBlockAlign) {
+			byte *header = data + block;
+			if (type == Audio::kADPCMMSIma) {
+				for (int i = 0; i < channels; i++)
+					WRITE_LE_UINT16(header + i * 4 + 2, nextRandom() % 89);
+			} else if (type == Audio::kADPCMMS) {
+				for (int i = 0; i < channels; i++)
+					header[i] %= 7;
+			}
+		}
+
+		return data;
+	}
+
+	Audio::AudioStream *createOldStream(Audio::ADPCMType type, Common::SeekableReadStream *stream, int channels) {
+		switch (type) {
+		case Audio::kADPCMOki:
+			return new OldADPCM::Oki_ADPCMStream(stream, stream->size(), 22050, channels, kBlockAlign);
+		case Audio::kADPCMDVI:
+			return new OldADPCM::DVI_ADPCMStream(stream, stream->size(), 22050, channels, kBlockAlign);
+		case Audio::kADPCMMSIma:
+			return new OldADPCM::MSIma_ADPCMStream(stream, stream->size(), 22050, channels, kBlockAlign);
+		case Audio::kADPCMMS:
+			return new OldADPCM::MS_ADPCMStream(stream, stream->size(), 22050, channels, kBlockAlign);
+		case Audio::kADPCMApple:
+		default:
+			return new OldADPCM::Apple_ADPCMStream(stream, stream->size(), 22050, channels, kBlockAlign);
+		}
+	}
+
+	static int decodeAll(Audio::AudioStream *stream, int16 *buffer, int size, int chunk, uint32 &time) {
+		const uint32 start = BENCHMARK_TIME ? g_system->getMillis() : 0;
+		int samples = 0;
+		while (!stream->endOfData() && samples < size) {
+			const int decoded = stream->readBuffer(buffer + samples, MIN(chunk, size - samples));
+			if (decoded <= 0)
+				break;
+			samples += decoded;
+		}
+		if (BENCHMARK_TIME)
+			time += g_system->getMillis() - start;
+		return samples;
+	}
+
+	void compareDecoders(Audio::ADPCMType type, int channels, const char *name) {
+#if BENCHMARK_TIME
+		if (!g_system)
+			Common::install_null_g_system();
+#endif
+
+#ifdef SLOW_TESTS
+		const int iters = 100;
+#else
+		const int iters = 1;
+#endif
+
+		uint32 size;
+		byte *data = createData(type, channels, size);
+
+		const int maxSamples = size * 2;
+		int16 *oldBuffer = new int16[maxSamples];
+		int16 *newBuffer = new int16[maxSamples];
+		uint32 oldTime = 0, newTime = 0;
+
+		for (int i = 0; i < iters; i++) {
+			Audio::AudioStream *oldStream = createOldStream(type, new Common::MemoryReadStream(data, size), channels);
+			const int oldSamples = decodeAll(oldStream, oldBuffer, maxSamples, 2048, oldTime);
+			delete oldStream;
+
+			// Odd request sizes, to check the samples left over from blocks
+			Audio::AudioStream *newStream = Audio::makeADPCMStream(new Common::MemoryReadStream(data, size), DisposeAfterUse::YES, size, type, 22050, channels, kBlockAlign);
+			const int newSamples = decodeAll(newStream, newBuffer, maxSamples, 1002, newTime);
+			delete newStream;
+
+			TS_ASSERT_EQUALS(oldSamples, newSamples);
+			TS_ASSERT(memcmp(oldBuffer, newBuffer, MIN(oldSamples, newSamples) * sizeof(int16)) == 0);
+		}
+
+#if BENCHMARK_TIME
+		debug("%s ADPCM (%d channels): per-sample decoder %u ms, block decoder %u ms for %d iters", name, channels, oldTime, newTime, iters);
+#endif
+
+		delete[] oldBuffer;
+		delete[] newBuffer;
+		free(data);
+	}
+
+public:
+	ADPCMTestSuite() : _seed(1) {}
+
+	void test_oki() {
+		compareDecoders(Audio::kADPCMOki, 1, "Oki");
+	}
+
+	void test_dvi() {
+		compareDecoders(Audio::kADPCMDVI, 1, "DVI");
+		compareDecoders(Audio::kADPCMDVI, 2, "DVI");
+	}
+
+	void test_ms_ima() {
+		compareDecoders(Audio::kADPCMMSIma, 1, "MS IMA");
+		compareDecoders(Audio::kADPCMMSIma, 2, "MS IMA");
+	}
+
+	void test_ms() {
+		compareDecoders(Audio::kADPCMMS, 1, "MS");
+		compareDecoders(Audio::kADPCMMS, 2, "MS");
+	}
+
+	void test_apple() {
+		compareDecoders(Audio::kADPCMApple, 1, "Apple");
+		compareDecoders(Audio::kADPCMApple, 2, "Apple");
+	}
+};
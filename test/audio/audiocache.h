@@ -0,0 +1,97 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiocache.h"
+#include "audio/audiostream.h"
+#include "common/system.h"
+
+#include "helper.h"
+#include "../null_osystem.h"
+
+class AudioCacheTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_shared_streams() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		const int sampleRate = 11025;
+
+		int16 *sine = 0;
+		Audio::AudioCache cache(1024 * 1024);
+		Audio::SeekableAudioStream *first = cache.addStream("sine", createSineStream<int16>(sampleRate, 1, &sine, false, true));
+
+		TS_ASSERT(first != 0);
+		TS_ASSERT(cache.contains("sine"));
+		TS_ASSERT_EQUALS(cache.getSize(), (uint32)(sampleRate * 2 * sizeof(int16)));
+
+		Audio::SeekableAudioStream *second = cache.getStream("sine");
+		TS_ASSERT(second != 0);
+		TS_ASSERT_EQUALS(second->isStereo(), true);
+		TS_ASSERT_EQUALS(second->getRate(), sampleRate);
+		TS_ASSERT_EQUALS(second->getLength().msecs(), 1000);
+
+		int16 *buffer = new int16[sampleRate * 2];
+
+		TS_ASSERT_EQUALS(first->readBuffer(buffer, sampleRate * 2), sampleRate * 2);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, sampleRate * 2 * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(first->endOfData(), true);
+
+		// The streams have their own positions
+		const int halfway = Audio::convertTimeToStreamPos(Audio::Timestamp(500, 1000), sampleRate, true).totalNumberOfFrames();
+		TS_ASSERT_EQUALS(second->seek(Audio::Timestamp(500, 1000)), true);
+		TS_ASSERT_EQUALS(second->readBuffer(buffer, 100), 100);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine + halfway, 100 * sizeof(int16)), 0);
+
+		// Dropped sounds stay playable while streams use them
+		cache.clear();
+		TS_ASSERT_EQUALS(cache.getSize(), (uint32)0);
+		TS_ASSERT_EQUALS(cache.getStream("sine"), (Audio::SeekableAudioStream *)0);
+		TS_ASSERT_EQUALS(first->rewind(), true);
+		TS_ASSERT_EQUALS(first->readBuffer(buffer, 100), 100);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, 100 * sizeof(int16)), 0);
+
+		delete first;
+		delete second;
+		delete[] buffer;
+		delete[] sine;
+#endif
+	}
+
+	void test_eviction() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		// Room for two one second mono sounds
+		const int sampleRate = 8000;
+		const uint32 soundSize = sampleRate * sizeof(int16);
+		Audio::AudioCache cache(soundSize * 2);
+
+		delete cache.addStream("a", createSineStream<int16>(sampleRate, 1, 0, false, false));
+		delete cache.addStream("b", createSineStream<int16>(sampleRate, 1, 0, false, false));
+		TS_ASSERT_EQUALS(cache.getSize(), soundSize * 2);
+
+		// Using "a" makes "b" the least recently used one
+		delete cache.getStream("a");
+		delete cache.addStream("c", createSineStream<int16>(sampleRate, 1, 0, false, false));
+
+		TS_ASSERT(cache.contains("a"));
+		TS_ASSERT(!cache.contains("b"));
+		TS_ASSERT(cache.contains("c"));
+		TS_ASSERT_EQUALS(cache.getSize(), soundSize * 2);
+
+		// Sounds larger than the cache are played but not stored
+		Audio::SeekableAudioStream *large = cache.addStream("large", createSineStream<int16>(sampleRate, 3, 0, false, false));
+		TS_ASSERT(large != 0);
+		TS_ASSERT(!cache.contains("large"));
+		TS_ASSERT(cache.contains("a"));
+		delete large;
+
+		cache.setMaxSize(soundSize);
+		TS_ASSERT_EQUALS(cache.getSize(), soundSize);
+		TS_ASSERT(!cache.contains("a"));
+		TS_ASSERT(cache.contains("c"));
+#endif
+	}
+};
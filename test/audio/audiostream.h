@@ -1,8 +1,10 @@
 #include <cxxtest/TestSuite.h>
 
 #include "audio/audiostream.h"
+#include "common/system.h"
 
 #include "helper.h"
+#include "../null_osystem.h"
 
 class AudioStreamTestSuite : public CxxTest::TestSuite
 {
@@ -205,4 +207,91 @@ public:
 	void test_sub_looping_audio_stream_stereo_22050_end_fixed_iter() {
 		testSubLoopingAudioStreamFixedIter(22050, true, 2, 2);
 	}
+
+	void test_prefetching_audio_stream() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		const int sampleRate = 11025;
+		const int secondLength = sampleRate * 2;
+
+		int16 *sine = 0;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(sampleRate, 2, &sine, false, true);
+		Audio::PrefetchingAudioStream *prefetch = Audio::makePrefetchingAudioStream(s, DisposeAfterUse::YES, 100);
+
+		int16 *buffer = new int16[secondLength * 2];
+
+		TS_ASSERT_EQUALS(prefetch->isStereo(), true);
+		TS_ASSERT_EQUALS(prefetch->getRate(), sampleRate);
+		TS_ASSERT_EQUALS(prefetch->getLength().msecs(), 2000);
+
+		// Read everything in odd sized chunks, past the prefetched part
+		int samplesRead = 0;
+		while (!prefetch->endOfData()) {
+			const int count = prefetch->readBuffer(buffer + samplesRead, MIN(1001, secondLength * 2 - samplesRead));
+			if (count <= 0)
+				break;
+			samplesRead += count;
+		}
+
+		TS_ASSERT_EQUALS(samplesRead, secondLength * 2);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, secondLength * 2 * sizeof(int16)), 0);
+
+		// There is no timer here, so the samples are decoded while reading
+		TS_ASSERT_EQUALS(prefetch->getUnderrunCount(), 0u);
+		TS_ASSERT_EQUALS(prefetch->getUnderrunSamples(), 0u);
+
+		// Seeking drops the prefetched samples
+		TS_ASSERT_EQUALS(prefetch->seek(Audio::Timestamp(1000, 1000)), true);
+		TS_ASSERT_EQUALS(prefetch->endOfData(), false);
+		TS_ASSERT_EQUALS(prefetch->readBuffer(buffer, 1000), 1000);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine + secondLength, 1000 * sizeof(int16)), 0);
+
+		TS_ASSERT_EQUALS(prefetch->rewind(), true);
+		TS_ASSERT_EQUALS(prefetch->readBuffer(buffer, 1000), 1000);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, 1000 * sizeof(int16)), 0);
+
+		delete[] buffer;
+		delete prefetch;
+		delete[] sine;
+#endif
+	}
+
+	void test_prefetching_looping_audio_stream() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		const int sampleRate = 11025;
+		const int secondLength = sampleRate * 2;
+
+		int16 *sine = 0;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(sampleRate, 1, &sine, false, true);
+		Audio::AudioStream *prefetch = Audio::makePrefetchingAudioStream(Audio::makeLoopingAudioStream(s, 3), DisposeAfterUse::YES, 100);
+
+		TS_ASSERT_EQUALS(prefetch->isStereo(), true);
+		TS_ASSERT_EQUALS(prefetch->getRate(), sampleRate);
+
+		int16 *buffer = new int16[secondLength * 3];
+
+		// The loops are joined without gaps
+		int samplesRead = 0;
+		while (!prefetch->endOfData() && samplesRead < secondLength * 3) {
+			const int count = prefetch->readBuffer(buffer + samplesRead, MIN(999, secondLength * 3 - samplesRead));
+			if (count <= 0)
+				break;
+			samplesRead += count;
+		}
+
+		TS_ASSERT_EQUALS(samplesRead, secondLength * 3);
+		for (int i = 0; i < 3; i++)
+			TS_ASSERT_EQUALS(memcmp(buffer + i * secondLength, sine, secondLength * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(prefetch->endOfData(), true);
+
+		delete[] buffer;
+		delete prefetch;
+		delete[] sine;
+#endif
+	}
 };
@@ -0,0 +1,189 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/midiparser_smf.h"
+
+class MidiParserTestSuite : public CxxTest::TestSuite
+{
+	class TestParser : public MidiParser_SMF {
+	public:
+		/** The events sent to the driver */
+		Common::Array<uint32> messages;
+
+		byte *getPlayPos() const { return _position._playPos; }
+		uint32 getPlayTime() const { return _position._playTime; }
+		uint getCheckpointCount() const { return _jumpCheckpoints.size(); }
+
+	protected:
+		using MidiParser_SMF::sendToDriver;
+		void sendToDriver(uint32 b) override { messages.push_back(b); }
+	};
+
+	enum {
+		kEventCount = 1000,
+		kEventDelta = 10
+	};
+
+	// A type 0 SMF changing the volume of channel 0 every few ticks
+	static byte *createSong(uint32 &size) {
+		const uint32 trackSize = kEventCount * 4 + 4;
+		size = 14 + 8 + trackSize;
+		byte *data = new byte[size];
+		byte *pos = data;
+
+		memcpy(pos, "MThd", 4);
+		WRITE_BE_UINT32(pos + 4, 6);
+		WRITE_BE_UINT16(pos + 8, 0);
+		WRITE_BE_UINT16(pos + 10, 1);
+		WRITE_BE_UINT16(pos + 12, 96);
+		pos += 14;
+
+		memcpy(pos, "MTrk", 4);
+		WRITE_BE_UINT32(pos + 4, trackSize);
+		pos += 8;
+
+		for (int i = 0; i < kEventCount; i++) {
+			*pos++ = kEventDelta;
+			*pos++ = 0xB0;
+			*pos++ = 7;
+			*pos++ = i & 0x7F;
+		}
+
+		*pos++ = 0;
+		*pos++ = 0xFF;
+		*pos++ = 0x2F;
+		*pos++ = 0;
+		return data;
+	}
+
+	// A type 0 SMF changing two controllers and the program of channel 0,
+	// and a controller of channel 1
+	static byte *createStateSong(uint32 &size) {
+		Common::Array<byte> track;
+		for (int i = 0; i < kEventCount; i++) {
+			track.push_back(kEventDelta);
+			switch (i % 4) {
+			case 0:
+				track.push_back(0xB0);
+				track.push_back(7);
+				track.push_back(i & 0x7F);
+				break;
+			case 1:
+				track.push_back(0xB0);
+				track.push_back(10);
+				track.push_back((i * 3) & 0x7F);
+				break;
+			case 2:
+				track.push_back(0xC0);
+				track.push_back((i * 5) & 0x7F);
+				break;
+			default:
+				track.push_back(0xB1);
+				track.push_back(7);
+				track.push_back((i * 7) & 0x7F);
+				break;
+			}
+		}
+		track.push_back(0);
+		track.push_back(0xFF);
+		track.push_back(0x2F);
+		track.push_back(0);
+
+		size = 14 + 8 + track.size();
+		byte *data = new byte[size];
+		memcpy(data, "MThd", 4);
+		WRITE_BE_UINT32(data + 4, 6);
+		WRITE_BE_UINT16(data + 8, 0);
+		WRITE_BE_UINT16(data + 10, 1);
+		WRITE_BE_UINT16(data + 12, 96);
+		memcpy(data + 14, "MTrk", 4);
+		WRITE_BE_UINT32(data + 18, track.size());
+		memcpy(data + 22, track.data(), track.size());
+		return data;
+	}
+
+	// The last value sent for a status byte and first parameter
+	static int lastValue(const Common::Array<uint32> &messages, uint count, uint32 key) {
+		int value = -1;
+		for (uint i = 0; i < count; i++) {
+			const uint32 mask = (key & 0xF0) == 0xC0 ? 0xFF : 0xFFFF;
+			if ((messages[i] & mask) == key)
+				value = mask == 0xFF ? (messages[i] >> 8) & 0xFF : (messages[i] >> 16) & 0xFF;
+		}
+		return value;
+	}
+
+public:
+	void test_jump_checkpoints() {
+		uint32 size;
+		byte *data = createSong(size);
+
+		TestParser reference;
+		TS_ASSERT(reference.loadMusic(data, size));
+		TS_ASSERT(reference.jumpToTick(3005, false, false));
+
+		TestParser parser;
+		TS_ASSERT(parser.loadMusic(data, size));
+		TS_ASSERT(parser.jumpToTick(8005, false, false));
+		TS_ASSERT_LESS_THAN(0u, parser.getCheckpointCount());
+
+		// The second jump continues from a checkpoint
+		TS_ASSERT(parser.jumpToTick(3005, false, false));
+		TS_ASSERT_EQUALS(parser.getTick(), reference.getTick());
+		TS_ASSERT_EQUALS(parser.getPlayPos(), reference.getPlayPos());
+		TS_ASSERT_EQUALS(parser.getPlayTime(), reference.getPlayTime());
+
+		parser.unloadMusic();
+		reference.unloadMusic();
+		delete[] data;
+	}
+
+	void test_jump_checkpoints_fire_events() {
+		uint32 size;
+		byte *data = createStateSong(size);
+
+		// Without checkpoints, all the events before the target are sent
+		TestParser reference;
+		TS_ASSERT(reference.loadMusic(data, size));
+		TS_ASSERT(reference.jumpToTick(3005, true));
+
+		TestParser parser;
+		TS_ASSERT(parser.loadMusic(data, size));
+		TS_ASSERT(parser.jumpToTick(8005, false));
+		TS_ASSERT_LESS_THAN(0u, parser.getCheckpointCount());
+
+		parser.messages.clear();
+		TS_ASSERT(parser.jumpToTick(3005, true));
+		TS_ASSERT_EQUALS(parser.getTick(), reference.getTick());
+		TS_ASSERT_EQUALS(parser.getPlayPos(), reference.getPlayPos());
+
+		// The state at the checkpoint comes first, by channel, with the
+		// controllers in ascending order before the program
+		const Common::Array<uint32> &messages = parser.messages;
+		const Common::Array<uint32> &referenceMessages = reference.messages;
+		TS_ASSERT_LESS_THAN(4u, messages.size());
+		TS_ASSERT_LESS_THAN(messages.size(), referenceMessages.size());
+		if (messages.size() < 4 || messages.size() > referenceMessages.size())
+			return;
+		TS_ASSERT_EQUALS(messages[0] & 0xFFFF, 0x07B0u);
+		TS_ASSERT_EQUALS(messages[1] & 0xFFFF, 0x0AB0u);
+		TS_ASSERT_EQUALS(messages[2] & 0xFF, 0xC0u);
+		TS_ASSERT_EQUALS(messages[3] & 0xFFFF, 0x07B1u);
+
+		// It's followed by the same events as without the checkpoint
+		const uint tailSize = messages.size() - 4;
+		const uint prefixSize = referenceMessages.size() - tailSize;
+		for (uint i = 0; i < tailSize; i++)
+			TS_ASSERT_EQUALS(messages[4 + i], referenceMessages[prefixSize + i]);
+
+		// The state has the values of the events it stands for
+		TS_ASSERT_EQUALS(lastValue(messages, 4, 0x07B0), lastValue(referenceMessages, prefixSize, 0x07B0));
+		TS_ASSERT_EQUALS(lastValue(messages, 4, 0x0AB0), lastValue(referenceMessages, prefixSize, 0x0AB0));
+		TS_ASSERT_EQUALS(lastValue(messages, 4, 0xC0), lastValue(referenceMessages, prefixSize, 0xC0));
+		TS_ASSERT_EQUALS(lastValue(messages, 4, 0x07B1), lastValue(referenceMessages, prefixSize, 0x07B1));
+		TS_ASSERT_LESS_THAN(-1, lastValue(messages, 4, 0xC0));
+
+		parser.unloadMusic();
+		reference.unloadMusic();
+		delete[] data;
+	}
+};
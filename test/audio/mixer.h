@@ -0,0 +1,118 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer_intern.h"
+#include "common/system.h"
+
+#include "helper.h"
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+	static void mixSines(int16 *buffer, uint frames, int count) {
+		Audio::MixerImpl mixer(44100, true);
+		mixer.setReady(true);
+		mixer.setSubmixing(true);
+
+		for (int i = 0; i < count; i++) {
+			Audio::SoundHandle handle;
+			mixer.playStream(Audio::Mixer::kPlainSoundType, &handle, createSineStream<int16>(22050, 1, 0, false, false), -1, 100, 0, DisposeAfterUse::YES, false, false);
+		}
+
+		mixer.mixCallback((byte *)buffer, frames * 2 * sizeof(int16));
+	}
+
+	enum {
+		kShortFrames = 1000 ///< Length of the channel which ends early, at 22050 Hz
+	};
+
+	// Mix channels with different volumes and balances, one of which ends
+	// early and one of which starts late
+	static void mixChannels(int16 *buffer, uint frames, uint chunkFrames, bool submixing, uint32 &elapsed, bool &shortActive) {
+		Audio::MixerImpl mixer(44100, true);
+		mixer.setReady(true);
+		mixer.setSubmixing(submixing);
+
+		static const byte volumes[] = { 60, 90, 40 };
+		static const int8 balances[] = { -127, 50, 0 };
+		Audio::SoundHandle handles[3];
+		for (int i = 0; i < 3; i++) {
+			Audio::AudioStream *stream = createSineStream<int16>(22050, 1, 0, false, i == 1);
+			if (i == 2)
+				stream = Audio::makeLimitingAudioStream(stream, Audio::Timestamp(0, kShortFrames, 22050));
+			mixer.playStream(Audio::Mixer::kPlainSoundType, &handles[i], stream, -1, volumes[i], balances[i], DisposeAfterUse::YES, false, false);
+		}
+
+		for (uint pos = 0; pos < frames; pos += chunkFrames) {
+			if (pos == 3 * chunkFrames) {
+				// Start at the peak of the sine, so that a late start is noticed
+				Audio::AudioStream *stream = new Audio::SubSeekableAudioStream(createSineStream<int16>(22050, 1, 0, false, false),
+					Audio::Timestamp(0, 5512, 22050), Audio::Timestamp(0, 22050, 22050));
+				Audio::SoundHandle handle;
+				mixer.playStream(Audio::Mixer::kPlainSoundType, &handle, stream, -1, 70, -30, DisposeAfterUse::YES, false, false);
+			}
+			mixer.mixCallback((byte *)(buffer + pos * 2), chunkFrames * 2 * sizeof(int16));
+		}
+
+		elapsed = mixer.getElapsedTime(handles[0]).msecs();
+		shortActive = mixer.isSoundHandleActive(handles[2]);
+	}
+
+public:
+	void test_submix_same_rate() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		const uint frames = 4096;
+		int16 *single = new int16[frames * 2];
+		int16 *both = new int16[frames * 2];
+
+		mixSines(single, frames, 1);
+		mixSines(both, frames, 2);
+
+		// Mixing two channels at the same rate has to result in their sum
+		for (uint i = 0; i < frames * 2; i++) {
+			TS_ASSERT_LESS_THAN_EQUALS(both[i], single[i] * 2 + 2);
+			TS_ASSERT_LESS_THAN_EQUALS(single[i] * 2 - 2, both[i]);
+		}
+
+		delete[] single;
+		delete[] both;
+#endif
+	}
+
+	void test_submix_matches_channels() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		const uint frames = 8192;
+		int16 *channels = new int16[frames * 2];
+		int16 *submixed = new int16[frames * 2];
+		uint32 channelsElapsed, submixedElapsed;
+		bool channelsShortActive, submixedShortActive;
+
+		mixChannels(channels, frames, 512, false, channelsElapsed, channelsShortActive);
+		mixChannels(submixed, frames, 512, true, submixedElapsed, submixedShortActive);
+
+		// Both ways only differ by rounding, except that the channel which
+		// ends early can play one more source sample when submixed
+		const uint endFrame = kShortFrames * 2;
+		for (uint i = 0; i < frames * 2; i++) {
+			if (i / 2 >= endFrame && i / 2 < endFrame + 2)
+				continue;
+			TS_ASSERT_LESS_THAN_EQUALS(channels[i], submixed[i] + 4);
+			TS_ASSERT_LESS_THAN_EQUALS(submixed[i], channels[i] + 4);
+		}
+
+		TS_ASSERT_LESS_THAN_EQUALS(channelsElapsed, submixedElapsed + 5);
+		TS_ASSERT_LESS_THAN_EQUALS(submixedElapsed, channelsElapsed + 5);
+		TS_ASSERT(!channelsShortActive);
+		TS_ASSERT(!submixedShortActive);
+
+		delete[] channels;
+		delete[] submixed;
+#endif
+	}
+};
@@ -0,0 +1,129 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mods/mod_xm_s3m.h"
+#include "common/crc.h"
+#include "common/debug.h"
+#include "common/memstream.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class ModsTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kSampleCount = 4,
+		kSampleLength = 2000,
+		kRate = 44100,
+		kRenderFrames = kRate * 4
+	};
+
+	// A 4 channel ProTracker module playing looped samples with different
+	// periods and volume slides, so that the voices hit their loop points
+	// at different times
+	static byte *createModule(uint32 &size) {
+		static const uint16 periods[] = { 856, 428, 381, 214, 170, 113, 320, 254 };
+
+		size = 20 + 31 * 30 + 2 + 128 + 4 + 64 * 4 * 4 + kSampleCount * kSampleLength;
+		byte *data = new byte[size];
+		memset(data, 0, size);
+		byte *pos = data;
+
+		memcpy(pos, "test", 4);
+		pos += 20;
+
+		for (int i = 0; i < 31; i++) {
+			if (i < kSampleCount) {
+				WRITE_BE_UINT16(pos + 22, kSampleLength / 2);
+				pos[25] = 64;
+				WRITE_BE_UINT16(pos + 26, 100 * (i + 1));
+				WRITE_BE_UINT16(pos + 28, kSampleLength / 2 - 100 * (i + 1));
+			}
+			pos += 30;
+		}
+
+		*pos++ = 2; // Song length
+		*pos++ = 0;
+		pos += 128; // Both positions play pattern 0
+
+		memcpy(pos, "M.K.", 4);
+		pos += 4;
+
+		for (int row = 0; row < 64; row++) {
+			for (int channel = 0; channel < 4; channel++) {
+				if ((row + channel) % 4 == 0) {
+					const int sample = (row / 4 + channel) % kSampleCount + 1;
+					const uint16 period = periods[(row + channel * 3) % ARRAYSIZE(periods)];
+					pos[0] = (sample & 0xF0) | (period >> 8);
+					pos[1] = period & 0xFF;
+					pos[2] = (sample & 0x0F) << 4;
+				} else if (row % 4 == 2) {
+					// Volume slide down
+					pos[2] = 0x0A;
+					pos[3] = 0x02;
+				}
+				pos += 4;
+			}
+		}
+
+		uint32 seed = 1;
+		for (int i = 0; i < kSampleCount; i++) {
+			for (int j = 0; j < kSampleLength; j++) {
+				seed = seed * 1103515245 + 12345;
+				// Saw waves with some noise
+				*pos++ = (byte)((j * (i + 1) * 4) + ((seed >> 16) & 0x0F));
+			}
+		}
+
+		return data;
+	}
+
+	static uint32 render(Audio::AudioStream *stream, const char *name) {
+		int16 *buffer = new int16[kRenderFrames * 2];
+		const uint32 start = g_system->getMillis();
+
+		int samples = 0;
+		while (samples < kRenderFrames * 2) {
+			const int read = stream->readBuffer(buffer + samples, MIN(1000, kRenderFrames * 2 - samples));
+			if (read <= 0)
+				break;
+			samples += read;
+		}
+
+		debug("%s: rendering %d samples took %d ms", name, samples, g_system->getMillis() - start);
+
+		bool silent = true;
+		for (int i = 0; i < samples && silent; i++)
+			silent = buffer[i] == 0;
+		TS_ASSERT(!silent);
+
+		Common::CRC32 crc;
+		const uint32 result = crc.crcFast((const byte *)buffer, samples * sizeof(int16));
+		delete[] buffer;
+		return result;
+	}
+
+public:
+	void test_mod_xm_s3m() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		uint32 size;
+		byte *data = createModule(size);
+
+		// The output of the mixer before it rendered in spans
+		static const uint32 expected[2] = { 2746799509u, 204195306u };
+
+		for (int interpolation = 0; interpolation < 2; interpolation++) {
+			Common::MemoryReadStream *stream = new Common::MemoryReadStream(data, size);
+			Audio::AudioStream *mod = Audio::makeModXmS3mStream(stream, DisposeAfterUse::YES, 0, kRate, interpolation);
+			TS_ASSERT(mod);
+			if (mod)
+				TS_ASSERT_EQUALS(render(mod, interpolation ? "MOD (interpolated)" : "MOD"), expected[interpolation]);
+			delete mod;
+		}
+
+		delete[] data;
+#endif
+	}
+};
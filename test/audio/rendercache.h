@@ -0,0 +1,344 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/fmopl.h"
+#include "audio/rendercache.h"
+#include "common/array.h"
+#include "common/config-manager.h"
+#include "common/func.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/memstream.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+/**
+ * A render cache which keeps its recordings in memory.
+ */
+class MemoryRenderCache : public Audio::RenderCache {
+public:
+	typedef Common::HashMap<Common::String, Common::Array<byte> > FileMap;
+
+	MemoryRenderCache(FileMap &files, const Common::String &emulator = "test", int rate = 11025, bool stereo = true) :
+		Audio::RenderCache(emulator, rate, stereo), _files(files) {}
+
+	~MemoryRenderCache() override {
+		// The base class can only use its own file access
+		stopSong();
+	}
+
+protected:
+	class RecordingStream : public Common::WriteStream {
+	public:
+		RecordingStream(Common::Array<byte> &data) : _data(data) { _data.clear(); }
+
+		uint32 write(const void *dataPtr, uint32 dataSize) override {
+			const byte *bytes = (const byte *)dataPtr;
+			for (uint32 i = 0; i < dataSize; i++)
+				_data.push_back(bytes[i]);
+			return dataSize;
+		}
+
+		int64 pos() const override { return _data.size(); }
+
+	private:
+		Common::Array<byte> &_data;
+	};
+
+	Common::SeekableReadStream *openRecording(const Common::String &name) override {
+		if (!_files.contains(name))
+			return nullptr;
+		const Common::Array<byte> &data = _files[name];
+		return new Common::MemoryReadStream(data.begin(), data.size());
+	}
+
+	Common::WriteStream *createRecording(const Common::String &name) override {
+		return new RecordingStream(_files[name]);
+	}
+
+	void removeRecording(const Common::String &name) override {
+		_files.erase(name);
+	}
+
+	Common::StringArray listRecordings() override {
+		Common::StringArray names;
+		for (FileMap::const_iterator i = _files.begin(); i != _files.end(); ++i)
+			names.push_back(i->_key);
+		return names;
+	}
+
+	uint32 getRecordingSize(const Common::String &name) override {
+		return _files.contains(name) ? _files[name].size() : 0;
+	}
+
+private:
+	FileMap &_files;
+};
+
+/**
+ * An emulated mono OPL which renders a saw wave with the period set through
+ * register 0, or silence for a period of 0. Its timer plays a song which
+ * changes the period at ticks which do not fall on whole samples.
+ */
+class SawOPL : public OPL::EmulatedOPL {
+public:
+	SawOPL(MemoryRenderCache::FileMap &files) :
+		_files(files), _period(0), _phase(0), _rendered(0), _songTick(-1), _songLength(0), _divergeAt(-1) {
+		// Call the timer from readBuffer() without starting the OPL, since
+		// there is no mixer
+		_callback.reset(new Common::Functor0Mem<void, SawOPL>(this, &SawOPL::onTimer));
+		setCallbackFrequency(kDefaultCallbackFrequency);
+	}
+
+	~SawOPL() override {
+		_callback.reset();
+	}
+
+	bool init() override {
+		initRenderCache("saw");
+		return true;
+	}
+
+	void reset() override {}
+	void write(int a, int v) override { cacheWrite(a, v); }
+	byte read(int a) override { return 0; }
+
+	void writeReg(int r, int v) override {
+		cacheWriteReg(r, v);
+		if (r == 0) {
+			_period = v;
+			_phase = 0;
+		}
+	}
+
+	int getRate() const override { return 11025; }
+	bool isStereo() const override { return false; }
+
+	void startSong(int seconds, int divergeAt = -1) {
+		_songTick = 0;
+		_songLength = seconds * kDefaultCallbackFrequency;
+		_divergeAt = divergeAt;
+	}
+
+	int getRendered() const { return _rendered; }
+
+	enum {
+		kNoteTicks = 123
+	};
+
+protected:
+	void generateSamples(int16 *buffer, int numSamples) override {
+		for (int i = 0; i < numSamples; i++) {
+			buffer[i] = _period ? (int16)((_phase + 1) * 1000 / _period) : 0;
+			if (_period)
+				_phase = (_phase + 1) % _period;
+		}
+		_rendered += numSamples;
+	}
+
+	Audio::RenderCache *createRenderCache(const Common::String &emulator) override {
+		return new MemoryRenderCache(_files, emulator, getRate(), isStereo());
+	}
+
+private:
+	void onTimer() {
+		if (_songTick < 0)
+			return;
+
+		if (_songTick == _songLength) {
+			writeReg(0, 0);
+			_songTick = -1;
+			return;
+		}
+
+		if (_songTick % kNoteTicks == 0) {
+			const int note = _songTick / kNoteTicks;
+			writeReg(0, note == _divergeAt ? 99 : 10 + note);
+		}
+		_songTick++;
+	}
+
+	MemoryRenderCache::FileMap &_files;
+	int _period;
+	int _phase;
+	int _rendered;
+
+	int _songTick;
+	int _songLength;
+	int _divergeAt;
+};
+
+class RenderCacheTestSuite : public CxxTest::TestSuite
+{
+public:
+	enum {
+		kChunkFrames = 1000,
+		kSongFrames = 10500,
+		kOPLSongSeconds = 4
+	};
+
+	// Play a song like an emulator would, with a tick at every chunk, and
+	// render whatever could not be read from the cache. Returns the number
+	// of frames read from the cache.
+	int playSong(Audio::RenderCache &cache, int16 *output, int frames, uint32 divergeAt = 0) {
+		int cached = 0;
+
+		for (int pos = 0; pos < frames; pos += kChunkFrames) {
+			const int count = MIN<int>(kChunkFrames, frames - pos);
+
+			// The song starts at the first tick, and has some input at every
+			// one of them
+			TS_ASSERT_EQUALS(cache.onTick(), pos == 0);
+			cache.addInput(pos == (int)divergeAt && divergeAt ? 0xFFFF : pos);
+
+			int16 *buffer = output + pos * 2;
+			const int read = cache.read(buffer, count);
+			cached += read;
+
+			for (int i = read * 2; i < count * 2; i++)
+				buffer[i] = (int16)((pos * 2 + i) * 7);
+			cache.write(buffer + read * 2, count - read);
+		}
+
+		return cached;
+	}
+
+	void test_record_and_replay() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		MemoryRenderCache::FileMap files;
+		MemoryRenderCache cache(files);
+
+		int16 *recorded = new int16[kSongFrames * 2];
+		int16 *replayed = new int16[kSongFrames * 2];
+
+		cache.startSong("song");
+		TS_ASSERT_EQUALS(playSong(cache, recorded, kSongFrames), 0);
+		cache.stopSong();
+
+		// Recordings are hidden from cloud sync
+		TS_ASSERT_EQUALS(files.size(), 1u);
+		TS_ASSERT(files.begin()->_key.hasPrefix("."));
+
+		// Same input, so everything comes from the cache
+		memset(replayed, 0, kSongFrames * 2 * sizeof(int16));
+		cache.startSong("song");
+		TS_ASSERT_EQUALS(playSong(cache, replayed, kSongFrames), kSongFrames);
+		cache.stopSong();
+
+		TS_ASSERT_EQUALS(memcmp(recorded, replayed, kSongFrames * 2 * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(files.size(), 1u);
+
+		// Different input stops replaying at the end of the block
+		cache.startSong("song");
+		TS_ASSERT_EQUALS(playSong(cache, replayed, kSongFrames, 5000), 8192);
+		cache.stopSong();
+
+		TS_ASSERT_EQUALS(files.size(), 1u);
+
+		delete[] recorded;
+		delete[] replayed;
+#endif
+	}
+
+	void test_discard_short_recording() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		MemoryRenderCache::FileMap files;
+		MemoryRenderCache cache(files);
+
+		int16 *buffer = new int16[kSongFrames * 2 * 2];
+
+		cache.startSong("song");
+		TS_ASSERT_EQUALS(playSong(cache, buffer, kSongFrames), 0);
+		cache.stopSong();
+		TS_ASSERT_EQUALS(files.size(), 1u);
+
+		// Playing the song for longer than it was recorded discards the
+		// recording, since the emulator has to take over
+		cache.startSong("song");
+		TS_ASSERT_EQUALS(playSong(cache, buffer, kSongFrames * 2), kSongFrames);
+		cache.stopSong();
+		TS_ASSERT_EQUALS(files.size(), 0u);
+
+		// So that it is recorded again, this time for the whole length
+		cache.startSong("song");
+		TS_ASSERT_EQUALS(playSong(cache, buffer, kSongFrames * 2), 0);
+		cache.stopSong();
+		TS_ASSERT_EQUALS(files.size(), 1u);
+
+		cache.startSong("song");
+		TS_ASSERT_EQUALS(playSong(cache, buffer, kSongFrames * 2), kSongFrames * 2);
+		cache.stopSong();
+
+		delete[] buffer;
+#endif
+	}
+
+	// Play a song on the OPL the way a driver would, starting at some
+	// position in the output. Returns the index of the first sample of the
+	// song in the output.
+	int playOPLSong(SawOPL &opl, int16 *output, int frames, int lead, int divergeAt = -1) {
+		opl.readBuffer(output, lead);
+
+		opl.setRenderCacheSong("saw-song");
+		opl.startSong(kOPLSongSeconds, divergeAt);
+		opl.readBuffer(output, frames);
+		opl.setRenderCacheSong(Common::String());
+
+		int start = 0;
+		while (start < frames && !output[start])
+			start++;
+		return start;
+	}
+
+	void test_emulated_opl() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		if (!g_system)
+			Common::install_null_g_system();
+
+		ConfMan.setBool("music_render_cache", true, Common::ConfigManager::kTransientDomain);
+
+		MemoryRenderCache::FileMap files;
+		SawOPL *opl = new SawOPL(files);
+		TS_ASSERT(opl->init());
+
+		// Enough to play the song after starting it
+		const int frames = (kOPLSongSeconds + 1) * 11025;
+		int16 *recorded = new int16[frames];
+		int16 *replayed = new int16[frames];
+
+		const int recordedStart = playOPLSong(*opl, recorded, frames, 1000);
+		TS_ASSERT_EQUALS(opl->getRendered(), 1000 + frames);
+		TS_ASSERT_EQUALS(files.size(), 1u);
+
+		// The song starts at a tick, so it plays the same from another
+		// position, and only the samples before that tick are rendered.
+		// Playing it for a bit less makes sure that it stays in the cache.
+		int rendered = opl->getRendered();
+		const int replayedStart = playOPLSong(*opl, replayed, frames - 100, 1234);
+		TS_ASSERT_LESS_THAN(opl->getRendered() - rendered, 1234 + 50);
+
+		const int songFrames = kOPLSongSeconds * 11025;
+		TS_ASSERT_LESS_THAN(recordedStart, 50);
+		TS_ASSERT_LESS_THAN(replayedStart, 50);
+		TS_ASSERT_EQUALS(memcmp(recorded + recordedStart, replayed + replayedStart, songFrames * sizeof(int16)), 0);
+
+		// Different register writes make the emulator take over
+		rendered = opl->getRendered();
+		const int divergedStart = playOPLSong(*opl, replayed, frames - 100, 1000, 2);
+		TS_ASSERT_LESS_THAN(rendered + 1000 + 11025, opl->getRendered());
+		TS_ASSERT_DIFFERS(memcmp(recorded + recordedStart, replayed + divergedStart, songFrames * sizeof(int16)), 0);
+
+		delete opl;
+		delete[] recorded;
+		delete[] replayed;
+
+		ConfMan.removeKey("music_render_cache", Common::ConfigManager::kTransientDomain);
+#endif
+	}
+};
@@ -0,0 +1,70 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+
+class ConfigManagerTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_handle() {
+		const Common::String oldDomain = ConfMan.getActiveDomainName();
+
+		ConfMan.registerDefault("test_handle_int", 3);
+		ConfMan.registerDefault("test_handle_bool", false);
+
+		Common::ConfigManager::Handle<int> intHandle("test_handle_int");
+		Common::ConfigManager::Handle<bool> boolHandle("test_handle_bool");
+		Common::ConfigManager::Handle<Common::String> strHandle("test_handle_int");
+
+		TS_ASSERT_EQUALS(intHandle.get(), 3);
+		TS_ASSERT_EQUALS(boolHandle.get(), false);
+		TS_ASSERT_EQUALS(strHandle.get(), "3");
+
+		ConfMan.setInt("test_handle_int", 5);
+		ConfMan.setBool("test_handle_bool", true);
+		TS_ASSERT_EQUALS(intHandle.get(), 5);
+		TS_ASSERT_EQUALS(boolHandle.get(), true);
+		TS_ASSERT_EQUALS(strHandle.get(), "5");
+
+		// A game domain overrides the application domain
+		ConfMan.addGameDomain("test_handle_game");
+		ConfMan.setActiveDomain("test_handle_game");
+		TS_ASSERT_EQUALS(intHandle.get(), 5);
+		ConfMan.getActiveDomain()->setVal("test_handle_int", "7");
+		TS_ASSERT_EQUALS(intHandle.get(), 7);
+
+		// A handle for a specific domain is not affected by the active one
+		Common::ConfigManager::Handle<int> appHandle("test_handle_int", Common::ConfigManager::kApplicationDomain);
+		TS_ASSERT_EQUALS(appHandle.get(), 5);
+
+		ConfMan.setActiveDomain(oldDomain);
+		TS_ASSERT_EQUALS(intHandle.get(), 5);
+
+		ConfMan.removeGameDomain("test_handle_game");
+		ConfMan.removeKey("test_handle_int", Common::ConfigManager::kApplicationDomain);
+		ConfMan.removeKey("test_handle_bool", Common::ConfigManager::kApplicationDomain);
+		TS_ASSERT_EQUALS(intHandle.get(), 3);
+		TS_ASSERT_EQUALS(appHandle.get(), 3);
+		TS_ASSERT_EQUALS(boolHandle.get(), false);
+	}
+
+	void test_handle_misc_domain() {
+		ConfMan.addMiscDomain("test_handle_misc");
+		ConfMan.getDomain("test_handle_misc")->setVal("test_handle_key", "1");
+
+		Common::ConfigManager::Handle<int> handle("test_handle_key", "test_handle_misc");
+		TS_ASSERT_EQUALS(handle.get(), 1);
+
+		// The handle must not return the value of a removed domain
+		ConfMan.removeMiscDomain("test_handle_misc");
+		ConfMan.addMiscDomain("test_handle_misc");
+		TS_ASSERT_EQUALS(handle.get(), 0);
+
+		ConfMan.getDomain("test_handle_misc")->setVal("test_handle_key", "2");
+		ConfMan.renameMiscDomain("test_handle_misc", "test_handle_misc_old");
+		ConfMan.addMiscDomain("test_handle_misc");
+		TS_ASSERT_EQUALS(handle.get(), 0);
+
+		ConfMan.removeMiscDomain("test_handle_misc_old");
+		ConfMan.removeMiscDomain("test_handle_misc");
+	}
+};
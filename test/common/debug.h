@@ -0,0 +1,80 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/debug-channels.h"
+
+class DebugTestSuite : public CxxTest::TestSuite
+{
+	enum {
+		kChannelCount = 64
+	};
+
+	static const DebugChannelDef *getChannels() {
+		static DebugChannelDef channels[kChannelCount + 1];
+		static char names[kChannelCount][4];
+
+		for (int i = 0; i < kChannelCount; i++) {
+			snprintf(names[i], sizeof(names[i]), "c%d", i);
+			// Bit flags as well as sequential ids, like the engines use
+			channels[i].channel = i < 31 ? 1 << i : 1000 + i;
+			channels[i].name = names[i];
+			channels[i].description = "";
+		}
+		channels[kChannelCount].channel = 0;
+		channels[kChannelCount].name = nullptr;
+		channels[kChannelCount].description = nullptr;
+		return channels;
+	}
+
+public:
+	void test_channel_set() {
+		const DebugChannelDef *channels = getChannels();
+		const int oldLevel = gDebugLevel;
+
+		DebugMan.addAllDebugChannels(channels);
+		gDebugLevel = 3;
+
+		for (int i = 0; i < kChannelCount; i++)
+			TS_ASSERT(!debugChannelSet(0, channels[i].channel));
+
+		// Some channels share a bit in the filter, but they must not be
+		// reported as enabled
+		for (int enabled = 0; enabled < kChannelCount; enabled++) {
+			DebugMan.enableDebugChannel(channels[enabled].name);
+
+			for (int i = 0; i < kChannelCount; i++) {
+				TS_ASSERT_EQUALS(debugChannelSet(3, channels[i].channel), i == enabled);
+				TS_ASSERT_EQUALS(debugChannelSet(-1, channels[i].channel), i == enabled);
+				TS_ASSERT_EQUALS(DebugMan.isDebugChannelEnabled(channels[i].channel), i == enabled);
+				TS_ASSERT(!debugChannelSet(4, channels[i].channel));
+			}
+
+			DebugMan.disableDebugChannel(channels[enabled].name);
+		}
+
+		DebugMan.enableAllDebugChannels();
+		for (int i = 0; i < kChannelCount; i++)
+			TS_ASSERT(debugChannelSet(1, channels[i].channel));
+		DebugMan.disableAllDebugChannels();
+
+		// Debug level 11 turns on all channels, unless only the channel is checked
+		gDebugLevel = 11;
+		TS_ASSERT(debugChannelSet(5, channels[0].channel));
+		TS_ASSERT(!debugChannelSet(-1, channels[0].channel));
+
+		DebugMan.removeAllDebugChannels();
+		gDebugLevel = oldLevel;
+	}
+
+	void test_level_set() {
+		const int oldLevel = gDebugLevel;
+
+		gDebugLevel = -1;
+		TS_ASSERT(!debugLevelSet(0));
+		gDebugLevel = 2;
+		TS_ASSERT(debugLevelSet(2));
+		TS_ASSERT(!debugLevelSet(3));
+
+		gDebugLevel = oldLevel;
+	}
+};
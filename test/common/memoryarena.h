@@ -0,0 +1,78 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memoryarena.h"
+#include "common/memorytracker.h"
+
+class MemoryArenaTestSuite : public CxxTest::TestSuite {
+public:
+	void test_allocate() {
+		Common::MemoryArena arena(256);
+
+		byte *a = (byte *)arena.allocate(1);
+		uint32 *b = arena.allocateArray<uint32>(10);
+		double *c = arena.allocateArray<double>(1);
+		TS_ASSERT_EQUALS((uintptr)b % 4, 0U);
+		TS_ASSERT_EQUALS((uintptr)c % sizeof(double), 0U);
+		TS_ASSERT(b > (uint32 *)a);
+		TS_ASSERT((byte *)c >= (byte *)(b + 10));
+
+		// Allocations larger than a block get a block of their own
+		byte *big = (byte *)arena.allocate(1000);
+		memset(big, 0xff, 1000);
+		TS_ASSERT_LESS_THAN_EQUALS(1000U, arena.getReservedSize());
+	}
+
+	void test_release() {
+		Common::MemoryArena arena(256);
+
+		Common::MemoryArena::Mark empty = arena.getMark();
+		void *first = arena.allocate(16);
+		Common::MemoryArena::Mark mark = arena.getMark();
+		void *second = arena.allocate(16);
+
+		{
+			Common::MemoryArena::Scope scope(arena);
+			for (int i = 0; i < 100; i++)
+				arena.allocate(16);
+		}
+		TS_ASSERT_EQUALS(arena.allocate(16), (void *)((byte *)second + 16));
+
+		const size_t reserved = arena.getReservedSize();
+		arena.release(mark);
+		TS_ASSERT_EQUALS(arena.allocate(16), second);
+
+		// The blocks are reused
+		arena.release(empty);
+		TS_ASSERT_EQUALS(arena.allocate(16), first);
+		for (int i = 0; i < 100; i++)
+			arena.allocate(16);
+		TS_ASSERT_EQUALS(arena.getReservedSize(), reserved);
+
+		arena.reset();
+		TS_ASSERT_EQUALS(arena.allocate(16), first);
+
+		arena.freeBlocks();
+		TS_ASSERT_EQUALS(arena.getReservedSize(), 0U);
+	}
+
+	void test_tag() {
+#ifdef USE_MEMORY_TRACKER
+		Common::MemoryTag tag("Test");
+
+		void *ptr = tag.allocate(100);
+		{
+			Common::MemoryArena arena(1000, &tag);
+			arena.allocate(10);
+			TS_ASSERT_EQUALS(tag.getStats().count, 2U);
+			TS_ASSERT_EQUALS(tag.getStats().bytes, 1100U);
+		}
+		tag.deallocate(ptr);
+
+		Common::MemoryTag::Stats stats = tag.getStats();
+		TS_ASSERT_EQUALS(stats.count, 0U);
+		TS_ASSERT_EQUALS(stats.totalCount, 2U);
+		TS_ASSERT_EQUALS(stats.bytes, 0U);
+		TS_ASSERT_EQUALS(stats.peakBytes, 1100U);
+#endif
+	}
+};
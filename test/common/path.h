@@ -538,4 +538,46 @@ class PathTestSuite : public CxxTest::TestSuite
 	void test_canUnescape() {
 		TS_ASSERT(Common::Path::canUnescape(true, true, ""));
 	}
+
+	void test_hash_cache() {
+		Common::Path p("foo/Bar");
+		TS_ASSERT_EQUALS(p.hashIgnoreCase(), Common::Path("FOO/bar").hashIgnoreCase());
+		TS_ASSERT_EQUALS(p.hashIgnoreCaseAndMac(), Common::Path("FOO/bar").hashIgnoreCaseAndMac());
+
+		// Changing the path must update the hashes
+		p.appendInPlace("/baz");
+		TS_ASSERT_EQUALS(p.hashIgnoreCase(), Common::Path("foo/bar/baz").hashIgnoreCase());
+		TS_ASSERT_EQUALS(p.hashIgnoreCaseAndMac(), Common::Path("foo/bar/baz").hashIgnoreCaseAndMac());
+		p.joinInPlace("qux");
+		TS_ASSERT_EQUALS(p.hashIgnoreCase(), Common::Path("foo/bar/baz/qux").hashIgnoreCase());
+		p.joinInPlace(Common::Path("quux/"));
+		TS_ASSERT_EQUALS(p.hashIgnoreCase(), Common::Path("foo/bar/baz/qux/quux/").hashIgnoreCase());
+		p.removeTrailingSeparators();
+		TS_ASSERT_EQUALS(p.hashIgnoreCaseAndMac(), Common::Path("foo/bar/baz/qux/quux").hashIgnoreCaseAndMac());
+		TS_ASSERT_EQUALS(p.appendComponent("a").hashIgnoreCase(), Common::Path("foo/bar/baz/qux/quux/a").hashIgnoreCase());
+		p.set("other");
+		TS_ASSERT_EQUALS(p.hashIgnoreCase(), Common::Path("other").hashIgnoreCase());
+		p.clear();
+		TS_ASSERT_EQUALS(p.hashIgnoreCase(), Common::Path().hashIgnoreCase());
+
+		// Hashed paths still compare correctly
+		Common::Path x("Dir/File.txt"), y("dir/file.TXT"), z("dir/file2.txt");
+		x.hashIgnoreCase();
+		y.hashIgnoreCase();
+		z.hashIgnoreCase();
+		TS_ASSERT(x.equalsIgnoreCase(y));
+		TS_ASSERT(!x.equalsIgnoreCase(z));
+		x.hashIgnoreCaseAndMac();
+		y.hashIgnoreCaseAndMac();
+		TS_ASSERT(x.equalsIgnoreCaseAndMac(y));
+
+		// Normalizing twice gives the same result
+		const char *paths[] = { "/foo//./bar//", "foo/../../bar//", "foo/../|bar", "/", "" };
+		for (int i = 0; i < ARRAYSIZE(paths); i++) {
+			Common::Path normalized = Common::Path(paths[i]).normalize();
+			TS_ASSERT_EQUALS(normalized.normalize(), normalized);
+			normalized.appendInPlace("/x/..");
+			TS_ASSERT_DIFFERS(normalized.normalize(), normalized);
+		}
+	}
 };
@@ -1,6 +1,7 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/serializer.h"
+#include "common/memstream.h"
 #include "common/stream.h"
 
 class SerializerTestSuite : public CxxTest::TestSuite {
@@ -108,4 +109,69 @@ public:
 	void test_read_v2_as_v2() {
 		readVersioned_v2(_inStreamV2, 2);
 	}
+
+	// Sync a bit of everything, with buffers small enough to be refilled
+	void syncMixed(Common::Serializer &ser, uint32 *values, uint16 *shorts, double *doubles, Common::String &str, uint32 &last) {
+		TS_ASSERT(ser.matchBytes("MAGI", 4));
+		ser.syncString(str);
+		ser.syncArrayAsUint32LE(values, 1000);
+		ser.skip(3);
+		ser.syncArrayAsUint16BE(shorts, 7);
+		ser.syncArrayAsDoubleLE(doubles, 3);
+		ser.syncAsUint32BE(last);
+	}
+
+	void test_buffered() {
+		uint32 values[1000];
+		uint16 shorts[7];
+		double doubles[3] = { 0.5, -2.0, 1e10 };
+		for (int i = 0; i < 1000; i++)
+			values[i] = i * 0x01010101;
+		for (int i = 0; i < 7; i++)
+			shorts[i] = 0xff00 + i;
+		Common::String str("buffered");
+		uint32 last = 0xdeadbeef;
+
+		Common::MemoryWriteStreamDynamic unbuffered(DisposeAfterUse::YES);
+		Common::MemoryWriteStreamDynamic buffered(DisposeAfterUse::YES);
+		{
+			Common::Serializer ser(nullptr, &unbuffered);
+			syncMixed(ser, values, shorts, doubles, str, last);
+		}
+		{
+			Common::Serializer ser(nullptr, &buffered);
+			ser.enableBuffering(64);
+			syncMixed(ser, values, shorts, doubles, str, last);
+			TS_ASSERT_EQUALS(ser.bytesSynced(), unbuffered.size());
+		}
+
+		TS_ASSERT_EQUALS(buffered.size(), unbuffered.size());
+		TS_ASSERT_EQUALS(memcmp(buffered.getData(), unbuffered.getData(), buffered.size()), 0);
+		TS_ASSERT_EQUALS(READ_LE_UINT32(unbuffered.getData() + 4 + 9 + 4 * 5), 5 * 0x01010101U);
+
+		// Append a byte which must not be consumed by the serializer
+		unbuffered.writeByte(0x42);
+
+		uint32 values2[1000];
+		uint16 shorts2[7];
+		double doubles2[3];
+		Common::String str2;
+		uint32 last2 = 0;
+		Common::MemoryReadStream in(unbuffered.getData(), unbuffered.size());
+		{
+			Common::Serializer ser(&in, nullptr);
+			ser.enableBuffering(64);
+			syncMixed(ser, values2, shorts2, doubles2, str2, last2);
+		}
+
+		TS_ASSERT_EQUALS(str2, str);
+		TS_ASSERT_EQUALS(memcmp(values2, values, sizeof(values)), 0);
+		TS_ASSERT_EQUALS(memcmp(shorts2, shorts, sizeof(shorts)), 0);
+		TS_ASSERT_EQUALS(doubles2[2], doubles[2]);
+		TS_ASSERT_EQUALS(last2, last);
+
+		// The data read ahead is given back when the serializer is done
+		TS_ASSERT_EQUALS(in.readByte(), 0x42);
+		TS_ASSERT(!in.eos());
+	}
 };
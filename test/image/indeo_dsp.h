@@ -0,0 +1,108 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "image/codecs/indeo/indeo_dsp.h"
+
+using Image::Indeo::IndeoDSP;
+
+class IndeoDSPTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	int32 nextRandom(int32 range) {
+		_seed = _seed * 1103515245 + 12345;
+		return (int32)((_seed >> 8) % (2 * range + 1)) - range;
+	}
+
+	void compareKernels(const IndeoDSP::Kernels &kernels) {
+		_seed = 1;
+
+		for (int iter = 0; iter < 200; iter++) {
+			int32 coeffs[64];
+			uint8 flags[8];
+			int16 expected[8 * 10], actual[8 * 10];
+
+			// Mostly small coefficients as in real streams, with some large
+			// ones to exercise the 16-bit truncation of the output
+			for (int i = 0; i < 64; i++)
+				coeffs[i] = nextRandom(iter & 1 ? 40000 : 300);
+			for (int i = 0; i < 8; i++)
+				flags[i] = nextRandom(3) != 0;
+
+			memset(expected, 0x55, sizeof(expected));
+			memset(actual, 0x55, sizeof(actual));
+			IndeoDSP::kernelsGeneric.inverseHaar8x8(coeffs, expected, 10, flags);
+			kernels.inverseHaar8x8(coeffs, actual, 10, flags);
+			TS_ASSERT_SAME_DATA(expected, actual, sizeof(expected));
+
+			memset(expected, 0x55, sizeof(expected));
+			memset(actual, 0x55, sizeof(actual));
+			IndeoDSP::kernelsGeneric.inverseSlant8x8(coeffs, expected, 10, flags);
+			kernels.inverseSlant8x8(coeffs, actual, 10, flags);
+			TS_ASSERT_SAME_DATA(expected, actual, sizeof(expected));
+		}
+
+		const IndeoDSP::MCKernel mcGeneric[4] = {
+			IndeoDSP::kernelsGeneric.mc8x8NoDelta, IndeoDSP::kernelsGeneric.mc8x8Delta,
+			IndeoDSP::kernelsGeneric.mc4x4NoDelta, IndeoDSP::kernelsGeneric.mc4x4Delta
+		};
+		const IndeoDSP::MCKernel mcTested[4] = {
+			kernels.mc8x8NoDelta, kernels.mc8x8Delta,
+			kernels.mc4x4NoDelta, kernels.mc4x4Delta
+		};
+
+		for (int iter = 0; iter < 50; iter++) {
+			int16 ref[12 * 12], start[8 * 12];
+			for (uint i = 0; i < ARRAYSIZE(ref); i++)
+				ref[i] = nextRandom(iter & 1 ? 32767 : 255);
+			for (uint i = 0; i < ARRAYSIZE(start); i++)
+				start[i] = nextRandom(32767);
+
+			for (int k = 0; k < 4; k++) {
+				for (int mcType = 0; mcType < 4; mcType++) {
+					int16 expected[8 * 12], actual[8 * 12];
+					memcpy(expected, start, sizeof(start));
+					memcpy(actual, start, sizeof(start));
+					mcGeneric[k](expected, 12, ref + 13, 12, mcType);
+					mcTested[k](actual, 12, ref + 13, 12, mcType);
+					TS_ASSERT_SAME_DATA(expected, actual, sizeof(expected));
+				}
+			}
+		}
+	}
+
+public:
+	void test_simd_kernels() {
+#ifdef SCUMMVM_NEON
+		compareKernels(IndeoDSP::kernelsNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareKernels(IndeoDSP::kernelsSSE2);
+#endif
+	}
+};
@@ -0,0 +1,64 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/memstream.h"
+#include "image/png.h"
+#include "graphics/surface.h"
+
+class PNGDecoderTestSuite : public CxxTest::TestSuite {
+public:
+	void test_scale_hint() {
+#ifdef USE_PNG
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+
+		Graphics::Surface source;
+		source.create(37, 20, format);
+		for (int y = 0; y < source.h; y++)
+			for (int x = 0; x < source.w; x++)
+				source.setPixel(x, y, format.ARGBToColor(255, x * 6, y * 12, (x + y) * 4));
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		TS_ASSERT(Image::writePNG(out, source));
+
+		// A hint a quarter of the size in both dimensions keeps every fourth
+		// row and column
+		Image::PNGDecoder decoder;
+		decoder.setScaleHint(9, 5);
+		Common::MemoryReadStream stream(out.getData(), out.size());
+		TS_ASSERT(decoder.loadStream(stream));
+
+		const Graphics::Surface *surface = decoder.getSurface();
+		TS_ASSERT(surface != 0);
+		if (surface == 0) {
+			source.free();
+			return;
+		}
+
+		TS_ASSERT_EQUALS(surface->w, 10);
+		TS_ASSERT_EQUALS(surface->h, 5);
+
+		for (int y = 0; y < surface->h; y++) {
+			for (int x = 0; x < surface->w; x++) {
+				byte a1, r1, g1, b1, a2, r2, g2, b2;
+				source.format.colorToARGB(source.getPixel(x * 4, y * 4), a1, r1, g1, b1);
+				surface->format.colorToARGB(surface->getPixel(x, y), a2, r2, g2, b2);
+				TS_ASSERT_EQUALS(r1, r2);
+				TS_ASSERT_EQUALS(g1, g2);
+				TS_ASSERT_EQUALS(b1, b2);
+			}
+		}
+
+		// Without a hint the full image is decoded
+		decoder.setScaleHint(0, 0);
+		stream.seek(0);
+		TS_ASSERT(decoder.loadStream(stream));
+		TS_ASSERT_EQUALS(decoder.getSurface()->w, 37);
+		TS_ASSERT_EQUALS(decoder.getSurface()->h, 20);
+
+		source.free();
+#endif
+	}
+};
@@ -0,0 +1,69 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "image/codecs/svq1.h"
+
+using Image::SVQ1Decoder;
+
+class SVQ1MotionCompensationTestSuite : public CxxTest::TestSuite {
+	void compareKernels(const SVQ1Decoder::MCKernels &kernels) {
+		uint32 seed = 1;
+		byte ref[20 * 20];
+		for (uint i = 0; i < ARRAYSIZE(ref); i++) {
+			seed = seed * 1103515245 + 12345;
+			ref[i] = seed >> 16;
+		}
+
+		for (int pos = 0; pos < 4; pos++) {
+			byte expected[20 * 18], actual[20 * 18];
+
+			memset(expected, 0x55, sizeof(expected));
+			memset(actual, 0x55, sizeof(actual));
+			SVQ1Decoder::mcKernelsGeneric.put8[pos](expected, ref + 21, 20, 8);
+			kernels.put8[pos](actual, ref + 21, 20, 8);
+			TS_ASSERT_SAME_DATA(expected, actual, sizeof(expected));
+
+			memset(expected, 0x55, sizeof(expected));
+			memset(actual, 0x55, sizeof(actual));
+			SVQ1Decoder::mcKernelsGeneric.put16[pos](expected, ref + 1, 20, 16);
+			kernels.put16[pos](actual, ref + 1, 20, 16);
+			TS_ASSERT_SAME_DATA(expected, actual, sizeof(expected));
+		}
+	}
+
+public:
+	void test_simd_kernels() {
+#ifdef SCUMMVM_NEON
+		compareKernels(SVQ1Decoder::mcKernelsNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareKernels(SVQ1Decoder::mcKernelsSSE2);
+#endif
+	}
+};
@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "common/stream.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -698,54 +699,31 @@ bool AVIDecoder::seekIntern(const Audio::Timestamp &time) {
 	// Reset any palette, if necessary
 	videoTrack->useInitialPalette();
 
-	int lastKeyFrame = -1;
-	int frameIndex = -1;
-	uint curFrame = 0;
+	const StreamChunkIndex &videoChunks = _indexEntries.getStreamChunks(videoIndex);
 
-	// Go through and figure out where we should be
-	// If there's a palette, we need to find the palette too
-	for (uint32 i = 0; i < _indexEntries.size(); i++) {
-		const OldIndex &index = _indexEntries[i];
-
-		// We don't care about RECs
-		if (index.id == ID_REC)
-			continue;
-
-		// We're only looking at entries for this track
-		if (getStreamIndex(index.id) != videoIndex)
-			continue;
-
-		uint16 streamType = getStreamType(index.id);
+	if (frame >= videoChunks.frames.size()) // This shouldn't happen.
+		return false;
 
-		if (streamType == kStreamTypePaletteChange) {
-			// We need to handle any palette change we see since there's no
-			// flag to tell if this is a "key" palette.
-			// Decode the palette
-			_fileStream->seek(_indexEntries[i].offset + 8);
-			Common::SeekableReadStream *chunk = 0;
+	uint32 frameIndex = videoChunks.frames[frame];
 
-			if (_indexEntries[i].size != 0)
-				chunk = _fileStream->readStream(_indexEntries[i].size);
+	// There's no flag to tell if a palette change is a "key" palette, so
+	// apply every palette change before the target frame
+	for (uint32 i = 0; i < videoChunks.palettes.size() && videoChunks.palettes[i] < frameIndex; i++) {
+		const OldIndex &index = _indexEntries[videoChunks.palettes[i]];
+		_fileStream->seek(index.offset + 8);
+		Common::SeekableReadStream *chunk = 0;
 
-			videoTrack->loadPaletteFromChunk(chunk);
-		} else {
-			// Check to see if this is a keyframe
-			// The first frame has to be a keyframe
-			if ((_indexEntries[i].flags & AVIIF_INDEX) || curFrame == 0)
-				lastKeyFrame = i;
+		if (index.size != 0)
+			chunk = _fileStream->readStream(index.size);
 
-			// Did we find the target frame?
-			if (frame == curFrame) {
-				frameIndex = i;
-				break;
-			}
-
-			curFrame++;
-		}
+		videoTrack->loadPaletteFromChunk(chunk);
 	}
 
-	if (frameIndex < 0) // This shouldn't happen.
-		return false;
+	// Find the last keyframe at or before the target frame
+	// The first frame has to be a keyframe
+	Common::Array<uint32>::const_iterator keyFrame = Common::upperBound(videoChunks.keyFrames.begin(), videoChunks.keyFrames.end(), frame);
+	assert(keyFrame != videoChunks.keyFrames.begin());
+	uint32 lastKeyFrame = *(keyFrame - 1);
 
 	// Update all the audio tracks
 	for (uint32 i = 0; i < _audioTracks.size(); i++) {
@@ -757,25 +735,16 @@ bool AVIDecoder::seekIntern(const Audio::Timestamp &time) {
 		// Set the chunk index for the track
 		audioTrack->setCurChunk(frame);
 
-		uint32 chunksFound = 0;
-		for (uint32 j = 0; j < _indexEntries.size(); j++) {
-			const OldIndex &index = _indexEntries[j];
-
-			// Continue ignoring RECs
-			if (index.id == ID_REC)
-				continue;
+		const StreamChunkIndex &audioChunks = _indexEntries.getStreamChunks(_audioTracks[i].index);
 
-			if (getStreamIndex(index.id) == _audioTracks[i].index) {
-				if (chunksFound == frame) {
-					_fileStream->seek(index.offset + 8);
-					Common::SeekableReadStream *audioChunk = _fileStream->readStream(index.size);
-					audioTrack->queueSound(audioChunk);
-					_audioTracks[i].chunkSearchOffset = (j == _indexEntries.size() - 1) ? _movieListEnd : _indexEntries[j + 1].offset;
-					break;
-				}
+		if (frame < audioChunks.chunks.size()) {
+			uint32 j = audioChunks.chunks[frame];
+			const OldIndex &index = _indexEntries[j];
 
-				chunksFound++;
-			}
+			_fileStream->seek(index.offset + 8);
+			Common::SeekableReadStream *audioChunk = _fileStream->readStream(index.size);
+			audioTrack->queueSound(audioChunk);
+			_audioTracks[i].chunkSearchOffset = (j == _indexEntries.size() - 1) ? _movieListEnd : _indexEntries[j + 1].offset;
 		}
 
 		// Skip any audio to bring us to the right time
@@ -783,25 +752,14 @@ bool AVIDecoder::seekIntern(const Audio::Timestamp &time) {
 	}
 
 	// Decode from keyFrame to curFrame - 1
-	for (int i = lastKeyFrame; i < frameIndex; i++) {
-		if (_indexEntries[i].id == ID_REC)
-			continue;
-
-		if (getStreamIndex(_indexEntries[i].id) != videoIndex)
-			continue;
-
-		uint16 streamType = getStreamType(_indexEntries[i].id);
+	for (uint32 i = lastKeyFrame; i < frame; i++) {
+		const OldIndex &index = _indexEntries[videoChunks.frames[i]];
 
-		// Ignore palettes, they were already handled
-		if (streamType == kStreamTypePaletteChange)
-			continue;
-
-		// Frame, hopefully
-		_fileStream->seek(_indexEntries[i].offset + 8);
+		_fileStream->seek(index.offset + 8);
 		Common::SeekableReadStream *chunk = 0;
 
-		if (_indexEntries[i].size != 0)
-			chunk = _fileStream->readStream(_indexEntries[i].size);
+		if (index.size != 0)
+			chunk = _fileStream->readStream(index.size);
 
 		videoTrack->decodeFrame(chunk);
 	}
@@ -1205,15 +1163,51 @@ AVIDecoder::TrackStatus::TrackStatus() : track(0), chunkSearchOffset(0) {
 }
 
 AVIDecoder::OldIndex *AVIDecoder::IndexEntries::find(uint index, uint frameNumber) {
-	for (uint idx = 0, frameCtr = 0; idx < size(); ++idx) {
-		if ((*this)[idx].id != ID_REC &&
-				AVIDecoder::getStreamIndex((*this)[idx].id) == index) {
-			if (frameCtr++ == frameNumber)
-				return &(*this)[idx];
+	const StreamChunkIndex &streamChunks = getStreamChunks(index);
+
+	if (frameNumber >= streamChunks.chunks.size())
+		return nullptr;
+
+	return &(*this)[streamChunks.chunks[frameNumber]];
+}
+
+const AVIDecoder::StreamChunkIndex &AVIDecoder::IndexEntries::getStreamChunks(uint index) {
+	if (_streamChunks.empty())
+		buildStreamChunks();
+
+	// Stream indices are two hex digits, so this is always in range
+	assert(index < _streamChunks.size());
+	return _streamChunks[index];
+}
+
+void AVIDecoder::IndexEntries::clear() {
+	Common::Array<OldIndex>::clear();
+	_streamChunks.clear();
+}
+
+void AVIDecoder::IndexEntries::buildStreamChunks() {
+	_streamChunks.resize(256);
+
+	for (uint idx = 0; idx < size(); ++idx) {
+		const OldIndex &entry = (*this)[idx];
+
+		// We don't care about RECs
+		if (entry.id == ID_REC)
+			continue;
+
+		StreamChunkIndex &streamChunks = _streamChunks[AVIDecoder::getStreamIndex(entry.id)];
+		streamChunks.chunks.push_back(idx);
+
+		if ((entry.id & 0xFFFF) == kStreamTypePaletteChange) {
+			streamChunks.palettes.push_back(idx);
+		} else {
+			// The first frame has to be a keyframe
+			if ((entry.flags & AVIIF_INDEX) || streamChunks.frames.empty())
+				streamChunks.keyFrames.push_back(streamChunks.frames.size());
+
+			streamChunks.frames.push_back(idx);
 		}
 	}
-
-	return nullptr;
 }
 
 } // End of namespace Video
@@ -314,9 +314,26 @@ protected:
 		uint32 chunkSearchOffset;
 	};
 
+	/**
+	 * Per-stream view of the index, built on first use so that seeking
+	 * doesn't have to walk the whole index every time.
+	 */
+	struct StreamChunkIndex {
+		Common::Array<uint32> chunks;    ///< Index entries of all the stream's chunks
+		Common::Array<uint32> frames;    ///< Index entries of the stream's frames (no palette changes)
+		Common::Array<uint32> keyFrames; ///< Frame numbers of the stream's keyframes
+		Common::Array<uint32> palettes;  ///< Index entries of the stream's palette changes
+	};
+
 	class IndexEntries : public Common::Array<OldIndex> {
 	public:
 		OldIndex *find(uint index, uint frameNumber);
+		const StreamChunkIndex &getStreamChunks(uint index);
+		void clear();
+
+	private:
+		void buildStreamChunks();
+		Common::Array<StreamChunkIndex> _streamChunks;
 	};
 
 	AVIHeader _header;
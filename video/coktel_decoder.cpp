@@ -2993,7 +2993,30 @@ int AdvancedVMDDecoder::VMDVideoTrack::getFrameCount() const {
 }
 
 const Graphics::Surface *AdvancedVMDDecoder::VMDVideoTrack::decodeNextFrame() {
-	return _decoder->decodeNextFrame();
+	const Graphics::Surface *surface = _decoder->decodeNextFrame();
+	if (!surface)
+		return 0;
+
+	const Common::Rect surfaceRect(surface->w, surface->h);
+
+	// The rects only match the surface when blitting directly. Otherwise,
+	// and if the previous frame has not been drawn yet, report everything.
+	if (!_dirtyRects.empty() || _decoder->getCurFrame() == 0 || _decoder->_blitMode != 0) {
+		_dirtyRects.clear();
+		_dirtyRects.push_back(surfaceRect);
+		return surface;
+	}
+
+	const Common::List<Common::Rect> &frameRects = _decoder->getDirtyRects();
+	for (Common::List<Common::Rect>::const_iterator it = frameRects.begin(); it != frameRects.end(); ++it) {
+		Common::Rect rect = *it;
+		rect.clip(surfaceRect);
+
+		if (!rect.isEmpty())
+			_dirtyRects.push_back(rect);
+	}
+
+	return surface;
 }
 
 const byte *AdvancedVMDDecoder::VMDVideoTrack::getPalette() const {
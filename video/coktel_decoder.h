@@ -610,11 +610,16 @@ private:
 		const byte *getPalette() const;
 		bool hasDirtyPalette() const;
 
+		const Common::List<Common::Rect> *getDirtyRects() const { return &_dirtyRects; }
+		void clearDirtyRects() { _dirtyRects.clear(); }
+
 	protected:
 		Common::Rational getFrameRate() const;
 
 	private:
 		VMDDecoder *_decoder;
+
+		Common::List<Common::Rect> _dirtyRects;
 	};
 
 	class VMDAudioTrack : public AudioTrack {
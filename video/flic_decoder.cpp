@@ -61,22 +61,6 @@ bool FlicDecoder::loadStream(Common::SeekableReadStream *stream) {
 	return true;
 }
 
-const Common::List<Common::Rect> *FlicDecoder::getDirtyRects() const {
-	const Track *track = getTrack(0);
-
-	if (track)
-		return ((const FlicVideoTrack *)track)->getDirtyRects();
-
-	return 0;
-}
-
-void FlicDecoder::clearDirtyRects() {
-	Track *track = getTrack(0);
-
-	if (track)
-		((FlicVideoTrack *)track)->clearDirtyRects();
-}
-
 void FlicDecoder::copyDirtyRectsToBuffer(uint8 *dst, uint pitch) {
 	Track *track = getTrack(0);
 
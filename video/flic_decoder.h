@@ -53,8 +53,7 @@ public:
 
 	virtual bool loadStream(Common::SeekableReadStream *stream);
 
-	const Common::List<Common::Rect> *getDirtyRects() const;
-	void clearDirtyRects();
+	using VideoDecoder::copyDirtyRectsToBuffer;
 	void copyDirtyRectsToBuffer(uint8 *dst, uint pitch);
 
 protected:
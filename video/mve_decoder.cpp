@@ -193,6 +193,9 @@ void MveDecoder::decodeFormat6() {
 		copyBlock(_frameSurface, _decodeSurface0, b);
 	}
 
+	_dirtyRects.clear();
+	_dirtyRects.push_back(Common::Rect(_width, _height));
+
 	Graphics::Surface t = _decodeSurface0;
 	_decodeSurface0 = _decodeSurface1;
 	_decodeSurface1 = t;
@@ -235,9 +238,19 @@ void MveDecoder::decodeFormat10() {
 
 	// Pass 3
 	skipStream.reset();
+	_dirtyBlocks.clear();
 	for (int b = 0; b != _widthInBlocks * _heightInBlocks; ++b) {
 		if (skipStream.skip()) continue;
 		copyBlock(_frameSurface, _decodeSurface0, b);
+		_dirtyBlocks.set(b);
+	}
+
+	// Only report the copied blocks if the previous frame has been drawn
+	if (_dirtyRects.empty()) {
+		VideoTrack::addDirtyBlocks(_dirtyRects, _dirtyBlocks, _widthInBlocks, _heightInBlocks, 8, 8);
+	} else {
+		_dirtyRects.clear();
+		_dirtyRects.push_back(Common::Rect(_width, _height));
 	}
 
 	Graphics::Surface t = _decodeSurface0;
@@ -361,6 +374,10 @@ void MveDecoder::readNextPacket() {
 				_frameSurface.create(_width, _height, _pixelFormat);
 				_frameSurface.fillRect(Common::Rect(_width, _height), 0);
 
+				_dirtyBlocks.set_size(_widthInBlocks * _heightInBlocks);
+				_dirtyRects.clear();
+				_dirtyRects.push_back(Common::Rect(_width, _height));
+
 				addTrack(new MveVideoTrack(this));
 
 				break;
@@ -530,6 +547,14 @@ bool MveDecoder::MveVideoTrack::hasDirtyPalette() const {
 	return _decoder->_dirtyPalette;
 }
 
+const Common::List<Common::Rect> *MveDecoder::MveVideoTrack::getDirtyRects() const {
+	return &_decoder->_dirtyRects;
+}
+
+void MveDecoder::MveVideoTrack::clearDirtyRects() {
+	_decoder->_dirtyRects.clear();
+}
+
 Common::Rational MveDecoder::MveVideoTrack::getFrameRate() const {
 	return _decoder->getFrameRate();
 }
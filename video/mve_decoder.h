@@ -25,6 +25,7 @@
 #include "audio/audiostream.h"
 #include "video/video_decoder.h"
 #include "graphics/surface.h"
+#include "common/bitarray.h"
 #include "common/list.h"
 #include "common/rect.h"
 #include "common/memstream.h"
@@ -77,6 +78,9 @@ class MveDecoder : public VideoDecoder {
 	uint16    _skipMapSize;
 	byte     *_skipMap;
 
+	Common::BitArray _dirtyBlocks;
+	Common::List<Common::Rect> _dirtyRects;
+
 	uint16    _decodingMapSize;
 	byte     *_decodingMap;
 
@@ -115,6 +119,9 @@ class MveDecoder : public VideoDecoder {
 		const byte *getPalette() const;
 		bool hasDirtyPalette() const;
 
+		const Common::List<Common::Rect> *getDirtyRects() const;
+		void clearDirtyRects();
+
 	protected:
 		Common::Rational getFrameRate() const;
 	};
@@ -159,10 +166,6 @@ public:
 	void setAudioTrack(int track);
 	void applyPalette(PaletteManager *paletteManager);
 
-	// const Common::List<Common::Rect> *getDirtyRects() const;
-	// void clearDirtyRects();
-	// void copyDirtyRectsToBuffer(uint8 *dst, uint pitch);
-
 	Common::Rational getFrameRate() { return _frameRate; }
 	void readNextPacket();
 };
@@ -138,22 +138,6 @@ int PacoDecoder::getAudioSamplingRate() {
 	return samplingRates[index];
 }
 
-const Common::List<Common::Rect> *PacoDecoder::getDirtyRects() const {
-	const Track *track = getTrack(0);
-
-	if (track)
-		return ((const PacoVideoTrack *)track)->getDirtyRects();
-
-	return 0;
-}
-
-void PacoDecoder::clearDirtyRects() {
-	Track *track = getTrack(0);
-
-	if (track)
-		((PacoVideoTrack *)track)->clearDirtyRects();
-}
-
 void PacoDecoder::copyDirtyRectsToBuffer(uint8 *dst, uint pitch) {
 	Track *track = getTrack(0);
 
@@ -32,6 +32,7 @@
 
 #include "audio/audiostream.h"
 
+#include "common/algorithm.h"
 #include "common/debug.h"
 #include "common/memstream.h"
 #include "common/system.h"
@@ -297,6 +298,7 @@ QuickTimeDecoder::VideoTrackHandler::VideoTrackHandler(QuickTimeDecoder *decoder
 		checkEditListBounds();
 	}
 
+	_dirtyRectCodec = 0;
 	_curEdit = 0;
 	_curFrame = -1;
 	_delayedFrameToBufferTo = -1;
@@ -465,7 +467,18 @@ bool QuickTimeDecoder::VideoTrackHandler::setOutputPixelFormat(const Graphics::P
 	if (_forcedDitherPalette)
 		return false;
 
-	return ((VideoSampleDesc *)_parent->sampleDescs[0])->_videoCodec->setOutputPixelFormat(format);
+	// Forward the format to every sample description, so that switching
+	// descriptions mid-stream keeps decoding straight into it
+	bool result = ((VideoSampleDesc *)_parent->sampleDescs[0])->_videoCodec->setOutputPixelFormat(format);
+
+	for (uint i = 1; i < _parent->sampleDescs.size(); i++) {
+		VideoSampleDesc *desc = (VideoSampleDesc *)_parent->sampleDescs[i];
+
+		if (desc->_videoCodec)
+			desc->_videoCodec->setOutputPixelFormat(format);
+	}
+
+	return result;
 }
 
 int QuickTimeDecoder::VideoTrackHandler::getFrameCount() const {
@@ -551,6 +564,12 @@ const Graphics::Surface *QuickTimeDecoder::VideoTrackHandler::decodeNextFrame()
 		}
 	}
 
+	// Dithered and scaled frames are regenerated as a whole
+	if (frame && (_forcedDitherPalette || _parent->scaleFactorX != 1 || _parent->scaleFactorY != 1)) {
+		_dirtyRects.clear();
+		_dirtyRects.push_back(Common::Rect(getWidth(), getHeight()));
+	}
+
 	// Handle forced dithering
 	if (frame && _forcedDitherPalette)
 		frame = forceDither(*frame);
@@ -669,60 +688,80 @@ Common::Rational QuickTimeDecoder::VideoTrackHandler::getScaledHeight() const {
 	return Common::Rational(_parent->height) / _parent->scaleFactorY;
 }
 
-Common::SeekableReadStream *QuickTimeDecoder::VideoTrackHandler::getNextFramePacket(uint32 &descId) {
-	// First, we have to track down which chunk holds the sample and which sample in the chunk contains the frame we are looking for.
-	int32 totalSampleCount = 0;
-	int32 sampleInChunk = 0;
-	int32 actualChunk = -1;
+void QuickTimeDecoder::VideoTrackHandler::buildSampleIndex() {
+	if (!_sampleIndex.empty())
+		return;
+
+	// Resolve the chunk and the offset within that chunk of every sample once,
+	// rather than walking the sample-to-chunk table on every frame.
+	_sampleIndex.reserve(_parent->frameCount);
+
 	uint32 sampleToChunkIndex = 0;
+	uint32 curSample = 0;
 
-	for (uint32 i = 0; i < _parent->chunkCount; i++) {
+	for (uint32 i = 0; i < _parent->chunkCount && curSample < _parent->frameCount; i++) {
 		if (sampleToChunkIndex < _parent->sampleToChunkCount && i >= _parent->sampleToChunk[sampleToChunkIndex].first)
 			sampleToChunkIndex++;
 
-		totalSampleCount += _parent->sampleToChunk[sampleToChunkIndex - 1].count;
+		if (sampleToChunkIndex == 0)
+			continue;
 
-		if (totalSampleCount > _curFrame) {
-			actualChunk = i;
-			descId = _parent->sampleToChunk[sampleToChunkIndex - 1].id;
-			sampleInChunk = _parent->sampleToChunk[sampleToChunkIndex - 1].count - totalSampleCount + _curFrame;
-			break;
+		const SampleToChunkEntry &chunkEntry = _parent->sampleToChunk[sampleToChunkIndex - 1];
+		uint32 offset = _parent->chunkOffsets[i];
+
+		for (uint32 j = 0; j < chunkEntry.count && curSample < _parent->frameCount; j++, curSample++) {
+			SampleIndexEntry entry;
+			entry.offset = offset;
+			entry.descId = chunkEntry.id;
+
+			if (_parent->sampleSize != 0)
+				entry.size = _parent->sampleSize;
+			else if (curSample < _parent->sampleCount)
+				entry.size = _parent->sampleSizes[curSample];
+			else
+				return;
+
+			_sampleIndex.push_back(entry);
+			offset += entry.size;
 		}
 	}
 
-	if (actualChunk < 0)
-		error("Could not find data for frame %d", _curFrame);
+	debug(3, "QuickTimeDecoder: Indexed %d samples", _sampleIndex.size());
+}
 
-	// Next seek to that frame
-	Common::SeekableReadStream *stream = _decoder->_fd;
-	stream->seek(_parent->chunkOffsets[actualChunk]);
+void QuickTimeDecoder::VideoTrackHandler::buildSampleDurations() {
+	if (!_sampleDurations.empty())
+		return;
 
-	// Then, if the chunk holds more than one frame, seek to where the frame we want is located
-	for (int32 i = _curFrame - sampleInChunk; i < _curFrame; i++) {
-		if (_parent->sampleSize != 0)
-			stream->skip(_parent->sampleSize);
-		else
-			stream->skip(_parent->sampleSizes[i]);
-	}
+	_sampleDurations.reserve(_parent->frameCount);
 
-	// Finally, read in the raw data for the frame
-	//debug("Frame Data[%d]: Offset = %d, Size = %d", _curFrame, stream->pos(), _parent->sampleSizes[_curFrame]);
+	for (int32 i = 0; i < _parent->timeToSampleCount; i++)
+		for (int j = 0; j < _parent->timeToSample[i].count; j++)
+			_sampleDurations.push_back(_parent->timeToSample[i].duration);
+}
+
+Common::SeekableReadStream *QuickTimeDecoder::VideoTrackHandler::getNextFramePacket(uint32 &descId) {
+	buildSampleIndex();
+
+	if (_curFrame < 0 || (uint32)_curFrame >= _sampleIndex.size())
+		error("Could not find data for frame %d", _curFrame);
 
-	if (_parent->sampleSize != 0)
-		return stream->readStream(_parent->sampleSize);
+	const SampleIndexEntry &entry = _sampleIndex[_curFrame];
+	descId = entry.descId;
 
-	return stream->readStream(_parent->sampleSizes[_curFrame]);
+	// Finally, read in the raw data for the frame
+	//debug("Frame Data[%d]: Offset = %d, Size = %d", _curFrame, entry.offset, entry.size);
+
+	Common::SeekableReadStream *stream = _decoder->_fd;
+	stream->seek(entry.offset);
+	return stream->readStream(entry.size);
 }
 
 uint32 QuickTimeDecoder::VideoTrackHandler::getCurFrameDuration() {
-	uint32 curFrameIndex = 0;
-	for (int32 i = 0; i < _parent->timeToSampleCount; i++) {
-		curFrameIndex += _parent->timeToSample[i].count;
-		if ((uint32)_curFrame < curFrameIndex) {
-			// Ok, now we have what duration this frame has.
-			return _parent->timeToSample[i].duration;
-		}
-	}
+	buildSampleDurations();
+
+	if (_curFrame >= 0 && (uint32)_curFrame < _sampleDurations.size())
+		return _sampleDurations[_curFrame];
 
 	// This should never occur
 	error("Cannot find duration for frame %d", _curFrame);
@@ -730,9 +769,14 @@ uint32 QuickTimeDecoder::VideoTrackHandler::getCurFrameDuration() {
 }
 
 uint32 QuickTimeDecoder::VideoTrackHandler::findKeyFrame(uint32 frame) const {
-	for (int i = _parent->keyframeCount - 1; i >= 0; i--)
-		if (_parent->keyframes[i] <= frame)
-			return _parent->keyframes[i];
+	// The sync sample table is sorted, so find the last keyframe not after
+	// the requested frame
+	const uint32 *keyframesBegin = _parent->keyframes;
+	const uint32 *keyframesEnd = keyframesBegin + _parent->keyframeCount;
+	const uint32 *it = Common::upperBound(keyframesBegin, keyframesEnd, frame);
+
+	if (it != keyframesBegin)
+		return *(it - 1);
 
 	// If none found, we'll assume the requested frame is a key frame
 	return frame;
@@ -837,6 +881,16 @@ const Graphics::Surface *QuickTimeDecoder::VideoTrackHandler::bufferNextFrame()
 	const Graphics::Surface *frame = entry->_videoCodec->decodeFrame(*frameData);
 	delete frameData;
 
+	// Only trust the codec's dirty rect if it also decoded the previous frame
+	Common::Rect dirtyRect;
+	if (frame) {
+		if (entry->_videoCodec != _dirtyRectCodec || !entry->_videoCodec->getDirtyRect(dirtyRect))
+			dirtyRect = Common::Rect(frame->w, frame->h);
+
+		addDirtyRect(dirtyRect);
+		_dirtyRectCodec = entry->_videoCodec;
+	}
+
 	// Update the palette
 	if (entry->_videoCodec->containsPalette()) {
 		// The codec itself contains a palette
@@ -857,6 +911,16 @@ const Graphics::Surface *QuickTimeDecoder::VideoTrackHandler::bufferNextFrame()
 	return frame;
 }
 
+void QuickTimeDecoder::VideoTrackHandler::addDirtyRect(const Common::Rect &rect) {
+	if (rect.isEmpty())
+		return;
+
+	if (_dirtyRects.empty())
+		_dirtyRects.push_back(rect);
+	else
+		_dirtyRects.front().extend(rect);
+}
+
 uint32 QuickTimeDecoder::VideoTrackHandler::getRateAdjustedFrameTime() const {
 	// Figure out what time the next frame is at taking the edit list rate into account,
 	// unless this is an empty edit, in which case the rate isn't applicable.
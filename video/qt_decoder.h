@@ -148,6 +148,8 @@ private:
 		bool isReversed() const { return _reversed; }
 		bool canDither() const;
 		void setDither(const byte *palette);
+		const Common::List<Common::Rect> *getDirtyRects() const { return &_dirtyRects; }
+		void clearDirtyRects() { _dirtyRects.clear(); }
 
 		Common::Rational getScaledWidth() const;
 		Common::Rational getScaledHeight() const;
@@ -171,6 +173,26 @@ private:
 		Graphics::Surface *_ditherFrame;
 		const Graphics::Surface *forceDither(const Graphics::Surface &frame);
 
+		// Area changed since the dirty rects were cleared, kept as a single
+		// rect since the codecs report one per frame
+		Common::List<Common::Rect> _dirtyRects;
+		Image::Codec *_dirtyRectCodec;
+		void addDirtyRect(const Common::Rect &rect);
+
+		// Sample index, built on first use so that seeking and sequential
+		// playback don't have to walk the chunk and time-to-sample tables
+		// for every frame
+		struct SampleIndexEntry {
+			uint32 offset;
+			uint32 size;
+			uint32 descId;
+		};
+
+		Common::Array<SampleIndexEntry> _sampleIndex;
+		Common::Array<uint32> _sampleDurations; // media time
+		void buildSampleIndex();
+		void buildSampleDurations();
+
 		Common::SeekableReadStream *getNextFramePacket(uint32 &descId);
 		uint32 getCurFrameDuration();            // media time
 		uint32 findKeyFrame(uint32 frame) const;
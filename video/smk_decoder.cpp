@@ -612,6 +612,7 @@ SmackerDecoder::SmackerVideoTrack::SmackerVideoTrack(uint32 width, uint32 height
 	_dirtyPalette = false;
 	_MMapTree = _MClrTree = _FullTree = _TypeTree = 0;
 	memset(_palette, 0, 3 * 256);
+	_dirtyRects.push_back(Common::Rect(getWidth(), getHeight()));
 }
 
 SmackerDecoder::SmackerVideoTrack::~SmackerVideoTrack() {
@@ -624,6 +625,13 @@ SmackerDecoder::SmackerVideoTrack::~SmackerVideoTrack() {
 	delete _TypeTree;
 }
 
+bool SmackerDecoder::SmackerVideoTrack::rewind() {
+	_curFrame = -1;
+	_dirtyRects.clear();
+	_dirtyRects.push_back(Common::Rect(getWidth(), getHeight()));
+	return true;
+}
+
 uint16 SmackerDecoder::SmackerVideoTrack::getWidth() const {
 	return _surface->w;
 }
@@ -790,6 +798,14 @@ void SmackerDecoder::SmackerVideoTrack::decodeFrame(SmackerBitStream &bs) {
 			break;
 		}
 	}
+
+	// Only report the changed blocks if the previous frame has been drawn
+	if (_dirtyRects.empty()) {
+		addDirtyBlocks(_dirtyRects, _dirtyBlocks, bw, bh, 4, 4 * doubleY);
+	} else {
+		_dirtyRects.clear();
+		_dirtyRects.push_back(Common::Rect(getWidth(), getHeight()));
+	}
 }
 
 void SmackerDecoder::SmackerVideoTrack::unpackPalette(Common::SeekableReadStream *stream) {
@@ -31,6 +31,7 @@
 
 #include "common/bitarray.h"
 #include "common/bitstream.h"
+#include "common/list.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "graphics/pixelformat.h"
@@ -102,7 +103,7 @@ protected:
 		~SmackerVideoTrack();
 
 		bool isRewindable() const { return true; }
-		bool rewind() { _curFrame = -1; return true; }
+		bool rewind();
 
 		uint16 getWidth() const;
 		uint16 getHeight() const;
@@ -121,6 +122,8 @@ protected:
 		Common::Rational getFrameRate() const { return _frameRate; }
 
 		const Common::Rect *getNextDirtyRect();
+		const Common::List<Common::Rect> *getDirtyRects() const { return &_dirtyRects; }
+		void clearDirtyRects() { _dirtyRects.clear(); }
 
 	protected:
 		Graphics::Surface *_surface;
@@ -142,6 +145,7 @@ protected:
 
 		Common::BitArray _dirtyBlocks;
 		Common::Rect _lastDirtyRect;
+		Common::List<Common::Rect> _dirtyRects;
 
 		// Possible runs of blocks
 		static uint getBlockRun(int index) { return (index <= 58) ? index + 1 : 128 << (index - 59); }
@@ -24,10 +24,14 @@
 #include "audio/audiostream.h"
 #include "audio/mixer.h" // for kMaxChannelVolume
 
+#include "common/bitarray.h"
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/profiler.h"
 #include "common/system.h"
 
+#include "graphics/surface.h"
+
 namespace Video {
 
 VideoDecoder::VideoDecoder() {
@@ -200,6 +204,8 @@ Graphics::PixelFormat VideoDecoder::getPixelFormat() const {
 }
 
 const Graphics::Surface *VideoDecoder::decodeNextFrame() {
+	PROFILE_ZONE("VideoDecoder::decodeNextFrame");
+
 	_needsUpdate = false;
 	_canSetDither = false;
 	_canSetDefaultFormat = false;
@@ -560,6 +566,43 @@ bool VideoDecoder::setOutputPixelFormat(const Graphics::PixelFormat &format) {
 	return result;
 }
 
+const Common::List<Common::Rect> *VideoDecoder::getDirtyRects() const {
+	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
+			return ((const VideoTrack *)*it)->getDirtyRects();
+
+	return 0;
+}
+
+void VideoDecoder::clearDirtyRects() {
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
+			((VideoTrack *)*it)->clearDirtyRects();
+}
+
+void VideoDecoder::copyDirtyRectsToBuffer(const Graphics::Surface &frame, byte *dst, uint pitch) {
+	const Common::List<Common::Rect> *dirtyRects = getDirtyRects();
+	const Common::Rect frameRect(frame.w, frame.h);
+	const uint bpp = frame.format.bytesPerPixel;
+
+	if (!dirtyRects) {
+		for (int y = 0; y < frame.h; y++)
+			memcpy(dst + y * pitch, frame.getBasePtr(0, y), frame.w * bpp);
+
+		return;
+	}
+
+	for (Common::List<Common::Rect>::const_iterator it = dirtyRects->begin(); it != dirtyRects->end(); ++it) {
+		Common::Rect rect = *it;
+		rect.clip(frameRect);
+
+		for (int y = rect.top; y < rect.bottom; y++)
+			memcpy(dst + y * pitch + rect.left * bpp, frame.getBasePtr(rect.left, y), rect.width() * bpp);
+	}
+
+	clearDirtyRects();
+}
+
 VideoDecoder::Track::Track() {
 	_paused = false;
 }
@@ -585,6 +628,49 @@ bool VideoDecoder::VideoTrack::endOfTrack() const {
 	return getCurFrame() >= (getFrameCount() - 1);
 }
 
+void VideoDecoder::VideoTrack::addDirtyBlocks(Common::List<Common::Rect> &rects, const Common::BitArray &dirtyBlocks, uint widthInBlocks, uint heightInBlocks, uint blockWidth, uint blockHeight) {
+	// Runs of dirty blocks in the previous row, which may still grow down
+	Common::Array<Common::Rect> openRects, nextOpenRects;
+
+	for (uint by = 0; by < heightInBlocks; by++) {
+		nextOpenRects.clear();
+
+		uint bx = 0;
+		while (bx < widthInBlocks) {
+			if (!dirtyBlocks.get(by * widthInBlocks + bx)) {
+				bx++;
+				continue;
+			}
+
+			uint runStart = bx;
+			while (bx < widthInBlocks && dirtyBlocks.get(by * widthInBlocks + bx))
+				bx++;
+
+			Common::Rect run(runStart * blockWidth, by * blockHeight, bx * blockWidth, (by + 1) * blockHeight);
+
+			// Extend the rect above if it covers exactly the same columns
+			for (uint i = 0; i < openRects.size(); i++) {
+				if (openRects[i].left == run.left && openRects[i].right == run.right) {
+					run.top = openRects[i].top;
+					openRects.remove_at(i);
+					break;
+				}
+			}
+
+			nextOpenRects.push_back(run);
+		}
+
+		// Whatever could not be extended is finished
+		for (uint i = 0; i < openRects.size(); i++)
+			rects.push_back(openRects[i]);
+
+		openRects.swap(nextOpenRects);
+	}
+
+	for (uint i = 0; i < openRects.size(); i++)
+		rects.push_back(openRects[i]);
+}
+
 Audio::Timestamp VideoDecoder::VideoTrack::getFrameTime(uint frame) const {
 	// Default implementation: Return an invalid (negative) number
 	return Audio::Timestamp().addFrames(-1);
@@ -25,8 +25,10 @@
 #include "audio/mixer.h"
 #include "audio/timestamp.h"	// TODO: Move this to common/ ?
 #include "common/array.h"
+#include "common/list.h"
 #include "common/path.h"
 #include "common/rational.h"
+#include "common/rect.h"
 #include "common/str.h"
 #include "graphics/pixelformat.h"
 
@@ -37,6 +39,7 @@ class SeekableAudioStream;
 }
 
 namespace Common {
+class BitArray;
 class SeekableReadStream;
 }
 
@@ -400,6 +403,37 @@ public:
 	 */
 	bool setOutputPixelFormat(const Graphics::PixelFormat &format);
 
+	/**
+	 * Get the areas of the video frame which changed since clearDirtyRects()
+	 * was last called.
+	 *
+	 * Delta based formats know which parts of a frame they have updated, so
+	 * only those need to be copied to the screen. Changes of all frames
+	 * decoded since the last clearDirtyRects() call are included, so callers
+	 * should clear the rects after drawing each frame; some tracks simply
+	 * report the whole frame when rects from an earlier frame are pending.
+	 *
+	 * @return The dirty rects of the first video track, or 0 if it does not
+	 *         report them, in which case the whole frame has changed.
+	 */
+	const Common::List<Common::Rect> *getDirtyRects() const;
+
+	/**
+	 * Forget the rects returned by getDirtyRects().
+	 */
+	void clearDirtyRects();
+
+	/**
+	 * Copy the areas of a frame which changed into a buffer of the same
+	 * pixel format, and clear the dirty rects afterwards. If the video does
+	 * not report dirty rects, the whole frame is copied.
+	 *
+	 * @param frame The frame returned by the last decodeNextFrame() call
+	 * @param dst   The buffer to copy to
+	 * @param pitch The pitch of the buffer, in bytes
+	 */
+	void copyDirtyRectsToBuffer(const Graphics::Surface &frame, byte *dst, uint pitch);
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -659,6 +693,34 @@ protected:
 		 * Activate dithering mode with a palette
 		 */
 		virtual void setDither(const byte *palette) {}
+
+		/**
+		 * Get the areas of the frame which changed since the dirty rects
+		 * were last cleared.
+		 *
+		 * @see VideoDecoder::getDirtyRects()
+		 * @return The dirty rects, or 0 if the track does not track them
+		 */
+		virtual const Common::List<Common::Rect> *getDirtyRects() const { return 0; }
+
+		/**
+		 * Forget the rects returned by getDirtyRects().
+		 */
+		virtual void clearDirtyRects() {}
+
+		/**
+		 * Add the changed blocks of a block based frame to a list of rects.
+		 * Adjacent blocks in a row are joined, as are identical runs in
+		 * consecutive rows.
+		 *
+		 * @param rects          The list to add the rects to
+		 * @param dirtyBlocks    One bit per block, row by row
+		 * @param widthInBlocks  The number of blocks in a row
+		 * @param heightInBlocks The number of block rows
+		 * @param blockWidth     The width of a block, in pixels
+		 * @param blockHeight    The height of a block, in pixels
+		 */
+		static void addDirtyBlocks(Common::List<Common::Rect> &rects, const Common::BitArray &dirtyBlocks, uint widthInBlocks, uint heightInBlocks, uint blockWidth, uint blockHeight);
 	};
 
 	/**